@@ -8,14 +8,21 @@ uniform sampler2D color_sampler;
 uniform bool horizontal;
 uniform float weight[5] = float[] (0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
 
+// Blurred part of the input, offset and size in uv. Samples are clamped
+// inside it, so neighbouring tiles of an atlas do not bleed in.
+uniform vec4 region = vec4(0.0, 0.0, 1.0, 1.0);
+
 void main()
 {
   vec2 tex_offset = 1.0 / textureSize(color_sampler, 0);
-  vec4 tex = texture(color_sampler, frag_uv);
+  vec2 uv = region.xy + frag_uv * region.zw;
+  vec2 low = region.xy + 0.5 * tex_offset;
+  vec2 high = region.xy + region.zw - 0.5 * tex_offset;
+  vec4 tex = texture(color_sampler, uv);
   vec4 result = tex * weight[0];
   for(int i = 1; i < 5; ++i) {
-    result += texture(color_sampler, frag_uv + vec2(horizontal ? tex_offset.x * i : 0, horizontal ? 0 : tex_offset.y * i)).rgba * weight[i];
-    result += texture(color_sampler, frag_uv - vec2(horizontal ? tex_offset.x * i : 0, horizontal ? 0 : tex_offset.y * i)).rgba * weight[i];
+    result += texture(color_sampler, clamp(uv + vec2(horizontal ? tex_offset.x * i : 0, horizontal ? 0 : tex_offset.y * i), low, high)).rgba * weight[i];
+    result += texture(color_sampler, clamp(uv - vec2(horizontal ? tex_offset.x * i : 0, horizontal ? 0 : tex_offset.y * i), low, high)).rgba * weight[i];
   }
   color = vec4(clamp(result, vec4(0.0), vec4(1.0)));
 }
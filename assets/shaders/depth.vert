@@ -1,12 +1,28 @@
 #version 430 core
 
-uniform mat4 model_view_projection;
+struct Instance {
+    mat4 model;
+    mat4 normal_matrix;
+    uint material;
+};
+
+layout(std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+uniform mat4 view_projection;
 layout(location = 0) in vec3 position;
 layout(location = 3) in vec2 uv;
+layout(location = 4) in uint instance_index;
 
 out vec2 fragment_uv;
+// Computed as in the standard shader, for equal depth testing after a
+// depth pre-pass.
+invariant gl_Position;
 
 void main() {
-    gl_Position = model_view_projection * vec4(position, 1.0);
+    mat4 model = instances[instance_index].model;
+    vec4 world_position = model * vec4(position, 1.0);
+    gl_Position = view_projection * world_position;
     fragment_uv = uv;
 }
@@ -3,33 +3,55 @@
 const float PI = 3.14159265359;
 
 struct Spot_light {
-    vec3 position;
-    vec3 color;
-    float strength;
     mat4 view;
     mat4 projection;
+    vec3 position;
+    float strength;
+    vec3 color;
     float angle;
     vec3 direction;
+    float blend;
 };
 
 struct Directional_light{
   vec3 position;
+  float strength;
   vec3 direction;
   vec3 color;
-  float strength;
 };
 
 struct Camera {
     vec3 position;
+    ivec2 resolution;
 };
 
 struct Environment {
     vec3 position;
-    vec3 extent;
     float strength;
+    vec3 extent;
     float falloff;
 };
 
+struct Fog {
+    vec3 color_near;
+    float attenuation_factor;
+    vec3 color_far;
+    float min;
+    float max;
+};
+
+layout(std140, binding = 1) uniform Scene {
+    Spot_light[4] spot_lights;
+    Directional_light directional_light;
+    Environment[2] environments;
+    Fog fog;
+    vec4 cascade_splits;
+};
+
+layout(std140, binding = 3) uniform View {
+    Camera camera;
+};
+
 in vec3 fragment_position;
 in vec3 fragment_color;
 in float fragment_alpha;
@@ -38,10 +60,6 @@ layout(location = 0) out vec4 color;
 
 uniform sampler2D texture_sampler;
 uniform bool emissive;
-uniform Spot_light[4] spot_lights;
-uniform Directional_light directional_light;
-uniform Camera camera;
-uniform Environment[2] environments;
 uniform samplerCube[2] environment_samplers;
 
 bool inside_box(const vec3 point, const vec3 position, const vec3 extent);
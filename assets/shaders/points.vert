@@ -2,7 +2,16 @@
 
 uniform mat4 model_view_projection;
 uniform mat4 model_view;
-uniform vec2 resolution;
+
+struct Camera {
+    vec3 position;
+    ivec2 resolution;
+};
+
+layout(std140, binding = 3) uniform View {
+    Camera camera;
+};
+
 uniform mat4 projection;
 
 layout(location = 0) in vec3 position;
@@ -17,7 +26,7 @@ out float fragment_alpha;
 void main() {
     vec4 eye_pos = model_view * vec4(position, 1.0);
     vec4 projVoxel = projection * vec4(size, size, eye_pos.z, eye_pos.w);
-    vec2 projSize = resolution * projVoxel.xy / projVoxel.w;
+    vec2 projSize = vec2(camera.resolution) * projVoxel.xy / projVoxel.w;
     gl_PointSize = 0.25 * (projSize.x+projSize.y);
 
     fragment_color = color;
@@ -4,13 +4,16 @@ const float PI = 3.14159265359;
 
 struct Material {
   vec3 albedo;
-  vec3 emission;
   float roughness;
+  vec3 emission;
   float metallic;
   float index_of_refraction;
-  float transmission;
   float alpha;
+  float transmission;
   float ambient_occlusion;
+};
+
+struct Material_samplers {
   sampler2D albedo_sampler;
   sampler2D emission_sampler;
   sampler2D normal_sampler;
@@ -21,20 +24,20 @@ struct Material {
 
 struct Directional_light{
   vec3 position;
+  float strength;
   vec3 direction;
   vec3 color;
-  float strength;
 };
 
 struct Spot_light {
-  vec3 position;
-  vec3 color;
-  float strength;
   mat4 view;
   mat4 projection;
+  vec3 position;
+  float strength;
+  vec3 color;
   float angle;
-  float blend;
   vec3 direction;
+  float blend;
 };
 
 struct Camera {
@@ -46,15 +49,15 @@ struct Camera {
 
 struct Environment {
   vec3 position;
-  vec3 extent;
   float strength;
+  vec3 extent;
   float falloff;
 };
 
 struct Fog {
   vec3 color_near;
-  vec3 color_far;
   float attenuation_factor;
+  vec3 color_far;
   float min;
   float max;
 };
@@ -73,22 +76,40 @@ uniform mat4 model;
 uniform mat4 model_view;
 uniform mat4 view; // TODO: Move to camera
 
-uniform Camera camera;
-uniform Fog fog;
-uniform Material material;
-uniform Spot_light[4] spot_lights;
-uniform Directional_light directional_light;
+layout(std140, binding = 1) uniform Scene {
+  Spot_light[4] spot_lights;
+  Directional_light directional_light;
+  Environment[2] environments;
+  Fog fog;
+  vec4 cascade_splits;
+};
+
+layout(std140, binding = 3) uniform View {
+  Camera camera;
+};
 
-uniform sampler2D[4] shadow_samplers;
+layout(std430, binding = 1) readonly buffer Materials {
+  Material materials[];
+};
+
+uniform Material_samplers material_samplers;
+
+// Material of the fragment, read from the buffer at the start of main.
+Material material;
+
+// Spot light shadow maps, one tile each, placed by the shadow matrices.
+uniform sampler2D shadow_atlas_sampler;
 uniform sampler2D[4] cascaded_shadow_samplers;
-uniform vec4 cascade_splits;
 
-uniform Environment[2] environments;
 uniform samplerCube[2] environment_samplers;
 
 uniform sampler2D brdf_lut_sampler;
 
+// Add a constant per shaded fragment instead, to show overdraw.
+uniform bool overdraw;
+
 in Fragment fragment;
+flat in uint material_index;
 
 layout(location = 0) out vec4 out_color;
 
@@ -132,7 +153,7 @@ float sample_replace(const in float value, const in sampler2D sampler,
 float fog_attenuation(const float dist, const float factor);
 
 vec3 shade_spotlights(const in Spot_light[4] lights, const in vec4[4] shadow_projs,
-                  const in sampler2D[4] shadow_samplers, const in vec3 position,
+                  const in sampler2D shadow_atlas, const in vec3 position,
                   const in vec3 normal, const in vec3 view_vector,
                   const in float normal_dot_view_vector, const in vec3 albedo,
                   const in float metallic, const in float roughness,
@@ -148,8 +169,8 @@ vec3 shade_spotlights(const in Spot_light[4] lights, const in vec4[4] shadow_pro
         const float normal_dot_light_vector = max(dot(normal, light_vector), 0.0);
 
         const vec3 shadow_map_uv = shadow_projs[i].xyz / shadow_projs[i].w;
-        const vec2 texel_size = 1.0 / textureSize(shadow_samplers[i], 0);
-        const float shadow = sample_variance_shadow_map(shadow_samplers[i], shadow_map_uv.xy + texel_size, shadow_map_uv.z);
+        const vec2 texel_size = 1.0 / textureSize(shadow_atlas, 0);
+        const float shadow = sample_variance_shadow_map(shadow_atlas, shadow_map_uv.xy + texel_size, shadow_map_uv.z);
 
         const float light_fragment_distance = distance(light.position, position);
         const float attenuation = 1.0 / (light_fragment_distance * light_fragment_distance);
@@ -240,18 +261,14 @@ vec3 shade_indirect(const in Environment[2] environments, const in samplerCube[2
       const vec2 environment_texture_size = textureSize(environment_samplers[i], 0);
       const float maxsize = max(environment_texture_size.x, environment_texture_size.x);
       const float num_levels = textureQueryLevels(environment_samplers[i]);
-      const float mip_level = clamp(pow(roughness, 0.25) * num_levels, 0.0, 10.0);
+      // Levels are GGX prefiltered, of roughness increasing to one.
+      const float mip_level = roughness * (num_levels - 1.0);
 
       const vec3 F_env = fresnel_schlick_roughness(NdotV, F0, roughness);
       const vec3 kS_env = F_env;
       const vec3 kD_env = (1.0 - kS_env) * (1.0 - metallic);
 
-      vec3 filtered = vec3(0,0,0);
-      if (roughness > 0.4) {
-        filtered = sample_environment(environment_samplers[i], corrected_R, mip_level, 0.5 * roughness, 1.0 * roughness);
-      } else {
-        filtered = textureLod(environment_samplers[i], corrected_R, mip_level).rgb;
-      }
+      const vec3 filtered = textureLod(environment_samplers[i], corrected_R, mip_level).rgb;
 
       const vec2 brdf  = texture(brdf_lut_sampler, vec2(NdotV, roughness)).rg;
 
@@ -294,13 +311,18 @@ vec3 calculate_fog(const in Fog fog, const in vec3 color,
 }
 
 void main() {
-  const vec3 normal = sample_normal(fragment.normal, material.normal_sampler, fragment.tbn, fragment.uv);
+  if (overdraw) {
+    out_color = vec4(0.1, 0.05, 0.025, 1.0);
+    return;
+  }
+  material = materials[material_index];
+  const vec3 normal = sample_normal(fragment.normal, material_samplers.normal_sampler, fragment.tbn, fragment.uv);
 
-  const vec4 albedo_alpha = sample_albedo_alpha(material.albedo, material.alpha, material.albedo_sampler, fragment.uv);
-  const vec3 emission = sample_replace(material.emission, material.emission_sampler, fragment.uv);
-  const float metallic = sample_replace(material.metallic, material.metallic_sampler, fragment.uv);
-  const float roughness = sample_replace(material.roughness, material.roughness_sampler, fragment.uv);
-  const float ambient_occlusion = sample_replace(material.ambient_occlusion, material.ambient_occlusion_sampler, fragment.uv);
+  const vec4 albedo_alpha = sample_albedo_alpha(material.albedo, material.alpha, material_samplers.albedo_sampler, fragment.uv);
+  const vec3 emission = sample_replace(material.emission, material_samplers.emission_sampler, fragment.uv);
+  const float metallic = sample_replace(material.metallic, material_samplers.metallic_sampler, fragment.uv);
+  const float roughness = sample_replace(material.roughness, material_samplers.roughness_sampler, fragment.uv);
+  const float ambient_occlusion = sample_replace(material.ambient_occlusion, material_samplers.ambient_occlusion_sampler, fragment.uv);
 
   const vec3 view_vector = normalize(camera.position - fragment.position);
   const vec3 reflect_vector = -reflect(fragment.camera_to_surface, normal);
@@ -309,7 +331,7 @@ void main() {
 
   const vec3 F0 = mix(vec3(0.02), albedo_alpha.rgb, metallic);
 
-  vec3 direct = shade_spotlights(spot_lights, fragment.proj_shadow, shadow_samplers,
+  vec3 direct = shade_spotlights(spot_lights, fragment.proj_shadow, shadow_atlas_sampler,
                                  fragment.position, normal, view_vector,
                                  normal_dot_view_vector, albedo_alpha.rgb, metallic,
                                  roughness, material.transmission, F0);
@@ -323,5 +345,8 @@ void main() {
                                 material.transmission, ambient_occlusion, F0);
 
   out_color.rgb = calculate_fog(fog, direct + ambient + emission, fragment.position, camera.position);
-  out_color.a = clamp(albedo_alpha.a, 0.0, 1.0);
+  // Opaque materials are drawn unsorted, and with the depth pre-pass, so
+  // texels that pass the alpha test are fully opaque, as in depth.frag.
+  const bool opaque = material.alpha >= 1.0 && material.transmission <= 0.0;
+  out_color.a = opaque ? 1.0 : clamp(albedo_alpha.a, 0.0, 1.0);
 }
@@ -15,37 +15,60 @@ struct Camera {
     ivec2 resolution;
 };
 
-uniform Camera camera;
+layout(std140, binding = 2) uniform Shadows {
+    mat4[4] depth_bias_view_projections;
+    mat4[4] cascaded_depth_bias_view_projections;
+};
 
-uniform mat4[4] depth_bias_model_view_projections;
-uniform mat4[4] cascaded_depth_bias_model_view_projections;
+layout(std140, binding = 3) uniform View {
+    Camera camera;
+};
 
-uniform mat4 model;
-uniform mat4 model_view_projection;
-uniform mat3 normal_matrix;
+struct Instance {
+    mat4 model;
+    mat4 normal_matrix;
+    uint material;
+};
+
+layout(std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+uniform mat4 view_projection;
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 normal;
 layout(location = 2) in vec3 tangent;
 layout(location = 3) in vec2 uv;
+// Base instance of the draw command plus gl_InstanceID.
+layout(location = 4) in uint instance_index;
 
 out Fragment fragment;
+flat out uint material_index;
+// Same depth as the depth pre-pass, for equal depth testing.
+invariant gl_Position;
 
 void main() {
+    Instance instance = instances[instance_index];
+    material_index = instance.material;
+    mat4 model = instance.model;
+    mat3 normal_matrix = mat3(instance.normal_matrix);
+    vec4 world_position = model * vec4(position, 1.0);
+
     vec3 T = normalize(vec3(model * vec4(tangent, 0.0)));
     vec3 N = normalize(normal_matrix * normal);
     T = normalize(T - dot(T, N) * N);
     vec3 B = cross(N, T);
     fragment.tbn = mat3(T,B,N);
 
-    for (int i = 0; i < depth_bias_model_view_projections.length(); i++){
-        fragment.proj_shadow[i] = depth_bias_model_view_projections[i] * vec4(position, 1.0);
-        fragment.cascaded_proj_shadow[i] = cascaded_depth_bias_model_view_projections[i] * vec4(position, 1.0);
+    for (int i = 0; i < depth_bias_view_projections.length(); i++){
+        fragment.proj_shadow[i] = depth_bias_view_projections[i] * world_position;
+        fragment.cascaded_proj_shadow[i] = cascaded_depth_bias_view_projections[i] * world_position;
     }
 
     fragment.uv = uv;
-    fragment.position = (model * vec4(position, 1.0)).xyz;
+    fragment.position = world_position.xyz;
     fragment.normal = normalize(normal_matrix * normal);
     fragment.camera_to_surface = normalize(camera.position - fragment.position);
-    gl_Position = model_view_projection * vec4(position, 1.0);
+    gl_Position = view_projection * world_position;
 }
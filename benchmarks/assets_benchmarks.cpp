@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mos/core/assets_cache.hpp>
+#include <mos/gfx/assets.hpp>
+#include "generators.hpp"
+
+TEST_CASE("Level loading", "[Assets]") {
+  static constexpr int num_meshes = 250;
+  static constexpr int num_textures = 250;
+
+  const auto directory =
+      std::filesystem::temp_directory_path() / "mos_benchmark_level";
+  std::filesystem::create_directories(directory);
+
+  std::vector<std::string> mesh_paths;
+  std::vector<std::string> texture_paths;
+  const auto mesh = generators::grid(64);
+  for (int i = 0; i < num_meshes; i++) {
+    mesh_paths.push_back("mesh" + std::to_string(i) + ".mesh");
+    generators::write_mesh((directory / mesh_paths.back()).string(), mesh);
+  }
+  for (int i = 0; i < num_textures; i++) {
+    texture_paths.push_back("texture" + std::to_string(i) + ".tga");
+    generators::write_tga((directory / texture_paths.back()).string(), 256,
+                          256, i);
+  }
+  const auto assets_directory = directory.string() + "/";
+
+  BENCHMARK("Serial") {
+    mos::gfx::Assets assets(assets_directory);
+    for (const auto &path : mesh_paths) {
+      assets.mesh(path);
+    }
+    for (const auto &path : texture_paths) {
+      assets.texture(path);
+    }
+    return assets.pending();
+  };
+
+  BENCHMARK("Parallel") {
+    mos::gfx::Assets assets(assets_directory);
+    for (const auto &path : mesh_paths) {
+      assets.mesh_async(path);
+    }
+    for (const auto &path : texture_paths) {
+      assets.texture_async(path);
+    }
+    size_t loaded = 0;
+    while (assets.pending() > 0) {
+      const auto committed = assets.commit();
+      loaded += committed.meshes.size() + committed.textures.size();
+      std::this_thread::yield();
+    }
+    return loaded;
+  };
+
+  std::filesystem::remove_all(directory);
+  std::filesystem::remove_all(directory.string() + ".cache");
+}
+
+TEST_CASE("Texture cache", "[Assets]") {
+  static constexpr int num_textures = 32;
+
+  const auto directory =
+      std::filesystem::temp_directory_path() / "mos_benchmark_textures";
+  std::filesystem::create_directories(directory);
+  const mos::Assets_cache cache(directory.string() + ".cache");
+
+  std::vector<std::string> texture_paths;
+  for (int i = 0; i < num_textures; i++) {
+    texture_paths.push_back("texture" + std::to_string(i) + ".tga");
+    generators::write_tga((directory / texture_paths.back()).string(), 1024,
+                          1024, i);
+  }
+  const auto assets_directory = directory.string() + "/";
+
+  auto load = [&]() {
+    mos::gfx::Assets assets(assets_directory);
+    int levels = 0;
+    for (const auto &path : texture_paths) {
+      levels += assets.texture(path)->levels();
+    }
+    return levels;
+  };
+
+  BENCHMARK("Cold start") {
+    cache.clear();
+    return load();
+  };
+
+  load();
+
+  BENCHMARK("Warm start") { return load(); };
+
+  std::filesystem::remove_all(directory);
+  cache.clear();
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include <mos/gfx/bvh.hpp>
+#include <mos/util.hpp>
+
+TEST_CASE("Bounding volume hierarchy", "[Bvh]") {
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+  std::uniform_real_distribution<float> radius(0.5f, 4.0f);
+  std::vector<mos::gfx::Bvh::Sphere> spheres(100000);
+  for (auto &sphere : spheres) {
+    sphere = {{position(generator), position(generator), position(generator)},
+              radius(generator)};
+  }
+
+  std::vector<mos::gfx::Camera> cameras;
+  for (int i = 0; i < 11; i++) {
+    const auto angle = float(i) * glm::two_pi<float>() / 11.0f;
+    cameras.emplace_back(
+        glm::vec3(0.0f), glm::vec3(glm::cos(angle), glm::sin(angle), 0.0f),
+        glm::perspective(glm::half_pi<float>(), 1.0f, 0.1f, 200.0f));
+  }
+
+  const glm::uvec2 resolution(1920, 1080);
+  std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+  std::vector<mos::sim::Ray> rays;
+  for (int i = 0; i < 1000; i++) {
+    rays.push_back(mos::un_project(
+        glm::vec2(pixel(generator) * resolution.x,
+                  pixel(generator) * resolution.y),
+        cameras[0].view(), cameras[0].projection(), resolution));
+  }
+
+  mos::gfx::Bvh bvh;
+  BENCHMARK("Build") {
+    bvh.build(spheres);
+    return bvh.size();
+  };
+
+  auto moved = spheres;
+  for (auto &sphere : moved) {
+    sphere.center.z += 1.0f;
+  }
+  BENCHMARK("Refit") {
+    bvh.refit(moved);
+    return bvh.size();
+  };
+
+  std::vector<mos::gfx::Bvh::Index> indices;
+  BENCHMARK("Frustum, linear") {
+    indices.clear();
+    for (const auto &camera : cameras) {
+      for (std::size_t i = 0; i < moved.size(); i++) {
+        if (camera.in_frustum(moved[i].center, moved[i].radius)) {
+          indices.push_back(mos::gfx::Bvh::Index(i));
+        }
+      }
+    }
+    return indices.size();
+  };
+
+  BENCHMARK("Frustum, hierarchy") {
+    indices.clear();
+    for (const auto &camera : cameras) {
+      bvh.query(camera.frustum_planes(), indices);
+    }
+    return indices.size();
+  };
+
+  BENCHMARK("Rays, linear") {
+    std::size_t hits = 0;
+    for (const auto &ray : rays) {
+      float closest = std::numeric_limits<float>::max();
+      for (const auto &sphere : moved) {
+        const auto to_center = sphere.center - ray.origin;
+        const auto along = glm::dot(to_center, ray.direction());
+        const auto squared = sphere.radius * sphere.radius -
+                             (glm::dot(to_center, to_center) - along * along);
+        if (squared >= 0.0f && along >= 0.0f) {
+          closest = std::min(closest, along - std::sqrt(squared));
+        }
+      }
+      hits += closest < std::numeric_limits<float>::max();
+    }
+    return hits;
+  };
+
+  BENCHMARK("Rays, hierarchy") {
+    std::size_t hits = 0;
+    for (const auto &ray : rays) {
+      hits += bvh.intersect(ray).has_value();
+    }
+    return hits;
+  };
+}
@@ -0,0 +1,56 @@
+#include <catch2/catch.hpp>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include <mos/gfx/culling.hpp>
+#include <mos/gl/command_recorder.hpp>
+
+TEST_CASE("Command recorder", "[Command_recorder]") {
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+  mos::gfx::Scene_graph graph;
+  std::vector<mos::gl::Drawable> drawables;
+  for (int i = 0; i < 50000; i++) {
+    graph.add(mos::gfx::Scene_graph::none,
+              glm::translate(glm::mat4(1.0f),
+                             glm::vec3(position(generator),
+                                       position(generator),
+                                       position(generator))),
+              {glm::vec3(0.0f), 1.0f});
+    drawables.push_back(mos::gl::Drawable{
+        1u + unsigned(i % 64), 100, {1u + unsigned(i % 16), 2, 3, 4, 5, 6},
+        {glm::vec3(float(i % 8) / 8.0f), glm::vec3(0.0f)}});
+  }
+  graph.update();
+
+  // Main camera, four spot lights, four cascades and two cube faces.
+  mos::gfx::Culling culling;
+  for (const auto &sphere : graph.spheres()) {
+    culling.add(sphere.center, sphere.radius);
+  }
+  std::vector<mos::gl::Command_recorder::Pass> passes;
+  std::vector<mos::gfx::Camera> cameras;
+  for (int i = 0; i < 11; i++) {
+    const auto angle = float(i) * glm::two_pi<float>() / 11.0f;
+    cameras.emplace_back(
+        glm::vec3(0.0f), glm::vec3(glm::cos(angle), glm::sin(angle), 0.0f),
+        glm::perspective(glm::half_pi<float>(), 1.0f, 0.1f, 200.0f));
+    culling.add(cameras.back());
+  }
+  culling.cull();
+  for (mos::gfx::Culling::Index view = 0; view < cameras.size(); view++) {
+    passes.push_back({1, view > 0 && view < 9, cameras[view].position(), 0,
+                      drawables.size(), culling.visibility(view)});
+  }
+
+  mos::gl::Command_recorder recorder;
+  BENCHMARK("Record, sequential") {
+    recorder.record(passes, drawables, graph);
+    return recorder.list(0).size();
+  };
+
+  mos::Thread_pool pool;
+  BENCHMARK("Record, parallel") {
+    recorder.record(passes, drawables, graph, &pool);
+    return recorder.list(0).size();
+  };
+}
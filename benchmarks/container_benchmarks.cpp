@@ -0,0 +1,47 @@
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <vector>
+#include <mos/core/tracked_container.hpp>
+
+namespace {
+
+/** The previous tracking scheme, a clock read on every mutable access. */
+template <class T> class Timestamped_container {
+public:
+  explicit Timestamped_container(const std::size_t size) : items_(size) {}
+  auto operator[](const std::size_t pos) -> T & {
+    modified_ = std::chrono::system_clock::now();
+    return items_[pos];
+  }
+  auto size() const -> std::size_t { return items_.size(); }
+  auto modified() const { return modified_; }
+
+private:
+  std::vector<T> items_;
+  std::chrono::system_clock::time_point modified_;
+};
+
+} // namespace
+
+TEST_CASE("Per element writes", "[Tracked_container]") {
+  static constexpr std::size_t size = 1000000;
+
+  Timestamped_container<float> timestamped(size);
+  std::vector<float> items(size);
+  mos::Tracked_container<float> tracked(items.begin(), items.end());
+
+  BENCHMARK("Time stamp") {
+    for (std::size_t i = 0; i < timestamped.size(); i++) {
+      timestamped[i] = float(i);
+    }
+    return timestamped.modified();
+  };
+
+  BENCHMARK("Generation") {
+    tracked.mark_clean();
+    for (std::size_t i = 0; i < tracked.size(); i++) {
+      tracked[i] = float(i);
+    }
+    return tracked.modified();
+  };
+}
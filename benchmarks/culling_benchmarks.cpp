@@ -0,0 +1,47 @@
+#include <catch2/catch.hpp>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include <mos/gfx/culling.hpp>
+
+TEST_CASE("Culling", "[Culling]") {
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> radius(0.1f, 2.0f);
+  std::vector<std::pair<glm::vec3, float>> spheres(100000);
+  for (auto &sphere : spheres) {
+    sphere = {{position(generator), position(generator), position(generator)},
+              radius(generator)};
+  }
+
+  // Main camera, four spot lights, four cascades and two cube faces.
+  std::vector<mos::gfx::Camera> cameras;
+  for (int i = 0; i < 11; i++) {
+    const auto angle = float(i) * glm::two_pi<float>() / 11.0f;
+    cameras.emplace_back(
+        glm::vec3(0.0f), glm::vec3(glm::cos(angle), glm::sin(angle), 0.0f),
+        glm::perspective(glm::half_pi<float>(), 1.0f, 0.1f, 100.0f));
+  }
+
+  BENCHMARK("In frustum, per sphere and view") {
+    std::size_t visible = 0;
+    for (const auto &camera : cameras) {
+      for (const auto &[center, r] : spheres) {
+        visible += camera.in_frustum(center, r);
+      }
+    }
+    return visible;
+  };
+
+  mos::gfx::Culling culling;
+  BENCHMARK("Culling, fill and cull") {
+    culling.clear();
+    for (const auto &[center, r] : spheres) {
+      culling.add(center, r);
+    }
+    for (const auto &camera : cameras) {
+      culling.add(camera);
+    }
+    culling.cull();
+    return culling.visibility(0)[0];
+  };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <mos/gfx/mesh.hpp>
+
+/** Synthetic data for the benchmarks. */
+namespace generators {
+
+/** Flat grid with size * size vertices. */
+inline auto grid(const int size) -> mos::gfx::Mesh {
+  std::vector<mos::gfx::Vertex> vertices;
+  std::vector<mos::gfx::Triangle_indices> indices;
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      vertices.push_back(mos::gfx::Vertex{
+          glm::vec3(float(x), float(y), 0.0F), glm::vec3(0.0F, 0.0F, 1.0F),
+          glm::vec3(0.0F), glm::vec2(float(x), float(y)) / float(size)});
+    }
+  }
+  for (int y = 0; y < size - 1; y++) {
+    for (int x = 0; x < size - 1; x++) {
+      const int i = y * size + x;
+      indices.push_back({i, i + 1, i + size});
+      indices.push_back({i + 1, i + size + 1, i + size});
+    }
+  }
+  return mos::gfx::Mesh(vertices.begin(), vertices.end(), indices.begin(),
+                        indices.end());
+}
+
+/** Write a mesh in the original *.mesh layout. */
+inline auto write_mesh(const std::string &path, const mos::gfx::Mesh &mesh)
+    -> void {
+  std::ofstream os(path, std::ios::binary);
+  const int num_vertices = static_cast<int>(mesh.vertices.size());
+  const int num_indices = static_cast<int>(mesh.indices.size() * 3);
+  os.write(reinterpret_cast<const char *>(&num_vertices), sizeof(int));
+  os.write(reinterpret_cast<const char *>(&num_indices), sizeof(int));
+  os.write(reinterpret_cast<const char *>(mesh.vertices.data()),
+           std::streamsize(num_vertices * sizeof(mos::gfx::Vertex)));
+  os.write(reinterpret_cast<const char *>(mesh.indices.data()),
+           std::streamsize(num_indices * sizeof(int)));
+}
+
+/** Write an uncompressed 32 bit *.tga image with a gradient pattern. */
+inline auto write_tga(const std::string &path, const int width,
+                      const int height, const int seed = 0) -> void {
+  std::array<std::uint8_t, 18> header{};
+  header[2] = 2;
+  header[12] = static_cast<std::uint8_t>(width & 0xFF);
+  header[13] = static_cast<std::uint8_t>((width >> 8) & 0xFF);
+  header[14] = static_cast<std::uint8_t>(height & 0xFF);
+  header[15] = static_cast<std::uint8_t>((height >> 8) & 0xFF);
+  header[16] = 32;
+  header[17] = 0x28;
+  std::vector<std::uint8_t> pixels;
+  pixels.reserve(width * height * 4);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      pixels.push_back(static_cast<std::uint8_t>(x + seed));
+      pixels.push_back(static_cast<std::uint8_t>(y + seed));
+      pixels.push_back(static_cast<std::uint8_t>((x ^ y) + seed));
+      pixels.push_back(255);
+    }
+  }
+  std::ofstream os(path, std::ios::binary);
+  os.write(reinterpret_cast<const char *>(header.data()), header.size());
+  os.write(reinterpret_cast<const char *>(pixels.data()),
+           std::streamsize(pixels.size()));
+}
+
+} // namespace generators
@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+#include <map>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtx/normal.hpp>
+#include <mos/gfx/mesh.hpp>
+#include <mos/gfx/mesh_kernels.hpp>
+#include "generators.hpp"
+
+namespace {
+
+using namespace mos::gfx;
+
+/** Smooth normals as computed before the kernels, grouping triangles per
+ * vertex in a map. */
+auto map_normals(Mesh &mesh) -> void {
+  std::map<int, std::vector<glm::vec3>> normals;
+  for (const auto &t : mesh.indices) {
+    const auto normal = glm::triangleNormal(mesh.vertices[t[0]].position,
+                                            mesh.vertices[t[1]].position,
+                                            mesh.vertices[t[2]].position);
+    for (const auto i : t) {
+      normals[i].push_back(normal);
+    }
+  }
+  for (const auto &[i, face_normals] : normals) {
+    auto normal = glm::vec3(0.0F);
+    for (const auto &face_normal : face_normals) {
+      normal += face_normal;
+    }
+    mesh.vertices[i].normal = glm::normalize(normal);
+  }
+}
+
+auto span(Mesh &mesh) -> std::span<Vertex> {
+  return {mesh.vertices.begin(), mesh.vertices.end()};
+}
+
+auto const_span(const Mesh &mesh) -> std::span<const Vertex> {
+  return {mesh.vertices.data(), mesh.vertices.size()};
+}
+
+} // namespace
+
+TEST_CASE("Mesh kernels", "[Mesh]") {
+  using kernels::Execution;
+
+  auto mesh = generators::grid(1000);
+  const auto other = generators::grid(1000);
+  const auto transform = glm::mat4(glm::vec4(0.0F, 1.0F, 0.0F, 0.0F),
+                                   glm::vec4(-1.0F, 0.0F, 0.0F, 0.0F),
+                                   glm::vec4(0.0F, 0.0F, 1.0F, 0.0F),
+                                   glm::vec4(1.0F, 2.0F, 3.0F, 1.0F));
+
+  BENCHMARK("Transform, per vertex") {
+    for (auto &vertex : mesh.vertices) {
+      vertex.apply_transform(transform);
+    }
+  };
+
+  BENCHMARK("Transform, sequential") {
+    kernels::transform(span(mesh), transform, Execution::Sequential);
+  };
+
+  BENCHMARK("Transform, parallel") {
+    kernels::transform(span(mesh), transform, Execution::Parallel);
+  };
+
+  BENCHMARK("Mix, sequential") {
+    kernels::mix(span(mesh), const_span(mesh), const_span(other), 0.5F,
+                 Execution::Sequential);
+  };
+
+  BENCHMARK("Mix, parallel") {
+    kernels::mix(span(mesh), const_span(mesh), const_span(other), 0.5F,
+                 Execution::Parallel);
+  };
+
+  BENCHMARK("Bounding sphere, sequential") {
+    return kernels::bounding_sphere(const_span(mesh), Execution::Sequential);
+  };
+
+  BENCHMARK("Bounding sphere, parallel") {
+    return kernels::bounding_sphere(const_span(mesh), Execution::Parallel);
+  };
+
+  BENCHMARK("Smooth normals") { mesh.calculate_normals(); };
+
+  BENCHMARK("Tangents") { mesh.calculate_tangents(); };
+
+  auto small_mesh = generators::grid(256);
+
+  BENCHMARK("Smooth normals, 64K vertices, map") { map_normals(small_mesh); };
+
+  BENCHMARK("Smooth normals, 64K vertices") { small_mesh.calculate_normals(); };
+}
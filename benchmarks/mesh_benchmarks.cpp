@@ -0,0 +1,26 @@
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <mos/gfx/mesh.hpp>
+#include <mos/gfx/mesh_file.hpp>
+#include "generators.hpp"
+
+TEST_CASE("Mesh loading", "[Mesh]") {
+  const auto directory = std::filesystem::temp_directory_path();
+  const auto mesh_path = (directory / "mos_benchmark.mesh").string();
+  const auto mesh2_path = (directory / "mos_benchmark.mesh2").string();
+
+  const auto mesh = generators::grid(512);
+  generators::write_mesh(mesh_path, mesh);
+  mos::gfx::Mesh_file::write(mesh2_path, mos::gfx::Mesh::load(mesh_path));
+
+  BENCHMARK("Load *.mesh") { return mos::gfx::Mesh::load(mesh_path); };
+
+  BENCHMARK("Load *.mesh2") { return mos::gfx::Mesh::load(mesh2_path); };
+
+  BENCHMARK("Map *.mesh2") {
+    return mos::gfx::Mesh_file(mesh2_path).vertices().size();
+  };
+
+  std::filesystem::remove(mesh_path);
+  std::filesystem::remove(mesh2_path);
+}
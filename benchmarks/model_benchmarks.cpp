@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <json.hpp>
+#include <mos/gfx/assets.hpp>
+#include <mos/gfx/model.hpp>
+#include <mos/util.hpp>
+
+namespace {
+
+using json = nlohmann::json;
+
+constexpr int num_materials = 8;
+constexpr int depth = 6;
+constexpr int branching = 4;
+constexpr int models_per_level = 4;
+
+auto model_name(const int level, const int index) -> std::string {
+  return "level" + std::to_string(level) + "_" + std::to_string(index) +
+         ".model";
+}
+
+auto write(const std::filesystem::path &path, const json &value) -> void {
+  std::ofstream(path) << value.dump();
+}
+
+/** Models at each level reference children from a small pool at the next
+ * level, so a hierarchy of branching^depth models uses few files. */
+auto write_level(const std::filesystem::path &directory) -> void {
+  for (int i = 0; i < num_materials; i++) {
+    const json slot = {{"value", {0.5, 0.5, 0.5}}, {"texture", nullptr}};
+    write(directory / ("material" + std::to_string(i) + ".material"),
+          {{"albedo", slot},
+           {"normal", {{"texture", nullptr}}},
+           {"emission", slot},
+           {"metallic", {{"value", 0.0}, {"texture", nullptr}}},
+           {"roughness", {{"value", 0.5}, {"texture", nullptr}}},
+           {"ambient_occlusion", {{"value", 1.0}, {"texture", nullptr}}},
+           {"index_of_refraction", 1.5},
+           {"transmission", 0.0},
+           {"alpha", 1.0}});
+  }
+  for (int level = 0; level < depth; level++) {
+    for (int i = 0; i < models_per_level; i++) {
+      json children = json::array();
+      if (level + 1 < depth) {
+        for (int c = 0; c < branching; c++) {
+          children.push_back(model_name(level + 1, (i + c) % models_per_level));
+        }
+      }
+      write(directory / model_name(level, i),
+            {{"name", model_name(level, i)},
+             {"mesh", nullptr},
+             {"material", "material" + std::to_string(i % num_materials) + ".material"},
+             {"transform", {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, level, i, 0, 1}},
+             {"children", children}});
+    }
+  }
+
+  // One large level file, with many children and data the loader ignores.
+  json children = json::array();
+  for (int i = 0; i < 4096; i++) {
+    children.push_back(model_name(depth - 1, i % models_per_level));
+  }
+  std::vector<float> extras(1 << 18, 1.0f);
+  write(directory / "large.model", {{"name", "large"},
+                                    {"mesh", nullptr},
+                                    {"material", nullptr},
+                                    {"extras", extras},
+                                    {"children", children}});
+}
+
+/** Parses every reference, as models were loaded without a document cache. */
+auto parse_uncached(const std::string &directory, const std::string &path)
+    -> int {
+  auto value = json::parse(mos::text(directory + path));
+  int count = 1;
+  if (!value["material"].is_null()) {
+    const std::string material = value["material"];
+    json::parse(mos::text(directory + material));
+  }
+  for (const auto &child : value["children"]) {
+    count += parse_uncached(directory, child);
+  }
+  return count;
+}
+
+auto count(const mos::gfx::Model &model) -> int {
+  int result = 1;
+  for (const auto &child : model.models) {
+    result += count(child);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("Model hierarchy loading", "[Model]") {
+  using mos::gfx::Assets;
+
+  const auto directory =
+      std::filesystem::temp_directory_path() / "mos_benchmark_models";
+  std::filesystem::create_directories(directory);
+  write_level(directory);
+  const auto assets_directory = directory.string() + "/";
+  const auto root = model_name(0, 0);
+
+  BENCHMARK("Uncached parsing") {
+    return parse_uncached(assets_directory, root);
+  };
+
+  BENCHMARK("Document cache") {
+    Assets assets(assets_directory);
+    return count(assets.model(root));
+  };
+
+  BENCHMARK("SAX") {
+    Assets assets(assets_directory, Assets::Parser::Sax);
+    return count(assets.model(root));
+  };
+
+  BENCHMARK("Large file, document") {
+    Assets assets(assets_directory);
+    return count(assets.model("large.model"));
+  };
+
+  BENCHMARK("Large file, SAX") {
+    Assets assets(assets_directory, Assets::Parser::Sax);
+    return count(assets.model("large.model"));
+  };
+
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <mos/core/slot_map.hpp>
+
+namespace {
+
+/** Stands in for a GL object wrapper, a name plus some bookkeeping. */
+struct Resource {
+  std::uint32_t id;
+  std::uint64_t generation;
+  std::int64_t size;
+};
+
+/** Ids a draw looks up, a vertex array and six material textures. */
+struct Draw {
+  unsigned int mesh;
+  std::array<unsigned int, 6> textures;
+};
+
+constexpr unsigned int num_meshes = 2000;
+constexpr unsigned int num_textures = 4000;
+constexpr int num_draws = 10000;
+
+auto draws() -> std::vector<Draw> {
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<unsigned int> mesh(1, num_meshes);
+  std::uniform_int_distribution<unsigned int> texture(1, num_textures);
+  std::vector<Draw> result(num_draws);
+  for (auto &draw : result) {
+    draw.mesh = mesh(generator);
+    for (auto &t : draw.textures) {
+      t = texture(generator);
+    }
+  }
+  return result;
+}
+
+template <class Table> auto fill(Table &table, const unsigned int count) {
+  for (unsigned int id = 1; id <= count; id++) {
+    table.insert({id, Resource{id, 0, 0}});
+  }
+}
+
+template <class T> auto fill(mos::Slot_map<T> &table, const unsigned int count) {
+  for (unsigned int id = 1; id <= count; id++) {
+    table.insert(id, Resource{id, 0, 0});
+  }
+}
+
+/** The lookups render_model does per draw, without any GL calls. */
+template <class Table>
+auto render(const std::vector<Draw> &draws, const Table &vertex_arrays,
+            const Table &textures) -> std::uint64_t {
+  std::uint64_t bound = 0;
+  for (const auto &draw : draws) {
+    bound += vertex_arrays.at(draw.mesh).id;
+    for (const auto texture : draw.textures) {
+      bound += textures.at(texture).id;
+    }
+  }
+  return bound;
+}
+
+} // namespace
+
+TEST_CASE("Resource table lookups", "[Slot_map]") {
+  const auto scene = draws();
+
+  std::unordered_map<unsigned int, Resource> map_vertex_arrays;
+  std::unordered_map<unsigned int, Resource> map_textures;
+  fill(map_vertex_arrays, num_meshes);
+  fill(map_textures, num_textures);
+
+  mos::Slot_map<Resource> slot_vertex_arrays;
+  mos::Slot_map<Resource> slot_textures;
+  fill(slot_vertex_arrays, num_meshes);
+  fill(slot_textures, num_textures);
+
+  BENCHMARK("10k draws, unordered_map") {
+    return render(scene, map_vertex_arrays, map_textures);
+  };
+
+  BENCHMARK("10k draws, slot map") {
+    return render(scene, slot_vertex_arrays, slot_textures);
+  };
+
+  BENCHMARK("Iterate textures, unordered_map") {
+    std::int64_t size = 0;
+    for (const auto &[id, texture] : map_textures) {
+      size += texture.size + texture.id;
+    }
+    return size;
+  };
+
+  BENCHMARK("Iterate textures, slot map") {
+    std::int64_t size = 0;
+    for (const auto &texture : slot_textures) {
+      size += texture.size + texture.id;
+    }
+    return size;
+  };
+}
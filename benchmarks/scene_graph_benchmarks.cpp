@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <mos/gfx/scene_graph.hpp>
+
+namespace {
+
+/** Nested models as they were flattened before the scene graph. */
+struct Nested {
+  glm::mat4 transform{1.0f};
+  std::vector<Nested> children;
+};
+
+/** World and normal matrices of a hierarchy, computed recursively. */
+auto visit(const Nested &model, const glm::mat4 &parent, std::size_t &count)
+    -> float {
+  const auto world = parent * model.transform;
+  const auto normal = glm::inverseTranspose(glm::mat3(world));
+  float sum = world[3].x + normal[0].x;
+  count++;
+  for (const auto &child : model.children) {
+    sum += visit(child, world, count);
+  }
+  return sum;
+}
+
+} // namespace
+
+TEST_CASE("Scene graph", "[Scene_graph]") {
+  // 100 chains, each 1000 models deep.
+  constexpr int chains = 100;
+  constexpr int depth = 1000;
+  const auto step = glm::rotate(
+      glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.1f)), 0.01f,
+      glm::vec3(0.0f, 1.0f, 0.0f));
+
+  std::vector<Nested> nested(chains);
+  for (auto &root : nested) {
+    auto *model = &root;
+    for (int i = 1; i < depth; i++) {
+      model->transform = step;
+      model->children.resize(1);
+      model = &model->children.front();
+    }
+    model->transform = step;
+  }
+
+  mos::gfx::Scene_graph graph;
+  std::vector<mos::gfx::Scene_graph::Index> roots;
+  for (int chain = 0; chain < chains; chain++) {
+    auto parent = mos::gfx::Scene_graph::none;
+    for (int i = 0; i < depth; i++) {
+      parent = graph.add(parent, step, {glm::vec3(0.0f), 1.0f});
+      if (i == 0) {
+        roots.push_back(parent);
+      }
+    }
+  }
+  graph.update();
+
+  // Six passes: main camera, four spot lights and a cascade.
+  BENCHMARK("Recursive, six passes") {
+    std::size_t count = 0;
+    float sum = 0.0f;
+    for (int pass = 0; pass < 6; pass++) {
+      for (const auto &root : nested) {
+        sum += visit(root, glm::mat4(1.0f), count);
+      }
+    }
+    return sum;
+  };
+
+  BENCHMARK("Graph, unchanged") {
+    graph.update();
+    return graph.stats().updated;
+  };
+
+  BENCHMARK("Graph, one chain moved") {
+    graph.local(roots.front(), glm::mat4(1.0f));
+    graph.update();
+    graph.local(roots.front(), step);
+    return graph.stats().updated;
+  };
+
+  BENCHMARK("Graph, all moved, sequential") {
+    for (const auto root : roots) {
+      graph.local(root, glm::mat4(1.0f));
+    }
+    graph.update(mos::gfx::kernels::Execution::Sequential);
+    for (const auto root : roots) {
+      graph.local(root, step);
+    }
+    return graph.stats().updated;
+  };
+
+  BENCHMARK("Graph, all moved, parallel") {
+    for (const auto root : roots) {
+      graph.local(root, glm::mat4(1.0f));
+    }
+    graph.update(mos::gfx::kernels::Execution::Parallel);
+    for (const auto root : roots) {
+      graph.local(root, step);
+    }
+    return graph.stats().updated;
+  };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace mos {
+
+/** On-disk cache for data derived from asset files, keyed by a hash of the
+ * source file content. Safe to use from several threads. */
+class Assets_cache final {
+public:
+  /** @param directory Where cached files are stored, created on demand. */
+  explicit Assets_cache(std::filesystem::path directory);
+
+  /** FNV-1a hash of the file content. */
+  static auto hash(const std::filesystem::path &path) -> std::uint64_t;
+
+  /** Where data derived from source is cached, the file may not exist.
+   * @param variant Distinguishes data derived in different ways, ends with
+   * the file extension. */
+  auto path(const std::filesystem::path &source,
+            const std::string &variant) const -> std::filesystem::path;
+
+  /** Call write with a temporary path and move the result to path, so readers
+   * never see partial files. Returns false if writing failed. */
+  auto store(const std::filesystem::path &path,
+             const std::function<void(const std::filesystem::path &)> &write)
+      const -> bool;
+
+  /** Remove all cached files. */
+  auto clear() const -> void;
+
+  auto directory() const -> std::filesystem::path;
+
+private:
+  std::filesystem::path directory_;
+};
+} // namespace mos
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace mos {
+
+/** Slot index and generation, the generation changes each time a slot is
+ * reused. */
+struct Handle {
+  static constexpr std::uint32_t invalid_index =
+      std::numeric_limits<std::uint32_t>::max();
+
+  std::uint32_t index{invalid_index};
+  std::uint32_t generation{0};
+
+  auto valid() const -> bool { return index != invalid_index; }
+  auto operator==(const Handle &handle) const -> bool = default;
+};
+
+/** Reference counted handles with recycled slots. Lock free, handles may be
+ * created, retained and released from any thread. Slots live in fixed size
+ * blocks that are never moved or freed, so indices stay dense. */
+class Handle_allocator final {
+public:
+  static constexpr std::uint32_t block_size = 1 << 12;
+  static constexpr std::uint32_t max_blocks = 1 << 12;
+
+  Handle_allocator();
+  ~Handle_allocator();
+
+  Handle_allocator(const Handle_allocator &allocator) = delete;
+  Handle_allocator(Handle_allocator &&allocator) = delete;
+  Handle_allocator &operator=(const Handle_allocator &allocator) = delete;
+  Handle_allocator &operator=(Handle_allocator &&allocator) = delete;
+
+  /** New handle with one reference, reusing a released slot if there is one. */
+  auto create() -> Handle;
+
+  /** Add a reference to a live handle. */
+  auto retain(const Handle &handle) -> void;
+
+  /** Remove a reference, the slot is recycled when the last one is released.
+   * @return True if the slot was recycled. */
+  auto release(const Handle &handle) -> bool;
+
+  /** True if the handle has not been recycled. */
+  auto alive(const Handle &handle) const -> bool;
+
+  /** Number of live handles. */
+  auto size() const -> std::uint32_t;
+
+  /** Number of slots ever created, live handles have smaller indices. */
+  auto capacity() const -> std::uint32_t;
+
+private:
+  struct Slot {
+    std::atomic<std::uint32_t> generation{0};
+    std::atomic<std::uint32_t> references{0};
+    std::atomic<std::uint32_t> next{Handle::invalid_index};
+  };
+
+  auto slot(std::uint32_t index) const -> Slot &;
+
+  /** Head of the free list, index in the low bits and a tag against ABA. */
+  std::atomic<std::uint64_t> free_;
+  std::atomic<std::uint32_t> capacity_{0};
+  std::atomic<std::uint32_t> size_{0};
+  std::array<std::atomic<Slot *>, max_blocks> blocks_{};
+};
+
+} // namespace mos
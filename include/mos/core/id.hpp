@@ -1,20 +1,40 @@
 #pragma once
 
-#include <atomic>
+#include <cstdint>
+#include <mos/core/handle_allocator.hpp>
 
 namespace mos {
 
+/** Identifier shared by copies, with one allocator per type. Released ids are
+ * reused, so ids stay small and dense, and the generation tells reuses apart. */
 template<class T>
 class Id {
 public:
-  Id() : id(++current_id){}
-  operator int&() { return id; }
-  operator int() const { return id; }
+  Id() : handle_(allocator().create()) {}
+  Id(const Id &id) : handle_(id.handle_) { allocator().retain(handle_); }
+  Id &operator=(const Id &id) {
+    if (handle_ != id.handle_) {
+      allocator().retain(id.handle_);
+      allocator().release(handle_);
+      handle_ = id.handle_;
+    }
+    return *this;
+  }
+  ~Id() { allocator().release(handle_); }
+
+  /** Index plus one, zero is never used. */
+  operator int() const { return int(handle_.index) + 1; }
+
+  auto generation() const -> std::uint32_t { return handle_.generation; }
+
+  auto handle() const -> Handle { return handle_; }
+
 private:
-  int id;
-  static std::atomic<int> current_id;
+  static auto allocator() -> Handle_allocator & {
+    static Handle_allocator allocator;
+    return allocator;
+  }
+  Handle handle_;
 };
 
-template<class T> std::atomic<int> Id<T>::current_id = 0;
-
 }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace mos {
+
+/** Read only, memory mapped file. */
+class Mapped_file final {
+public:
+  explicit Mapped_file(const std::filesystem::path &path);
+  ~Mapped_file();
+
+  Mapped_file(const Mapped_file &file) = delete;
+  Mapped_file(Mapped_file &&file) noexcept;
+  Mapped_file &operator=(const Mapped_file &file) = delete;
+  Mapped_file &operator=(Mapped_file &&file) noexcept;
+
+  /** First byte of the mapping. */
+  auto data() const -> const std::byte *;
+
+  /** Size of the mapping in bytes. */
+  auto size() const -> std::size_t;
+
+private:
+  void release();
+  const std::byte *data_{nullptr};
+  std::size_t size_{0};
+#ifdef _WIN32
+  void *file_{nullptr};
+  void *mapping_{nullptr};
+#endif
+};
+} // namespace mos
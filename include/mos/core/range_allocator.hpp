@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+
+namespace mos {
+
+/** First fit allocator of ranges in a linear space, such as the elements of
+ * a buffer. Free ranges are kept ordered by offset and merged with their
+ * neighbours when freed, so free space is only split between live ranges. */
+class Range_allocator final {
+public:
+  using Offset = std::uint32_t;
+
+  /** A live range, as returned by allocate. */
+  struct Range {
+    Offset offset{0};
+    Offset size{0};
+  };
+
+  struct Stats {
+    Offset capacity{0};
+    Offset used{0};
+    /** Live ranges. */
+    int ranges{0};
+    int free_ranges{0};
+    Offset largest_free{0};
+    /** Share of free space outside the largest free range, from zero when
+     * all free space is contiguous towards one. */
+    auto fragmentation() const -> float;
+  };
+
+  explicit Range_allocator(Offset capacity = 0);
+
+  /** Allocate size contiguous elements, at the lowest offset that fits.
+   * Empty ranges take no space.
+   * @return Offset of the range, or nothing if no free range is that large. */
+  auto allocate(Offset size) -> std::optional<Offset>;
+
+  /** Free a range returned by allocate. */
+  auto free(Offset offset, Offset size) -> void;
+
+  /** Extend the space to capacity elements, adding the new ones as free. */
+  auto grow(Offset capacity) -> void;
+
+  /** Free all ranges. */
+  auto clear() -> void;
+
+  /** Pack the live ranges to the start of the space, in order of offset,
+   * and resize the space to capacity, at least the used size. Ranges are
+   * updated to their new offsets, where the caller moves their contents.
+   * @param ranges Every live range. */
+  auto compact(std::span<Range> ranges, Offset capacity) -> void;
+
+  /** If more than a quarter of the space is free, and compacting to at
+   * least minimum would shrink it. */
+  auto shrinkable(Offset minimum) const -> bool;
+
+  auto capacity() const -> Offset;
+
+  auto stats() const -> Stats;
+
+private:
+  /** Size of each free range, by offset. */
+  std::map<Offset, Offset> free_;
+  Offset capacity_{0};
+  Offset used_{0};
+  int ranges_{0};
+};
+
+} // namespace mos
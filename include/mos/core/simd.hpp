@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace mos::simd {
+
+/** Four floats, operated on with SSE2 where available and scalar code
+ * otherwise. */
+class Float4 final {
+public:
+  Float4() = default;
+
+  /** Broadcast a value to all lanes. */
+  explicit Float4(const float value) {
+#ifdef MOS_SIMD_SSE2
+    value_ = _mm_set1_ps(value);
+#else
+    value_ = {value, value, value, value};
+#endif
+  }
+
+  Float4(const float x, const float y, const float z, const float w) {
+#ifdef MOS_SIMD_SSE2
+    value_ = _mm_setr_ps(x, y, z, w);
+#else
+    value_ = {x, y, z, w};
+#endif
+  }
+
+  /** Load four floats, no alignment required. */
+  static auto load(const float *data) -> Float4 {
+    Float4 result;
+#ifdef MOS_SIMD_SSE2
+    result.value_ = _mm_loadu_ps(data);
+#else
+    result.value_ = {data[0], data[1], data[2], data[3]};
+#endif
+    return result;
+  }
+
+  /** Store all four lanes, no alignment required. */
+  auto store(float *data) const -> void {
+#ifdef MOS_SIMD_SSE2
+    _mm_storeu_ps(data, value_);
+#else
+    for (int i = 0; i < 4; i++) {
+      data[i] = value_[i];
+    }
+#endif
+  }
+
+  /** Store the first three lanes, leaving data[3] untouched. */
+  auto store3(float *data) const -> void {
+#ifdef MOS_SIMD_SSE2
+    _mm_storel_pi(reinterpret_cast<__m64 *>(data), value_);
+    _mm_store_ss(data + 2, _mm_movehl_ps(value_, value_));
+#else
+    for (int i = 0; i < 3; i++) {
+      data[i] = value_[i];
+    }
+#endif
+  }
+
+  /** Value of one lane. */
+  auto operator[](const int lane) const -> float {
+#ifdef MOS_SIMD_SSE2
+    alignas(16) std::array<float, 4> lanes{};
+    _mm_store_ps(lanes.data(), value_);
+    return lanes[lane];
+#else
+    return value_[lane];
+#endif
+  }
+
+  friend auto operator+(const Float4 &a, const Float4 &b) -> Float4 {
+#ifdef MOS_SIMD_SSE2
+    return Float4(_mm_add_ps(a.value_, b.value_));
+#else
+    return apply(a, b, [](float x, float y) { return x + y; });
+#endif
+  }
+
+  friend auto operator-(const Float4 &a, const Float4 &b) -> Float4 {
+#ifdef MOS_SIMD_SSE2
+    return Float4(_mm_sub_ps(a.value_, b.value_));
+#else
+    return apply(a, b, [](float x, float y) { return x - y; });
+#endif
+  }
+
+  friend auto operator*(const Float4 &a, const Float4 &b) -> Float4 {
+#ifdef MOS_SIMD_SSE2
+    return Float4(_mm_mul_ps(a.value_, b.value_));
+#else
+    return apply(a, b, [](float x, float y) { return x * y; });
+#endif
+  }
+
+  friend auto operator/(const Float4 &a, const Float4 &b) -> Float4 {
+#ifdef MOS_SIMD_SSE2
+    return Float4(_mm_div_ps(a.value_, b.value_));
+#else
+    return apply(a, b, [](float x, float y) { return x / y; });
+#endif
+  }
+
+  friend auto min(const Float4 &a, const Float4 &b) -> Float4 {
+#ifdef MOS_SIMD_SSE2
+    return Float4(_mm_min_ps(a.value_, b.value_));
+#else
+    return apply(a, b, [](float x, float y) { return y < x ? y : x; });
+#endif
+  }
+
+  friend auto max(const Float4 &a, const Float4 &b) -> Float4 {
+#ifdef MOS_SIMD_SSE2
+    return Float4(_mm_max_ps(a.value_, b.value_));
+#else
+    return apply(a, b, [](float x, float y) { return x < y ? y : x; });
+#endif
+  }
+
+  friend auto sqrt(const Float4 &a) -> Float4 {
+#ifdef MOS_SIMD_SSE2
+    return Float4(_mm_sqrt_ps(a.value_));
+#else
+    return apply(a, a, [](float x, float) { return std::sqrt(x); });
+#endif
+  }
+
+  /** Bit i is set if lane i of a is less than or equal to lane i of b. */
+  friend auto less_equal(const Float4 &a, const Float4 &b) -> int {
+#ifdef MOS_SIMD_SSE2
+    return _mm_movemask_ps(_mm_cmple_ps(a.value_, b.value_));
+#else
+    int mask = 0;
+    for (int i = 0; i < 4; i++) {
+      mask |= (a.value_[i] <= b.value_[i] ? 1 : 0) << i;
+    }
+    return mask;
+#endif
+  }
+
+  /** Transpose four rows, lane j of row i becomes lane i of row j. Turns the
+   * xyz of four vectors into x, y and z of four vectors, and back. */
+  friend auto transpose(Float4 &r0, Float4 &r1, Float4 &r2, Float4 &r3)
+      -> void {
+#ifdef MOS_SIMD_SSE2
+    _MM_TRANSPOSE4_PS(r0.value_, r1.value_, r2.value_, r3.value_);
+#else
+    const std::array<Float4 *, 4> rows{&r0, &r1, &r2, &r3};
+    for (int i = 0; i < 4; i++) {
+      for (int j = i + 1; j < 4; j++) {
+        std::swap(rows[i]->value_[j], rows[j]->value_[i]);
+      }
+    }
+#endif
+  }
+
+private:
+#ifdef MOS_SIMD_SSE2
+  explicit Float4(const __m128 value) : value_(value) {}
+  __m128 value_;
+#else
+  template <class F>
+  static auto apply(const Float4 &a, const Float4 &b, F f) -> Float4 {
+    Float4 result;
+    for (int i = 0; i < 4; i++) {
+      result.value_[i] = f(a.value_[i], b.value_[i]);
+    }
+    return result;
+  }
+  std::array<float, 4> value_;
+#endif
+};
+
+} // namespace mos::simd
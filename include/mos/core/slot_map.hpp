@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mos {
+
+/** Values keyed by small, dense ids such as mos::Id. Values are stored
+ * contiguously, a lookup is one index into an array of positions, and erase
+ * moves the last value into the hole. */
+template <class T> class Slot_map {
+public:
+  using Key = unsigned int;
+  using Values = std::vector<T>;
+  using iterator = typename Values::iterator;
+  using const_iterator = typename Values::const_iterator;
+
+  auto contains(const Key key) const -> bool {
+    return key < positions_.size() && positions_[key] != absent;
+  }
+
+  /** Value with the key, or nullptr. */
+  auto find(const Key key) -> T * {
+    return contains(key) ? &values_[positions_[key]] : nullptr;
+  }
+
+  auto find(const Key key) const -> const T * {
+    return contains(key) ? &values_[positions_[key]] : nullptr;
+  }
+
+  auto at(const Key key) -> T & {
+    if (!contains(key)) {
+      throw std::out_of_range("Key not in slot map.");
+    }
+    return values_[positions_[key]];
+  }
+
+  auto at(const Key key) const -> const T & {
+    if (!contains(key)) {
+      throw std::out_of_range("Key not in slot map.");
+    }
+    return values_[positions_[key]];
+  }
+
+  /** Construct a value if the key is not present.
+   * @return Value with the key. */
+  template <class... Args> auto emplace(const Key key, Args &&...args) -> T & {
+    if (key >= positions_.size()) {
+      positions_.resize(key + 1, absent);
+    }
+    if (positions_[key] == absent) {
+      values_.emplace_back(std::forward<Args>(args)...);
+      keys_.push_back(key);
+      positions_[key] = std::uint32_t(values_.size() - 1);
+    }
+    return values_[positions_[key]];
+  }
+
+  /** Insert the value if the key is not present.
+   * @return Value with the key. */
+  auto insert(const Key key, T &&value) -> T & {
+    return emplace(key, std::move(value));
+  }
+
+  /** @return True if the key was present. */
+  auto erase(const Key key) -> bool {
+    if (!contains(key)) {
+      return false;
+    }
+    const auto position = positions_[key];
+    if (position + 1 != values_.size()) {
+      values_[position] = std::move(values_.back());
+      keys_[position] = keys_.back();
+      positions_[keys_[position]] = position;
+    }
+    values_.pop_back();
+    keys_.pop_back();
+    positions_[key] = absent;
+    return true;
+  }
+
+  auto clear() -> void {
+    values_.clear();
+    keys_.clear();
+    positions_.clear();
+  }
+
+  auto size() const -> std::size_t { return values_.size(); }
+  auto empty() const -> bool { return values_.empty(); }
+
+  /** Keys in the same order as the values. */
+  auto keys() const -> const std::vector<Key> & { return keys_; }
+
+  auto begin() -> iterator { return values_.begin(); }
+  auto end() -> iterator { return values_.end(); }
+  auto begin() const -> const_iterator { return values_.begin(); }
+  auto end() const -> const_iterator { return values_.end(); }
+
+private:
+  static constexpr std::uint32_t absent =
+      std::numeric_limits<std::uint32_t>::max();
+
+  std::vector<std::uint32_t> positions_;
+  std::vector<Key> keys_;
+  Values values_;
+};
+
+} // namespace mos
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mos {
+
+/** Fixed number of worker threads, consuming a shared task queue. */
+class Thread_pool final {
+public:
+  /** @param count Number of worker threads, defaults to one per core. */
+  explicit Thread_pool(unsigned int count = std::thread::hardware_concurrency());
+  ~Thread_pool();
+
+  Thread_pool(const Thread_pool &pool) = delete;
+  Thread_pool(Thread_pool &&pool) = delete;
+  Thread_pool &operator=(const Thread_pool &pool) = delete;
+  Thread_pool &operator=(Thread_pool &&pool) = delete;
+
+  /** Process wide pool with one worker per core. Shared by the renderer, the
+   * kernels, the scene graph and asset loading, so they do not oversubscribe
+   * the cores with a pool each. */
+  static auto shared() -> Thread_pool &;
+
+  /** Queue a callable, the result or exception is delivered by the future. */
+  template <class F>
+  auto enqueue(F &&f) -> std::future<std::invoke_result_t<F>> {
+    using Result = std::invoke_result_t<F>;
+    auto task =
+        std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+    auto future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace([task]() { (*task)(); });
+    }
+    condition_.notify_one();
+    return future;
+  }
+
+  /** Number of chunks parallel_for splits count items into. */
+  auto chunks(const std::size_t count) const -> std::size_t {
+    return std::max<std::size_t>(std::min(count, size()), 1);
+  }
+
+  /** Call f(chunk, begin, end) for contiguous ranges covering [0, count) on
+   * the workers and wait for all of them. Called from a task running on the
+   * same pool, f(0, 0, count) is called on that worker instead, as waiting
+   * for the other workers could deadlock. */
+  template <class F> auto parallel_for(const std::size_t count, F &&f) -> void {
+    if (worker()) {
+      f(std::size_t(0), std::size_t(0), count);
+      return;
+    }
+    const auto num_chunks = chunks(count);
+    const auto chunk_size = (count + num_chunks - 1) / num_chunks;
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_chunks);
+    for (std::size_t chunk = 0; chunk < num_chunks; chunk++) {
+      const auto begin = std::min(chunk * chunk_size, count);
+      const auto end = std::min(begin + chunk_size, count);
+      futures.push_back(enqueue([&f, chunk, begin, end]() { f(chunk, begin, end); }));
+    }
+    for (auto &future : futures) {
+      future.get();
+    }
+  }
+
+  /** Number of worker threads. */
+  auto size() const -> std::size_t;
+
+  /** If the calling thread is one of the workers. */
+  auto worker() const -> bool;
+
+private:
+  auto work() -> void;
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stopping_{false};
+};
+} // namespace mos
@@ -1,6 +1,9 @@
 #pragma once
-#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <initializer_list>
+#include <limits>
 #include <mos/core/container.hpp>
 #include <vector>
 
@@ -8,21 +11,29 @@ namespace mos {
 
 template <class T> class Container;
 
-/** Container with modified time stamp. */
+/** Container with modification tracking. Mutable access changes the
+ * generation, and grows the dirty range, until the next mark_clean. */
 template <class T> class Tracked_container {
 public:
   using Items = std::vector<T>;
-  using TimePoint = std::chrono::time_point<std::chrono::system_clock,
-                                            std::chrono::nanoseconds>;
   using size_type = typename Items::size_type;
+  using Generation = std::uint64_t;
 
-  Tracked_container() { invalidate(); }
+  /** Index range [begin, end) of modified items. */
+  struct Range {
+    size_type begin{std::numeric_limits<size_type>::max()};
+    size_type end{0};
+    auto empty() const -> bool { return begin >= end; }
+  };
+
+  Tracked_container() : generation_(next_generation()) {}
 
   template <class It>
   explicit Tracked_container(const std::initializer_list<It> list)
       : Tracked_container(list.begin(), list.end()) {}
 
-  template <class It> Tracked_container(It begin, It end) {
+  template <class It>
+  Tracked_container(It begin, It end) : generation_(next_generation()) {
     assign(begin, end);
   }
 
@@ -31,20 +42,20 @@ public:
 
   template <class It> void assign(It begin, It end) {
     items_.assign(begin, end);
-    invalidate();
+    invalidate(0, items_.size());
   }
   typename Items::iterator begin() {
-    invalidate();
+    invalidate(0, items_.size());
     return items_.begin();
   }
   typename Items::iterator end() {
-    invalidate();
+    invalidate(0, items_.size());
     return items_.end();
   }
   typename Items::const_iterator begin() const { return items_.begin(); }
   typename Items::const_iterator end() const { return items_.end(); }
   typename Items::reference operator[](typename Items::size_type pos) {
-    invalidate();
+    invalidate(pos, pos + 1);
     return items_[pos];
   }
   typename Items::const_reference
@@ -53,24 +64,52 @@ public:
   }
   typename Items::size_type size() const { return items_.size(); }
   typename Items::reference back() {
-    invalidate();
+    invalidate(items_.size() - 1, items_.size());
     return items_.back();
   }
   const T *data() const noexcept { return items_.data(); }
   void clear() {
     items_.clear();
-    invalidate();
+    invalidate(0, 0);
   }
   void push_back(const T &item) {
     items_.push_back(item);
-    invalidate();
+    invalidate(items_.size() - 1, items_.size());
   }
 
-  TimePoint modified() const { return modified_; }
+  /** Generation of the content, unique among containers of the same type. */
+  Generation modified() const { return generation_; }
+
+  /** Generation the dirty range is relative to, zero if never clean. */
+  Generation clean_generation() const { return clean_generation_; }
+
+  /** Items modified since clean_generation(). */
+  Range dirty() const { return dirty_; }
+
+  /** Mark the current content as synchronized, for example after an upload. */
+  void mark_clean() const {
+    clean_generation_ = generation_;
+    dirty_ = Range{};
+  }
 
 private:
-  void invalidate() { modified_ = std::chrono::system_clock::now(); }
+  static auto next_generation() -> Generation {
+    static std::atomic<Generation> current_generation{0};
+    return ++current_generation;
+  }
+
+  void invalidate(const size_type begin, const size_type end) {
+    // Only the first modification after mark_clean needs a new generation.
+    if (generation_ == clean_generation_) {
+      generation_ = next_generation();
+    }
+    dirty_.begin = std::min(dirty_.begin, begin);
+    dirty_.end = std::max(dirty_.end, end);
+  }
+
   Items items_;
-  TimePoint modified_;
+  Generation generation_{0};
+  mutable Generation clean_generation_{0};
+  mutable Range dirty_{};
 };
 } // namespace mos
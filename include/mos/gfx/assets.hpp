@@ -1,11 +1,15 @@
 #pragma once
 
+#include <future>
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <json.hpp>
 
+#include <mos/core/assets_cache.hpp>
+#include <mos/core/thread_pool.hpp>
 #include <mos/gfx/character.hpp>
 #include <mos/gfx/environment_light.hpp>
 #include <mos/gfx/font.hpp>
@@ -16,12 +20,30 @@
 
 namespace mos::gfx {
 
-/** Cache for faster loading of textures and meshes. */
+class Material;
+class Model;
+
+/** Cache for faster loading of models, materials, textures and meshes. */
 class Assets final {
 public:
+  /** How *.model files are read. */
+  enum class Parser {
+    /** Parse to a document, shared with other loads of the same path. */
+    Document,
+    /** Read only the needed fields with a SAX parser, for large files. */
+    Sax
+  };
+
+  /** Assets that finished loading asynchronously. */
+  struct Loaded {
+    std::vector<Shared_mesh> meshes;
+    std::vector<Shared_texture_2D> textures;
+  };
+
   /** @param directory The directory where the assets exist, relative to the run
    * directory. */
-  explicit Assets(std::string directory = "assets/");
+  explicit Assets(std::string directory = "assets/",
+                  Parser parser = Parser::Document);
 
   Assets(const Assets &assets) = delete;
   Assets(const Assets &&assets) = delete;
@@ -29,18 +51,51 @@ public:
   Assets &operator=(const Assets &&assets) = delete;
   ~Assets() = default;
 
-  /** Loads a Mesh from a *.mesh file and caches it internally. */
+  /** Parsed JSON file, cached by path. */
+  auto document(const std::string &path)
+      -> std::shared_ptr<const nlohmann::json>;
+
+  /** Loads a Model hierarchy from a *.model file and caches it internally,
+   * children referenced by several models are loaded once. */
+  auto model(const std::string &path) -> Model;
+
+  /** Loads a Material from a *.material file and caches it internally. */
+  auto material(const std::string &path) -> Material;
+
+  /** Loads a Mesh from a *.mesh or *.mesh2 file and caches it internally. */
   auto mesh(const std::string &path) -> Shared_mesh;
 
   /** Loads Texture2D from a *.png file or *.texture and caches it internally.
-   */
+   * Decoded and mipmapped data is also cached on disk, next to the assets
+   * directory, so later runs skip decoding. */
   auto texture(const std::string &path, bool color_data = true,
                bool mipmaps = true,
                const Texture_2D::Filter &filter = Texture_2D::Filter::Linear,
                const Texture_2D::Wrap &wrap = Texture_2D::Wrap::Repeat)
       -> Shared_texture_2D;
 
-  /** Remove all unused assets. */
+  /** Loads a Mesh on a worker thread. Requests for a path already in flight
+   * share the same load. */
+  auto mesh_async(const std::string &path) -> std::shared_future<Shared_mesh>;
+
+  /** Loads a Texture2D on a worker thread. Requests for a path already in
+   * flight share the same load. */
+  auto texture_async(const std::string &path, bool color_data = true,
+                     bool mipmaps = true,
+                     const Texture_2D::Filter &filter = Texture_2D::Filter::Linear,
+                     const Texture_2D::Wrap &wrap = Texture_2D::Wrap::Repeat)
+      -> std::shared_future<Shared_texture_2D>;
+
+  /** Cache finished asynchronous loads. Call from the render thread and pass
+   * the result to gl::Renderer::load. Rethrows the first error of failed
+   * loads after caching the others, which the next call then returns. */
+  auto commit() -> Loaded;
+
+  /** Number of asynchronous loads in flight. */
+  auto pending() const -> size_t;
+
+  /** Remove all unused assets. Parsed documents, models and materials are
+   * always removed, since they hold on to meshes and textures. */
   auto clear_unused() -> void;
 
   /** Clear all assets. */
@@ -50,11 +105,29 @@ public:
   auto directory() const -> std::string;
 
 private:
+  using Documents =
+      std::unordered_map<std::string, std::shared_ptr<const nlohmann::json>>;
+  using Models = std::unordered_map<std::string, std::shared_ptr<const Model>>;
+  using Materials =
+      std::unordered_map<std::string, std::shared_ptr<const Material>>;
   using Meshes = std::unordered_map<std::string, Shared_mesh>;
   using Textures = std::unordered_map<std::string, Shared_texture_2D>;
+  using Pending_meshes =
+      std::unordered_map<std::string, std::shared_future<Shared_mesh>>;
+  using Pending_textures =
+      std::unordered_map<std::string, std::shared_future<Shared_texture_2D>>;
 
   const std::string directory_;
+  const Parser parser_;
+  const Assets_cache cache_;
+  Documents documents_;
+  Models models_;
+  Materials materials_;
   Meshes meshes_;
   Textures textures_;
+  Pending_meshes pending_meshes_;
+  Pending_textures pending_textures_;
+  /** Loads cached by a commit that threw, returned by the next. */
+  Loaded unreturned_;
 };
 } // namespace mos::gfx
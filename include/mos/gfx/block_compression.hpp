@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace mos::gfx {
+
+/** 4x4 pixels in row order, with four 8 bit channels each. */
+using Pixel_block = std::array<std::array<std::uint8_t, 4>, 16>;
+
+/** BC1 (DXT1) block from the RGB channels, always in four color mode. */
+auto encode_bc1(const Pixel_block &pixels) -> std::array<std::uint8_t, 8>;
+
+/** BC3 (DXT5) block, BC4 encoded alpha followed by BC1 encoded color. */
+auto encode_bc3(const Pixel_block &pixels) -> std::array<std::uint8_t, 16>;
+
+/** BC4 block from one channel. */
+auto encode_bc4(const Pixel_block &pixels, int channel = 0)
+    -> std::array<std::uint8_t, 8>;
+
+/** BC5 block from the first two channels. */
+auto encode_bc5(const Pixel_block &pixels) -> std::array<std::uint8_t, 16>;
+
+/** RGB channels of a BC1 block, alpha is set to 255. */
+auto decode_bc1(const std::array<std::uint8_t, 8> &block) -> Pixel_block;
+
+/** One channel of a BC4 block, written to channel of the result. */
+auto decode_bc4(const std::array<std::uint8_t, 8> &block, int channel = 0)
+    -> Pixel_block;
+
+} // namespace mos::gfx
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mos::gfx {
+
+/** Scale and bias to F0 of the split sum approximation of specular image
+ * based lighting, integrated with GGX importance sampling. Texels go by
+ * n dot v along rows and roughness down columns, both sampled at texel
+ * centers. Computed on all cores, four texels at a time, once per size and
+ * sample count and then shared. */
+auto brdf_lut(int size = 128, int samples = 1024)
+    -> std::shared_ptr<const std::vector<glm::vec2>>;
+
+} // namespace mos::gfx
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <mos/gfx/camera.hpp>
+#include <mos/sim/ray.hpp>
+
+namespace mos::gfx {
+
+/** Bounding volume hierarchy of boxes over spheres, for frustum and ray
+ * queries. Built top down by splitting at the median of the widest axis, and
+ * refit bottom up when the spheres move. */
+class Bvh final {
+public:
+  using Index = std::uint32_t;
+
+  /** Spheres with a negative radius are never found. */
+  struct Sphere {
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+  };
+
+  struct Hit {
+    Index index{0};
+    float distance{0.0f};
+  };
+
+  /** Build the hierarchy over spheres, found by their index. */
+  auto build(std::span<const Sphere> spheres) -> void;
+
+  /** Update the bounds of moved spheres, as many as built. Rebuilds if the
+   * refit hierarchy has grown too loose. */
+  auto refit(std::span<const Sphere> spheres) -> void;
+
+  /** Append spheres within the frustum planes to indices. */
+  auto query(const Camera::Planes &planes, std::vector<Index> &indices) const
+      -> void;
+
+  /** Set bit i of word i / 64 if sphere i is within the frustum planes. */
+  auto query(const Camera::Planes &planes, std::span<std::uint64_t> bits) const
+      -> void;
+
+  /** Closest sphere hit by the ray, within max_distance. */
+  auto intersect(const sim::Ray &ray,
+                 float max_distance = std::numeric_limits<float>::max()) const
+      -> std::optional<Hit>;
+
+  /** Number of spheres. */
+  auto size() const -> std::size_t;
+
+  /** Number of rebuilds, including refits that rebuilt. */
+  auto builds() const -> int;
+
+private:
+  /** Inner nodes are followed by their left child. Median splits keep the
+   * depth logarithmic, so traversal stacks have a fixed size. */
+  struct Node {
+    glm::vec3 min{0.0f};
+    /** Range of items_ in the subtree. */
+    std::uint32_t begin{0};
+    glm::vec3 max{0.0f};
+    std::uint32_t end{0};
+    /** Index of the right child, zero for leaves. */
+    std::uint32_t right{0};
+  };
+
+  static constexpr std::uint32_t leaf_size = 4;
+
+  auto split(std::uint32_t begin, std::uint32_t end) -> std::uint32_t;
+  auto area() const -> float;
+
+  template <class Visit>
+  auto visit(const Camera::Planes &planes, Visit &&visit) const -> void;
+
+  std::vector<Sphere> spheres_;
+  std::vector<Node> nodes_;
+  std::vector<Index> items_;
+  float built_area_{0.0f};
+  int builds_{0};
+};
+
+} // namespace mos::gfx
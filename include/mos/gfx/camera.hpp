@@ -46,6 +46,9 @@ public:
   /** Check if sphere with a radius is within camera frustum. */
   auto in_frustum(const glm::vec3 &point, float radius) const -> bool;
 
+  /** Normalized frustum planes, facing inwards. */
+  auto frustum_planes() const -> const Planes &;
+
   /** Get near clip plane. */
   auto near_plane() const -> float;
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <mos/gfx/bvh.hpp>
+#include <mos/gfx/camera.hpp>
+
+namespace mos::gfx {
+
+/** Visibility of world space bounding spheres from several views at once.
+ * Spheres are kept in a flat structure of arrays, filled once per frame, and
+ * tested four at a time against every frustum plane of every view. Above
+ * hierarchy_size spheres, views query a hierarchy instead, refit each frame
+ * while the number of spheres stays the same. */
+class Culling final {
+public:
+  using Index = std::uint32_t;
+  using Word = std::uint64_t;
+  static constexpr std::size_t word_bits = 64;
+  static constexpr std::size_t hierarchy_size = 1024;
+
+  /** Remove all spheres and views. */
+  auto clear() -> void;
+
+  /** Add a bounding sphere, a negative radius is never visible.
+   * @return Index of the sphere. */
+  auto add(const glm::vec3 &center, float radius) -> Index;
+
+  /** Add a view to test all spheres against.
+   * @return Index of the view. */
+  auto add(const Camera &camera) -> Index;
+
+  /** Test every sphere against every view. */
+  auto cull() -> void;
+
+  auto visible(Index view, Index sphere) const -> bool;
+
+  /** Bit i of word i / 64 is set if sphere i is visible from the view. */
+  auto visibility(Index view) const -> std::span<const Word>;
+
+  /** Number of spheres. */
+  auto size() const -> std::size_t;
+
+  auto views() const -> std::size_t;
+
+private:
+  auto words() const -> std::size_t;
+
+  /** Padded to a multiple of four with spheres that are never visible. */
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> z_;
+  std::vector<float> radius_;
+  std::size_t size_{0};
+
+  std::vector<Camera::Planes> views_;
+  std::vector<Word> visibility_;
+
+  std::vector<Bvh::Sphere> spheres_;
+  Bvh bvh_;
+};
+
+} // namespace mos::gfx
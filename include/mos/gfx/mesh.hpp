@@ -5,6 +5,7 @@
 #include <functional>
 #include <initializer_list>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,7 @@
 namespace mos::gfx {
 
 class Mesh;
+class Mesh_file;
 using Shared_mesh = std::shared_ptr<Mesh>;
 using Triangle_indices = std::array<int, 3>;
 
@@ -38,7 +40,10 @@ public:
 
   explicit Mesh();
 
-  /** Load from *.mesh file. @param path Full path*/
+  /** Copy vertices, indices and bounding sphere from a mapped *.mesh2 file. */
+  explicit Mesh(const Mesh_file &file);
+
+  /** Load from *.mesh or *.mesh2 file. @param path Full path*/
   static auto load(const std::string &path) -> Mesh;
 
   /** Erease all vertices and indices. */
@@ -67,16 +72,9 @@ public:
   Tracked_container<Triangle_indices> indices;
 
 private:
-  struct Triangle {
-    Vertex &v0;
-    Vertex &v1;
-    Vertex &v2;
-    auto normal() const -> glm::vec3;
-  };
-
-  static auto calculate_tangents(Vertex &v0, Vertex &v1, Vertex &v2) -> void;
-  void for_each_triangle(
-      const std::function<void(const Triangle &triangle)> &callback);
+  /** All vertices, marked as modified. */
+  auto mutable_vertices() -> std::span<Vertex>;
+  auto triangles() const -> std::span<const Triangle_indices>;
 
   glm::vec3 centroid_{0.0f};
   float radius_{0.0f};
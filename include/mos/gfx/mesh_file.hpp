@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include <mos/core/mapped_file.hpp>
+#include <mos/gfx/mesh.hpp>
+#include <mos/gfx/shape.hpp>
+#include <mos/gfx/vertex.hpp>
+
+namespace mos::gfx {
+
+/** Memory mapped *.mesh2 file. Vertices and indices are read in place, with
+ * precomputed tangents and bounding sphere, and can be uploaded to the GPU
+ * straight from the mapping. */
+class Mesh_file final : public Shape {
+public:
+  /** Binary layout of the file header, followed by aligned vertex and index
+   * data. */
+  struct Header {
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint32_t num_vertices;
+    std::uint32_t num_triangles;
+    std::uint64_t vertices_offset;
+    std::uint64_t indices_offset;
+    glm::vec3 centroid;
+    float radius;
+  };
+
+  static constexpr std::array<char, 4> magic{'M', 'O', 'S', 'M'};
+  static constexpr std::uint32_t version = 1;
+
+  /** Alignment of the vertex and index blocks, in bytes. */
+  static constexpr std::uint64_t alignment = 64;
+
+  explicit Mesh_file(const std::string &path);
+
+  /** Write a mesh to a *.mesh2 file. */
+  static auto write(const std::string &path, const Mesh &mesh) -> void;
+
+  /** Vertices, pointing into the mapped file. */
+  auto vertices() const -> std::span<const Vertex>;
+
+  /** Triangle indices, pointing into the mapped file. */
+  auto indices() const -> std::span<const Triangle_indices>;
+
+  auto centroid() const -> glm::vec3;
+
+  auto radius() const -> float;
+
+private:
+  Mapped_file file_;
+  const Header *header_{nullptr};
+};
+} // namespace mos::gfx
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include <mos/gfx/vertex.hpp>
+
+namespace mos::gfx::kernels {
+
+using Triangle_indices = std::array<int, 3>;
+
+/** How a kernel distributes work over threads. */
+enum class Execution {
+  /** Parallel from parallel_threshold vertices. */
+  Automatic,
+  Sequential,
+  Parallel
+};
+
+/** Vertex count from which Automatic runs in parallel. */
+constexpr std::size_t parallel_threshold = 1 << 16;
+
+struct Sphere {
+  glm::vec3 centroid{0.0f};
+  float radius{0.0f};
+};
+
+/** Normalized sum of adjacent face normals, linear in the number of
+ * triangles. Vertices not referenced by any triangle are left unchanged.
+ * Without triangles, every three vertices form a triangle. */
+auto smooth_normals(std::span<Vertex> vertices,
+                    std::span<const Triangle_indices> triangles) -> void;
+
+/** Face normal to each vertex, the last triangle referencing a vertex wins. */
+auto flat_normals(std::span<Vertex> vertices,
+                  std::span<const Triangle_indices> triangles) -> void;
+
+/** Tangents from positions and uvs, the last triangle referencing a vertex
+ * wins. */
+auto tangents(std::span<Vertex> vertices,
+              std::span<const Triangle_indices> triangles) -> void;
+
+/** Transform positions, and normals and tangents by the inverse transpose. */
+auto transform(std::span<Vertex> vertices, const glm::mat4 &transform,
+               Execution execution = Execution::Automatic) -> void;
+
+/** Interpolate position, normal and uv between two vertex sets, of at least
+ * the size of vertices. */
+auto mix(std::span<Vertex> vertices, std::span<const Vertex> from,
+         std::span<const Vertex> to, float amount,
+         Execution execution = Execution::Automatic) -> void;
+
+/** Sphere around the centroid of positions. */
+auto bounding_sphere(std::span<const Vertex> vertices,
+                     Execution execution = Execution::Automatic) -> Sphere;
+
+} // namespace mos::gfx::kernels
@@ -15,6 +15,7 @@ namespace mos::gfx {
 
 class Assets;
 class Material;
+struct Model_description;
 
 namespace gl {
 class Renderer;
@@ -28,6 +29,10 @@ public:
                    const glm::mat4 &parent_transform = glm::mat4(1.0f))
       -> Model;
 
+  /** Load meshes, materials and children of a description through assets. */
+  static auto load(const Model_description &description, Assets &assets)
+      -> Model;
+
   Model(std::string name, Shared_mesh mesh,
         glm::mat4 transform = glm::mat4(1.0f),
         Material material = Material{glm::vec3(1.0f)});
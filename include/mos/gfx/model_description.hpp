@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <json.hpp>
+
+namespace mos::gfx {
+
+/** Fields of a *.model file, before meshes and materials are loaded. */
+struct Model_description {
+  /** From a parsed document. */
+  static auto parse(const nlohmann::json &json) -> Model_description;
+
+  /** From a *.model file, with a SAX parser that builds no document and skips
+   * unknown fields. @param path Full path. */
+  static auto read(const std::string &path) -> Model_description;
+
+  std::string name;
+  std::string mesh;
+  std::string material;
+  glm::mat4 transform{1.0f};
+  std::vector<std::string> children;
+};
+} // namespace mos::gfx
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <mos/gfx/bvh.hpp>
+#include <mos/gfx/mesh_kernels.hpp>
+
+namespace mos::gfx {
+
+/** Flattened model hierarchy with cached world transforms, normal matrices
+ * and bounds. Nodes are stored after their parents, so one pass in order
+ * propagates transforms, and only nodes that changed or have a changed
+ * ancestor are computed again. */
+class Scene_graph final {
+public:
+  using Index = std::uint32_t;
+  /** Parent of top level nodes. */
+  static constexpr Index none = std::numeric_limits<Index>::max();
+
+  struct Stats {
+    /** Nodes computed by the last update. */
+    std::size_t updated{0};
+  };
+
+  /** Remove all nodes. */
+  auto clear() -> void;
+
+  /** Add a node after its parent.
+   * @param bounds Local bounding sphere, a negative radius is never visible.
+   * @return Index of the node. */
+  auto add(Index parent, const glm::mat4 &local, const Bvh::Sphere &bounds)
+      -> Index;
+
+  /** Set the local transform, the node is updated if it changed. */
+  auto local(Index node, const glm::mat4 &local) -> void;
+
+  /** Set the local bounding sphere, the node is updated if it changed. */
+  auto bounds(Index node, const Bvh::Sphere &bounds) -> void;
+
+  /** Compute world data of changed nodes and their descendants. Normal
+   * matrices and bounds are computed in parallel from
+   * kernels::parallel_threshold changed nodes, with Automatic. */
+  auto update(kernels::Execution execution = kernels::Execution::Automatic)
+      -> void;
+
+  auto parent(Index node) const -> Index;
+
+  auto world(Index node) const -> const glm::mat4 &;
+
+  /** Inverse transpose of the world transform, padded to four columns. */
+  auto normal(Index node) const -> const glm::mat4 &;
+
+  /** Updates since the world data of a node last changed, zero for nodes
+   * computed by the last update. */
+  auto age(Index node) const -> std::uint32_t;
+
+  /** World space bounding spheres, indexed by node. */
+  auto spheres() const -> std::span<const Bvh::Sphere>;
+
+  /** Number of nodes. */
+  auto size() const -> std::size_t;
+
+  auto stats() const -> Stats;
+
+private:
+  std::vector<Index> parents_;
+  std::vector<glm::mat4> locals_;
+  std::vector<Bvh::Sphere> bounds_;
+  std::vector<std::uint8_t> changed_;
+  std::vector<std::uint32_t> ages_;
+
+  std::vector<glm::mat4> worlds_;
+  std::vector<glm::mat4> normals_;
+  std::vector<Bvh::Sphere> spheres_;
+  /** Nodes computed by the last update, in order. */
+  std::vector<Index> updated_;
+};
+
+} // namespace mos::gfx
@@ -11,6 +11,9 @@ public:
   /** Unique id. */
   auto id() const -> unsigned int;
 
+  /** Changes when a released id is reused. */
+  auto generation() const -> std::uint32_t;
+
 private:
   Id<Shape> id_;
 };
@@ -21,6 +21,9 @@ public:
   /** Unique id */
   auto id() const -> int;
 
+  /** Changes when a released id is reused. */
+  auto generation() const -> std::uint32_t;
+
 private:
   Id<Target> id_;
 };
@@ -30,6 +30,9 @@ public:
 
   auto id() const -> int;
 
+  /** Changes when a released id is reused. */
+  auto generation() const -> std::uint32_t;
+
   bool generate_mipmaps;
   Filter filter;
   Wrap wrap;
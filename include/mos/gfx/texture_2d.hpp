@@ -22,7 +22,7 @@ public:
              const Filter &filter = Filter::Linear,
              const Wrap &wrap = Wrap::Repeat, const bool mipmaps = true)
       : Texture(filter, wrap, mipmaps),
-        texture_(format, gli::extent2d(width, height)) {
+        texture_(format, gli::extent2d(width, height), 1) {
     std::memcpy(texture_.data(), begin, std::distance(begin, end));
   }
 
@@ -31,19 +31,42 @@ public:
              const Filter &filter = Filter::Linear,
              const Wrap &wrap = Wrap::Repeat, bool mipmaps = true);
 
-  /** Create from file. */
+  /** Create from file. *.ktx and *.dds files keep their format and mipmap
+   * levels, color_data is only used for other formats. */
   static auto load(const std::string &path, bool color_data = true,
                    bool generate_mipmaps = true,
                    const Filter &filter = Filter::Linear,
                    const Wrap &wrap = Wrap::Repeat) -> Texture_2D;
 
-  auto width() const -> int;
-  auto height() const -> int;
-  const void *data() const;
+  /** Write all levels to a *.ktx or *.dds file. */
+  auto save(const std::string &path) const -> void;
+
+  /** Compute the full mipmap chain on the CPU, from the first level. */
+  auto build_mipmaps() -> void;
+
+  /** Block compressed copy of all levels: BC1 for RGB, BC3 for RGBA, BC4 for
+   * R and BC5 for RG. Other compressed formats, such as BC7, can be loaded
+   * from file. */
+  auto compress() const -> Texture_2D;
+
+  /** Number of levels with data, one unless built or loaded with mipmaps. */
+  auto levels() const -> int;
+
+  /** If the format is block compressed. */
+  auto compressed() const -> bool;
+
+  /** Size of a level in bytes. */
+  auto size(int level = 0) const -> std::size_t;
+
+  auto width(int level = 0) const -> int;
+  auto height(int level = 0) const -> int;
+  const void *data(int level = 0) const;
   gli::format format() const;
   gli::swizzles swizzles() const;
 
 private:
+  Texture_2D(gli::texture2d texture, const Filter &filter, const Wrap &wrap,
+             bool mipmaps);
   gli::texture2d texture_;
 };
 } // namespace mos::gfx
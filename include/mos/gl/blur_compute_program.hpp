@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <glad/glad.h>
+
+namespace mos::gl {
+
+class Blur_compute_program : public Program {
+  friend class Renderer;
+private:
+  Blur_compute_program();
+public:
+  /** Work group side, and largest kernel radius, as in the shader. */
+  static constexpr int tile = 16;
+  static constexpr int max_radius = 12;
+
+  GLint input_sampler;
+  GLint source;
+  GLint destination;
+  GLint radius;
+  GLint weights;
+  GLint moments;
+};
+}
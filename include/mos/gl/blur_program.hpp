@@ -11,5 +11,6 @@ private:
 public:
   GLint color_sampler;
   GLint horizontal;
+  GLint region;
 };
 }
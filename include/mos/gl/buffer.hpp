@@ -1,19 +1,66 @@
 #pragma once
 
-#include <chrono>
+#include <algorithm>
+#include <cstdint>
 #include <glad/glad.h>
+#include <mos/core/tracked_container.hpp>
+#include <mos/gl/ring_buffer.hpp>
 
 namespace mos::gl {
 
 class Buffer {
   friend class Renderer;
-  friend class Vertex_array;
 public:
-  using Time_point = std::chrono::time_point<std::chrono::system_clock,
-                                             std::chrono::nanoseconds>;
+  using Generation = std::uint64_t;
 private:
   Buffer(GLenum type, GLsizeiptr size, const void *data, GLenum hint,
-         Time_point modified);
+         Generation generation);
+
+  template <class T>
+  Buffer(GLenum type, const Tracked_container<T> &container, GLenum hint)
+      : Buffer(type, GLsizeiptr(container.size() * sizeof(T)),
+               container.data(), hint, container.modified()) {
+    container.mark_clean();
+  }
+
+  /** Upload a modified container. Only the dirty range is uploaded, if the
+   * buffer holds the generation the range is relative to. Whole uploads go
+   * through the staging ring when one is given, and are copied on the GPU
+   * into storage that is only reallocated when outgrown. */
+  template <class T>
+  auto update(const Tracked_container<T> &container, GLenum hint,
+              Ring_buffer *staging = nullptr) -> void {
+    const auto container_size = GLsizeiptr(container.size() * sizeof(T));
+    const auto dirty = container.dirty();
+    // Edited through the copy target, as the streaming fallback does not
+    // require direct state access.
+    glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+    if (container_size == size && generation == container.clean_generation() &&
+        !dirty.empty()) {
+      glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(dirty.begin * sizeof(T)),
+                      GLsizeiptr((dirty.end - dirty.begin) * sizeof(T)),
+                      container.data() + dirty.begin);
+    } else if (staging) {
+      if (container_size > capacity) {
+        capacity = std::max(container_size, capacity * 2);
+        glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, hint);
+      }
+      if (container_size > 0) {
+        Ring_buffer::copy(staging->write(container.data(), container_size), id,
+                          0);
+      }
+      size = container_size;
+    } else {
+      glBufferData(GL_COPY_WRITE_BUFFER, container_size, container.data(),
+                   hint);
+      size = container_size;
+      capacity = container_size;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    generation = container.modified();
+    container.mark_clean();
+  }
+
 public:
   Buffer(const Buffer &buffer) = delete;
   Buffer(Buffer &&buffer) noexcept;
@@ -22,7 +69,10 @@ public:
   ~Buffer();
 
   GLuint id{0};
-  Time_point modified;
+  /** Bytes in use, and allocated. */
+  GLsizeiptr size{0};
+  GLsizeiptr capacity{0};
+  Generation generation{0};
 
 private:
   void release();
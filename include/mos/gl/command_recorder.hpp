@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <mos/core/thread_pool.hpp>
+#include <mos/gfx/scene_graph.hpp>
+#include <mos/gl/draw_list.hpp>
+
+namespace mos::gl {
+
+/** GL state of a flattened model, resolved on the GL thread before
+ * recording. */
+struct Drawable {
+  /** Zero if the model is not drawn. */
+  unsigned int vertex_array{0};
+  int num_indices{0};
+  /** Color pass textures, albedo first. */
+  Draw::Textures textures{};
+  Material_uniforms material;
+  /** Location of the mesh in the vertex array's buffers. */
+  std::uint32_t first_index{0};
+  std::int32_t base_vertex{0};
+  /** Upload generations of the mesh, see Draw. */
+  std::uint64_t vertex_generation{0};
+  std::uint64_t index_generation{0};
+};
+
+/** Records the draw lists of a frame's render passes on worker threads.
+ * Recording reads only flattened and resolved scene data and makes no GL
+ * calls, the lists are submitted on the GL thread afterwards. */
+class Command_recorder final {
+public:
+  struct Pass {
+    unsigned int program{0};
+    /** Depth draws keep only the albedo texture, albedo and emission. */
+    bool depth{false};
+    /** Camera position, draws are sorted by distance to it. */
+    glm::vec3 eye{0.0f};
+    /** Range of nodes to draw, where set in the visibility bits. */
+    std::size_t begin{0};
+    std::size_t end{0};
+    std::span<const std::uint64_t> visible;
+    Draw_list::Order order{Draw_list::Order::Key};
+  };
+
+  /** Record and prepare one draw list per pass, indexed as passes.
+   * @param drawables GL state per scene graph node.
+   * @param pool Records passes in parallel, or sequentially if null. */
+  auto record(std::span<const Pass> passes,
+              std::span<const Drawable> drawables,
+              const gfx::Scene_graph &graph,
+              Thread_pool *pool = nullptr) -> void;
+
+  auto list(std::size_t pass) const -> const Draw_list &;
+
+  /** Number of recorded passes. */
+  auto size() const -> std::size_t;
+
+private:
+  auto record(const Pass &pass,
+              std::span<const Drawable> drawables,
+              const gfx::Scene_graph &graph,
+              Draw_list &list) const -> void;
+
+  std::vector<Draw_list> lists_;
+  std::size_t size_{0};
+};
+
+} // namespace mos::gl
@@ -9,9 +9,7 @@ class Depth_program : public Program {
 private:
   Depth_program();
 public:
-  GLint model_view_projection;
+  GLint view_projection;
   GLint albedo_sampler;
-  GLint albedo;
-  GLint emission;
 };
 }
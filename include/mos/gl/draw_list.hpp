@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mos::gl {
+
+/** Material values set as uniforms, compared to skip redundant updates. */
+struct Material_uniforms {
+  glm::vec3 albedo{0.0f};
+  glm::vec3 emission{0.0f};
+  float roughness{1.0f};
+  float metallic{0.0f};
+  float index_of_refraction{1.5f};
+  float alpha{1.0f};
+  float transmission{0.0f};
+  float ambient_occlusion{1.0f};
+
+  auto operator==(const Material_uniforms &uniforms) const -> bool = default;
+  auto hash() const -> std::uint32_t;
+  /** Drawn after opaque draws, back to front. */
+  auto translucent() const -> bool;
+};
+
+/** One mesh with its material and world transform, and the GL state it needs. */
+struct Draw {
+  /** Bound textures, in the order of texture units 7 to 12. */
+  using Textures = std::array<unsigned int, 6>;
+
+  unsigned int program{0};
+  unsigned int vertex_array{0};
+  Textures textures{};
+  Material_uniforms material;
+  glm::mat4 transform{1.0f};
+  /** Cached normal matrix, computed from transform if null. */
+  const glm::mat4 *normal{nullptr};
+  /** Location of the mesh in the vertex array's buffers. */
+  std::uint32_t first_index{0};
+  std::int32_t base_vertex{0};
+  int num_indices{0};
+  /** Upload generations of the mesh's vertices and indices, which change
+   * when the mesh is uploaded again. */
+  std::uint64_t vertex_generation{0};
+  std::uint64_t index_generation{0};
+  /** Distance from the camera. */
+  float distance{0.0f};
+
+  std::uint64_t key{0};
+
+  /** State that differs from the previous draw, set by Draw_list::prepare. */
+  bool program_changed{true};
+  bool vertex_array_changed{true};
+  bool material_changed{true};
+  /** One bit per texture unit. */
+  std::uint8_t textures_changed{0x3F};
+};
+
+/** Per instance data, laid out as the shaders' std430 instance buffer. */
+struct Instance {
+  glm::mat4 model{1.0f};
+  /** Inverse transpose of the model matrix, padded to four columns. */
+  glm::mat4 normal{1.0f};
+  /** Index into the material buffer. */
+  std::uint32_t material{0};
+  std::array<std::uint32_t, 3> padding{};
+};
+
+/** Material values, laid out as the shaders' std430 material buffer. */
+struct Material_block {
+  glm::vec3 albedo{0.0f};
+  float roughness{1.0f};
+  glm::vec3 emission{0.0f};
+  float metallic{0.0f};
+  float index_of_refraction{1.5f};
+  float alpha{1.0f};
+  float transmission{0.0f};
+  float ambient_occlusion{1.0f};
+};
+
+/** Parameters of one indexed draw, laid out as DrawElementsIndirectCommand. */
+struct Draw_command {
+  std::uint32_t count{0};
+  std::uint32_t instance_count{0};
+  std::uint32_t first_index{0};
+  std::int32_t base_vertex{0};
+  /** Index of the first instance, read through the instanced attribute. */
+  std::uint32_t base_instance{0};
+};
+
+static_assert(sizeof(Instance) == 144);
+static_assert(sizeof(Material_block) == 48);
+static_assert(sizeof(Draw_command) == 20);
+
+/** Flattened draws of a scene, sorted to minimize GL state changes. Draws
+ * of the same mesh with the same state are merged into instanced batches,
+ * one indirect draw command each. Materials are read from a buffer, so
+ * consecutive batches with the same program, vertex array and textures can
+ * be submitted as one multi draw. */
+class Draw_list final {
+public:
+  /** Key minimizes state changes. Depth draws opaque draws front to back,
+   * so early depth tests reject hidden fragments, then translucent draws as
+   * Key does. Submission keeps the order draws were added in. */
+  enum class Order { Key, Depth, Submission };
+
+  /** Consecutive draws with equal state, drawn as one instanced call. */
+  struct Batch {
+    /** Index of the first draw, and of its instance. */
+    std::uint32_t first{0};
+    std::uint32_t count{0};
+  };
+
+  /** State changes to submit the list. */
+  struct Stats {
+    int draws{0};
+    int programs{0};
+    int vertex_arrays{0};
+    int textures{0};
+    int materials{0};
+    /** Draw commands after batching. */
+    int batches{0};
+    /** Multi draw calls, runs of batches without program, vertex array or
+     * texture changes. */
+    int multi_draws{0};
+    auto operator+=(const Stats &stats) -> Stats &;
+  };
+
+  /** Sort key, from most to least significant: translucency, program,
+   * texture set, material, mesh and depth. Translucent draws sort
+   * back to front before anything else. */
+  static auto key(const Draw &draw) -> std::uint64_t;
+
+  auto add(const Draw &draw) -> void;
+
+  auto clear() -> void;
+
+  /** Sort by key, unless kept in submission order, mark the state that
+   * changes between consecutive draws, and batch draws with equal state. */
+  auto prepare(Order order = Order::Key) -> void;
+
+  /** Batches of the last prepare, in draw order. */
+  auto batches() const -> const std::vector<Batch> &;
+
+  /** Instance data of the last prepare, one per draw in draw order. */
+  auto instances() const -> const std::vector<Instance> &;
+
+  /** Materials of the last prepare, indexed by the instances. */
+  auto materials() const -> const std::vector<Material_block> &;
+
+  /** Draw commands of the last prepare, one per batch. */
+  auto commands() const -> const std::vector<Draw_command> &;
+
+  /** Number of batches before the first translucent one. */
+  auto opaque_batches() const -> std::size_t;
+
+  /** Hash of the meshes, their upload generations, textures and transforms
+   * drawn by the last prepare, equal for lists that draw the same depth. */
+  auto hash() const -> std::uint64_t;
+
+  /** Changes marked by the last prepare. */
+  auto stats() const -> Stats;
+
+  auto size() const -> std::size_t;
+  auto begin() const -> std::vector<Draw>::const_iterator;
+  auto end() const -> std::vector<Draw>::const_iterator;
+
+private:
+  std::vector<Draw> draws_;
+  std::vector<Batch> batches_;
+  std::vector<Instance> instances_;
+  std::vector<Material_block> materials_;
+  std::vector<Draw_command> commands_;
+  std::size_t opaque_batches_{0};
+  Stats stats_;
+};
+
+} // namespace mos::gl
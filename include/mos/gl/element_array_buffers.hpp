@@ -1,9 +0,0 @@
-#pragma once
-
-#include <mos/gl/buffer.hpp>
-
-namespace mos::gl {
-
-using Element_array_buffers = std::unordered_map<unsigned int, Buffer>;
-
-}
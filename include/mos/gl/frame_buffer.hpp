@@ -1,7 +1,7 @@
 #pragma once
 
-#include <mos/gl/render_buffer.hpp>
-#include <mos/gl/texture_buffer_2d.hpp>
+#include <mos/gl/render_buffers.hpp>
+#include <mos/gl/texture_buffers.hpp>
 #include <mos/gfx/texture_target.hpp>
 
 namespace mos::gl {
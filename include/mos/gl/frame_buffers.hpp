@@ -1,9 +1,10 @@
 #pragma once
 
+#include <mos/core/slot_map.hpp>
 #include <mos/gl/frame_buffer.hpp>
 
 namespace mos::gl {
 
-using Frame_buffers = std::unordered_map<unsigned int, Frame_buffer>;
+using Frame_buffers = Slot_map<Frame_buffer>;
 
 }
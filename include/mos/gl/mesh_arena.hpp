@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include <glad/glad.h>
+
+#include <mos/core/range_allocator.hpp>
+#include <mos/core/slot_map.hpp>
+#include <mos/gfx/mesh.hpp>
+#include <mos/gfx/mesh_file.hpp>
+#include <mos/gl/ring_buffer.hpp>
+
+namespace mos::gl {
+
+/** Vertices and indices of all meshes in two shared buffers, drawn through
+ * one vertex array. Each mesh owns a range of vertices and of triangles, so
+ * draws differ only in their first index and base vertex, and consecutive
+ * draws can be submitted as one multi draw. Buffers grow by copying when
+ * full, and are compacted when much of them is free. */
+class Mesh_arena final {
+  friend class Renderer;
+public:
+  using Generation = std::uint64_t;
+
+  /** Attribute of the instanced index, instance i of a draw reads its base
+   * instance plus i. */
+  static constexpr GLuint instance_attribute = 4;
+
+  /** Ranges of a loaded mesh. */
+  struct Allocation {
+    std::uint32_t base_vertex{0};
+    std::uint32_t vertices{0};
+    std::uint32_t first_triangle{0};
+    std::uint32_t triangles{0};
+    /** Generations of the uploaded vertices and indices. */
+    Generation vertex_generation{std::numeric_limits<Generation>::max()};
+    Generation index_generation{std::numeric_limits<Generation>::max()};
+  };
+
+  struct Stats {
+    Range_allocator::Stats vertices;
+    Range_allocator::Stats triangles;
+    /** Buffer reallocations since created. */
+    int grows{0};
+    int compactions{0};
+    /** Vertex and index uploads since created, changes when any loaded
+     * mesh changes. */
+    std::uint64_t uploads{0};
+  };
+
+private:
+  /** @param vertices, triangles Initial capacity, grown when outgrown. */
+  Mesh_arena(std::uint32_t vertices, std::uint32_t triangles);
+
+public:
+  ~Mesh_arena();
+  Mesh_arena(const Mesh_arena &arena) = delete;
+  Mesh_arena(Mesh_arena &&arena) = delete;
+  Mesh_arena &operator=(const Mesh_arena &arena) = delete;
+  Mesh_arena &operator=(Mesh_arena &&arena) = delete;
+
+  /** Allocate ranges for a mesh, or move it if its size changed, and upload
+   * what was modified through the staging ring. */
+  auto load(const gfx::Mesh &mesh, Ring_buffer &staging) -> const Allocation &;
+
+  /** Allocate ranges for a mesh file, uploaded once straight from its
+   * mapping, without a copy into the staging ring. */
+  auto load(const gfx::Mesh_file &file) -> const Allocation &;
+
+  /** Free the ranges of a mesh. */
+  auto unload(unsigned int id) -> void;
+
+  /** Pack the ranges of loaded meshes and shrink each buffer to fit them,
+   * not below its initial capacity, if more than a quarter of it is free
+   * and it would shrink. So unloaded meshes release their memory. Moves
+   * the ranges of loaded meshes in the buffers compacted.
+   * @return True if either buffer was compacted. */
+  auto compact() -> bool;
+
+  auto find(unsigned int id) const -> const Allocation *;
+
+  /** Free all ranges. */
+  auto clear() -> void;
+
+  /** Make instanced indices available up to count instances per draw. */
+  auto reserve_instances(std::uint32_t count) -> void;
+
+  auto stats() const -> Stats;
+
+  GLuint vertex_array{0};
+
+private:
+  /** Allocate size elements, growing the buffer to fit. */
+  auto allocate(Range_allocator &allocator, GLuint &buffer, GLsizeiptr stride,
+                std::uint32_t size) -> std::uint32_t;
+  /** Pack one buffer, offset and size are the members of its ranges. */
+  auto compact(Range_allocator &allocator, GLuint &buffer, GLsizeiptr stride,
+               std::uint32_t Allocation::*offset,
+               std::uint32_t Allocation::*size, std::uint32_t minimum)
+      -> void;
+  auto bind_buffers() -> void;
+  void release();
+
+  GLuint vertex_buffer_{0};
+  GLuint element_buffer_{0};
+  GLuint instance_buffer_{0};
+  std::uint32_t instances_{0};
+  /** Initial capacities, not compacted below. */
+  std::uint32_t min_vertices_;
+  std::uint32_t min_triangles_;
+  Range_allocator vertices_;
+  Range_allocator triangles_;
+  Slot_map<Allocation> allocations_;
+  int grows_{0};
+  int compactions_{0};
+  std::uint64_t uploads_{0};
+};
+
+} // namespace mos::gl
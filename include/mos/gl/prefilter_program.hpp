@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace mos::gl {
+
+class Prefilter_program : public Program {
+  friend class Renderer;
+private:
+  Prefilter_program();
+public:
+  /** Work group side, as in the shader. */
+  static constexpr int tile = 8;
+
+  GLint source_sampler;
+  GLint roughness;
+  GLint samples;
+};
+}
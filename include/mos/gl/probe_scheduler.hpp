@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mos::gl {
+
+/** Spreads the six cube map faces of environment probes over frames, within
+ * a budget of faces per frame. Probes with faces left go nearest first, and
+ * probes whose six faces were rendered unchanged are not rendered again. */
+class Probe_scheduler final {
+public:
+  struct Probe {
+    bool enabled{false};
+    /** Distance to the camera, nearer probes are rendered first. */
+    float distance{0.0f};
+    /** Hash of the probe itself, such as its position and extent. */
+    std::uint64_t state{0};
+    /** What the probe sees changed this frame. */
+    bool changed{false};
+  };
+
+  struct Face {
+    std::size_t probe{0};
+    int face{0};
+    /** Last face of the cube map, which is then complete. */
+    bool completes{false};
+  };
+
+  struct Stats {
+    /** Faces scheduled by the last schedule. */
+    int faces{0};
+    /** Probes complete and unchanged, not rendered. */
+    int converged{0};
+    /** Probes with faces left to render. */
+    int pending{0};
+  };
+
+  static constexpr int cube_faces = 6;
+
+  explicit Probe_scheduler(int budget);
+
+  /** Faces to render per frame, at least one. */
+  auto budget(int faces) -> void;
+
+  auto budget() const -> int;
+
+  /** Pick the faces to render this frame, once per frame. A probe that
+   * changes during a cycle of six faces completes it, then renders another
+   * cycle. */
+  auto schedule(std::span<const Probe> probes) -> void;
+
+  auto faces() const -> const std::vector<Face> &;
+
+  auto stats() const -> Stats;
+
+private:
+  struct Entry {
+    std::uint64_t state{0};
+    /** Faces rendered of the current cycle. */
+    int rendered{0};
+    /** Changed since the current cycle started. */
+    bool dirty{false};
+    bool valid{false};
+  };
+
+  int budget_;
+  std::vector<Entry> entries_;
+  std::vector<Face> faces_;
+  Stats stats_;
+};
+
+} // namespace mos::gl
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <mos/core/slot_map.hpp>
 #include <mos/gl/render_buffer.hpp>
 
 namespace mos::gl {
 
-using Render_buffers = std::unordered_map<unsigned int, Render_buffer>;
+using Render_buffers = Slot_map<Render_buffer>;
 
 }
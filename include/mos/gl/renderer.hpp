@@ -2,27 +2,38 @@
 #include <glad/glad.h>
 #include <optional>
 #include <initializer_list>
-#include <unordered_map>
+#include <vector>
 #include <array>
 #include <future>
+#include <memory>
 #include <glm/glm.hpp>
+#include <mos/gfx/assets.hpp>
 #include <mos/gfx/models.hpp>
 #include <mos/gfx/scenes.hpp>
+#include <mos/gfx/culling.hpp>
+#include <mos/gfx/scene_graph.hpp>
 
 #include <mos/gl/buffer.hpp>
 #include <mos/gl/render_buffers.hpp>
-#include <mos/gl/vertex_arrays.hpp>
+#include <mos/gl/vertex_array.hpp>
 #include <mos/gl/texture_buffers.hpp>
 #include <mos/gl/frame_buffers.hpp>
-#include <mos/gl/array_buffers.hpp>
-#include <mos/gl/element_array_buffers.hpp>
+#include <mos/gl/mesh_arena.hpp>
+#include <mos/gl/residency.hpp>
+#include <mos/gl/time_queries.hpp>
+#include <mos/gl/shadow_atlas.hpp>
+#include <mos/gl/probe_scheduler.hpp>
+#include <mos/gl/draw_list.hpp>
+#include <mos/gl/command_recorder.hpp>
 
-#include <mos/gl/light_uniforms.hpp> //TODO: remove
+#include <mos/gl/uniform_blocks.hpp>
 
 #include <mos/gl/cloud_program.hpp>
 #include <mos/gl/bloom_program.hpp>
 #include <mos/gl/compositing_program.hpp>
 #include <mos/gl/blur_program.hpp>
+#include <mos/gl/blur_compute_program.hpp>
+#include <mos/gl/prefilter_program.hpp>
 #include <mos/gl/depth_program.hpp>
 #include <mos/gl/standard_program.hpp>
 
@@ -30,6 +41,7 @@
 #include <mos/gl/blit_target.hpp>
 #include <mos/gl/post_target.hpp>
 #include <mos/gl/shadow_map_target.hpp>
+#include <mos/gl/shadow_atlas_target.hpp>
 #include <mos/gl/environment_map_target.hpp>
 
 #include <mos/gl/quad.hpp>
@@ -39,8 +51,42 @@ namespace mos::gl {
 /** Render geometry shapes with OpenGL. */
 class Renderer final {
 public:
-  /** Inits the renderer, creates an OpenGL context with GLAD. */
-  explicit Renderer(const glm::ivec2 &resolution, const int samples = 1);
+  /** Cascaded shadow map layers of the last frame. */
+  struct Cascade_stats {
+    /** Static layers rendered, and reused from earlier frames. */
+    int static_rendered{0};
+    int static_cached{0};
+    /** Cascades with moving casters drawn over the static layer. */
+    int dynamic{0};
+    /** Cascades composited and blurred, the others were unchanged. */
+    int composited{0};
+    /** State changes of all cascade passes. */
+    Draw_list::Stats draws;
+  };
+
+  struct Stats {
+    Residency::Stats residency;
+    /** State changes in the last frame. */
+    Draw_list::Stats draws;
+    /** Per frame data written to the streaming ring in the last frame. */
+    Ring_buffer::Stats streaming;
+    /** Use and fragmentation of the shared mesh buffers. */
+    Mesh_arena::Stats meshes;
+    /** Spot light tiles, rendered and skipped in the last frame. */
+    Shadow_atlas::Stats shadows;
+    std::size_t shadow_atlas_bytes{0};
+    Cascade_stats cascades;
+    /** GPU time of all blurs in a frame, read back a few frames late. */
+    float blur_milliseconds{0.0F};
+    /** Environment probe faces rendered in the last frame. */
+    Probe_scheduler::Stats probes;
+  };
+
+  /** Inits the renderer, creates an OpenGL context with GLAD.
+   * @param persistent_streaming Stream per frame data through a persistently
+   * mapped buffer, or if false with glBufferSubData, to test that path. */
+  explicit Renderer(const glm::ivec2 &resolution, const int samples = 1,
+                    bool persistent_streaming = true);
   Renderer(const Renderer &renderer) = delete;
   Renderer(const Renderer &&renderer) = delete;
   Renderer & operator=(const Renderer & renderer) = delete;
@@ -62,6 +108,13 @@ public:
   /** Unloads a mesh from GPU memory. */
   auto unload(const gfx::Mesh &mesh) -> void;
 
+  /** Load a mesh file into GPU memory, straight from its mapping. Kept
+   * loaded until unloaded, as it can not be loaded again if evicted. */
+  auto load(const gfx::Mesh_file &file) -> gpu::Mesh;
+
+  /** Unloads a mesh file from GPU memory. */
+  auto unload(const gfx::Mesh_file &file) -> void;
+
   /** Loads a shared texture into GPU memory. */
   auto load(const gfx::Shared_texture_2D &texture) -> void;
 
@@ -71,14 +124,59 @@ public:
   /** Unloads a shared texture from GPU memory. */
   auto unload(const gfx::Shared_texture_2D &texture) -> void;
 
+  /** Loads assets that finished loading asynchronously, see
+   * gfx::Assets::commit. */
+  auto load(const gfx::Assets::Loaded &loaded) -> void;
+
   /** Render multiple scenes. */
   auto render(const gfx::Scenes &scenes,
               const glm::vec4 &color = {0.0f, 0.0f, 0.0f, 1.0f},
               const glm::ivec2 &resolution = glm::ivec2(128, 128)) -> void;
 
-  /** Clear all GPU buffers/memory. */
+  /** Clear all GPU buffers/memory. Shared meshes and textures are no longer
+   * loaded again on use, until loaded with load. */
   auto clear_buffers() -> void;
 
+  /** Estimated bytes of textures and buffers to keep loaded. When exceeded,
+   * least recently used shared meshes and textures are unloaded after a
+   * frame, and loaded again when next rendered. Unlimited by default. */
+  auto vram_budget(std::size_t bytes) -> void;
+
+  /** Draw opaque models to depth first, then shade them with an equal depth
+   * test, so each pixel is shaded once. Off by default. */
+  auto depth_prepass(bool enabled) -> void;
+
+  /** Without a depth pre-pass, draw opaque models front to back so early
+   * depth tests reject hidden fragments, at the cost of more state changes
+   * than sorting by state. Off by default. */
+  auto front_to_back(bool enabled) -> void;
+
+  /** Shade each fragment of the scene pass with a constant, added up, to
+   * show how many times pixels are shaded. Off by default. */
+  auto overdraw(bool enabled) -> void;
+
+  /** Keep casters that did not move for a while in a static layer per
+   * cascade, rendered again only when the cascade moves a few texels, and
+   * draw the others over it each frame. Otherwise all casters are drawn
+   * every frame. On by default. */
+  auto cached_shadows(bool enabled) -> void;
+
+  /** Blur bloom and shadow maps with one compute dispatch each, through
+   * shared memory, instead of a fragment pass per iteration. On by
+   * default. */
+  auto blur_compute(bool enabled) -> void;
+
+  /** Environment probe faces to render per frame, shared by all probes.
+   * Probes that did not change are not rendered again. Two by default. */
+  auto environment_budget(int faces) -> void;
+
+  /** GGX importance samples per texel when prefiltering a completed probe.
+   * 64 by default. */
+  auto environment_samples(int samples) -> void;
+
+  /** Resident memory, evictions and state changes of the last frame. */
+  auto stats() const -> Stats;
+
   // TODO: MOVE
   static GLuint generate(const std::function<void(GLsizei, GLuint*)> & f);
   static GLuint wrap_convert(const gfx::Texture::Wrap& w);
@@ -95,51 +193,119 @@ private:
     GLenum format;
   };
 
+  /** Record the id generation a resource is loaded for.
+   * @return True if the id was loaded for another generation before. */
+  static auto recycled(std::vector<std::uint32_t> &generations,
+                       unsigned int id, std::uint32_t generation) -> bool;
+
+  /** True if the id of a resource was last loaded for another generation,
+   * so the resource outlived its source and the id is reused. */
+  static auto stale(const std::vector<std::uint32_t> &generations,
+                    const gpu::Resource &resource) -> bool;
+
+  /** Arena ranges of a mesh, loaded again if evicted, or nullptr. */
+  auto mesh(const gpu::Mesh &mesh) -> const Mesh_arena::Allocation *;
+
+  /** Texture name, loaded again if evicted, or fallback. */
+  auto texture(const gpu::Texture_2D &texture, GLuint fallback) -> GLuint;
+
+  /** Unload least recently used resources over the budget. */
+  auto evict() -> void;
+
+  /** Flatten the models of all scenes and cull them against every view of
+   * the frame. */
+  auto cull(const gfx::Scenes &scenes) -> void;
+
+  /** Pick the environment probe faces to render this frame, after the
+   * scene graph update, so moved models are known. */
+  auto schedule_probes(const gfx::Scene &scene) -> void;
+
+  /** Resolve the GL state of visible models, then record the draw lists of
+   * every view in parallel. */
+  auto record(const gfx::Scenes &scenes) -> void;
+
+  /** GL state of a model, loading its resources again if evicted. */
+  auto drawable(const gpu::Model &model) -> Drawable;
+
+  /** Fit cascade light cameras to the view frustum of the camera. */
+  auto update_cascades(const gfx::Directional_light &light,
+                       const gfx::Camera &camera) -> void;
+
   auto render_texture_targets(const gfx::Scene &scene) -> void;
 
+  /** Render a scene with a recorded draw list. */
   auto render_scene(const gfx::Camera &camera,
                     const gfx::Scene &scene,
-                    const glm::ivec2 &resolution) -> void;
+                    const glm::ivec2 &resolution,
+                    const Draw_list &list) -> void;
 
-  auto render_shadow_maps(const std::vector<gpu::Model> &models,
-                          const gfx::Spot_lights &spot_lights) -> void;
+  /** Render spot lights whose view or casters changed into their tiles of
+   * the shadow atlas, sized by strength and distance to the camera. */
+  auto render_shadow_maps(const gfx::Spot_lights &spot_lights,
+                          const gfx::Camera &camera) -> void;
 
-  auto render_cascaded_shadow_maps(const std::vector<gpu::Model> &models,
-                                   const gfx::Directional_light &light,
-                                   const gfx::Camera &camera) -> void;
+  auto render_cascaded_shadow_maps() -> void;
 
   auto render_environment(const gfx::Scene &scene,
                           const glm::vec4 &clear_color) -> void;
 
+  /** Copy the complete source cube map to the first level of target, and
+   * GGX prefilter it into the others, of roughness increasing to one. */
+  auto prefilter(const Environment_map_target &source,
+                 const Environment_map_target &target) -> void;
+
   auto render_sky(const gpu::Model &model,
                   const gfx::Camera &camera,
-                  const gfx::Fog &fog,
-                    const glm::vec2 &resolution,
-                    const Standard_program& program) -> void;
+                  const Standard_program& program) -> void;
 
+  /** Draw clouds, lit by the Scene block of the last render_scene. */
   auto render_clouds(const gfx::Clouds &clouds,
-                     const gfx::Directional_light &directional_light,
-                     const gfx::Spot_lights &spot_lights,
-                     const gfx::Environment_lights &environment_lights,
-                    const mos::gfx::Camera &camera,
-                    const glm::ivec2 &resolution,
-                    const Cloud_program &program,
-                    const GLenum &draw_mode) -> void;
+                     const mos::gfx::Camera &camera,
+                     const Cloud_program &program,
+                     const GLenum &draw_mode) -> void;
+
+  /** Fill and upload the light, shadow and camera uniform blocks, if changed
+   * since the last upload. */
+  auto upload_blocks(const gfx::Camera &camera,
+                     const gfx::Scene &scene,
+                     const glm::ivec2 &resolution) -> void;
+
+  /** Add visible models with a mesh to the draw list, recursively. */
+  auto collect(const gpu::Model &model,
+               const glm::mat4 &parent_transform,
+               const gfx::Camera &camera,
+               const Program &program) -> void;
+
+  /** Write instances, materials and draw commands of a prepared draw list
+   * to the streaming ring, and bind them.
+   * @return Range of the draw commands. */
+  auto upload_draws(const Draw_list &list) -> Ring_buffer::Range;
+
+  /** Draw a prepared draw list with one multi draw per run of batches that
+   * share textures, setting only state that changes. */
+  auto submit(const Draw_list &list,
+              const gfx::Camera &camera,
+              const Standard_program &program) -> void;
+
+  /** Draw batches [begin, end) of a draw list written by upload_draws. */
+  auto submit(const Draw_list &list,
+              const Ring_buffer::Range &commands,
+              std::size_t begin, std::size_t end,
+              const gfx::Camera &camera,
+              const Standard_program &program) -> void;
+
+  /** Draw a prepared depth pass draw list with multi draws. */
+  auto submit_depth(const Draw_list &list,
+                    const gfx::Camera &camera,
+                    const Depth_program &program) -> void;
 
-  auto render_model(const gpu::Model &model,
-                    const glm::mat4 &transform,
+  /** Draw batches [begin, end) of a draw list written by upload_draws, to
+   * depth only. */
+  auto submit_depth(const Draw_list &list,
+                    const Ring_buffer::Range &commands,
+                    std::size_t begin, std::size_t end,
                     const gfx::Camera &camera,
-                    const gfx::Spot_lights &spot_lights,
-                    const gfx::Environment_lights &environment_lights,
-                    const gfx::Fog &fog,
-                    const glm::vec2 &resolution,
-                    const Standard_program& program) -> void;
-
-  auto render_model_depth(const gpu::Model &model,
-                          const glm::mat4 &transform,
-                          const gfx::Camera &camera,
-                          const glm::vec2 &resolution,
-                          const Depth_program& program) -> void;
+                    const Depth_program &program) -> void;
 
   /** Clear color and depth. */
   auto clear(const glm::vec4 &color) -> void;
@@ -149,6 +315,22 @@ private:
             const Post_target &buffer_target,
             const Post_target &output_target,
             float iterations = 6) -> void;
+  /** Blur a rectangle of a texture into an image with one compute
+   * dispatch, as iterations of the fragment blur would.
+   * @param source Offset and size of the rectangle, in texels.
+   * @param moments Read depth and blur its moments. */
+  auto dispatch_blur(GLuint input_texture, GLuint output_texture,
+                     const glm::ivec4 &source,
+                     const glm::ivec2 &destination, int iterations,
+                     bool moments = false) -> void;
+  /** Blur a rendered tile of the shadow atlas. Iterations should be even. */
+  auto blur_shadow_tile(const Shadow_atlas::Tile &tile,
+                        int iterations) -> void;
+  /** Blur a cascade shadow map into the texture that is sampled. */
+  auto blur_shadow_map(GLuint input_texture, const Post_target &output_target,
+                       int iterations) -> void;
+  /** Intermediate of fragment blurs of shadow maps, created on first use. */
+  auto shadow_map_blur_target() -> const Post_target &;
 
   const bool context_;
 
@@ -160,13 +342,84 @@ private:
   const Bloom_program bloom_program_;
   const Compositing_program compositing_program_;
   const Blur_program blur_program_;
+  const Blur_compute_program blur_compute_program_;
+  const Prefilter_program prefilter_program_;
 
   Frame_buffers frame_buffers_;
   Render_buffers render_buffers_;
   Texture_buffers textures_;
-  Array_buffers array_buffers_;
-  Element_array_buffers element_array_buffers_;
-  Vertex_arrays vertex_arrays_;
+
+  /** Generations, indexed by id, that textures, meshes and targets were
+   * loaded for. */
+  std::vector<std::uint32_t> texture_generations_;
+  std::vector<std::uint32_t> shape_generations_;
+  std::vector<std::uint32_t> target_generations_;
+
+  /** Shared resources, to load again after eviction. */
+  Slot_map<std::weak_ptr<gfx::Mesh>> mesh_sources_;
+  Slot_map<std::weak_ptr<gfx::Texture_2D>> texture_sources_;
+  /** Texture attached to each target frame buffer, pinned as resident. */
+  Slot_map<unsigned int> target_textures_;
+  Residency residency_;
+
+  /** A model of the frame's scenes, its world data is kept by graph_. */
+  struct Node {
+    const gpu::Model *model;
+    gfx::Scene_graph::Index parent;
+  };
+
+  /** Culling views of the frame, also indices of the recorded lists. */
+  struct Views {
+    std::vector<gfx::Culling::Index> cameras;
+    std::array<gfx::Culling::Index, 4> spot_lights{};
+    std::array<gfx::Culling::Index, 4> cascades{};
+    /** One per scheduled environment probe face. */
+    std::vector<gfx::Culling::Index> environments;
+    std::vector<gfx::Culling::Index> texture_targets;
+    /** Lists of the dynamic cascade layers, recorded after the views. */
+    std::array<std::size_t, 4> dynamic_cascades{};
+  };
+
+  /** Models of all scenes, flattened once per frame and indexed as graph_
+   * nodes and culling_ spheres. Each scene owns a contiguous range. */
+  std::vector<Node> nodes_;
+  std::vector<std::pair<std::size_t, std::size_t>> scene_nodes_;
+  /** Kept between frames, so only moved models are computed again. */
+  gfx::Scene_graph graph_;
+  gfx::Culling culling_;
+  Views views_;
+
+  /** Records one draw list per culling view, on the process wide pool. */
+  Thread_pool &pool_{Thread_pool::shared()};
+  Command_recorder recorder_;
+  std::vector<Command_recorder::Pass> passes_;
+  /** GL state per node, resolved for nodes visible from any view. */
+  std::vector<Drawable> drawables_;
+  /** Nodes drawn per cascade, those within an earlier cascade left out. */
+  std::vector<gfx::Culling::Word> cascade_visibility_;
+
+  Draw_list draw_list_;
+  Draw_list::Stats draw_stats_;
+  bool depth_prepass_{false};
+  bool front_to_back_{false};
+  bool overdraw_{false};
+  bool cached_shadows_{true};
+  bool blur_compute_{true};
+  Time_queries blur_times_;
+  /** Per frame data: instances, cloud points and dynamic mesh uploads. */
+  Ring_buffer stream_buffer_;
+  GLint storage_alignment_{16};
+  const Vertex_array cloud_vertex_array_;
+  /** Vertices and indices of all meshes, drawn with one vertex array. */
+  Mesh_arena arena_;
+
+  /** Uniform blocks as last uploaded, and their buffers. */
+  Scene_block scene_block_;
+  Shadows_block shadows_block_;
+  View_block view_block_;
+  Buffer scene_buffer_;
+  Buffer shadows_buffer_;
+  Buffer view_buffer_;
 
   const Standard_target standard_target_;
   const Blit_target multisample_target_;
@@ -177,20 +430,32 @@ private:
 
   const Texture_buffer_2D black_texture_;
   const Texture_buffer_2D white_texture_;
+  /** Split sum lookup table, computed on the CPU at startup. */
+  static constexpr int brdf_lut_size{128};
   const Texture_buffer_2D brdf_lut_texture_;
 
-  std::array<int,2> cube_camera_index_;
-
   /** Shadow maps. */
   const Render_buffer shadow_maps_render_buffer_;
-  const std::array<Shadow_map_target, 4> shadow_maps_;
-  const Post_target shadow_map_blur_target_;
-  //TODO: blur directly into the shadowmaps, to save memory.
-  const std::array<Post_target, 4> shadow_map_blur_targets_;
+  std::unique_ptr<const Post_target> shadow_map_blur_target_;
+  /** Spot light shadow maps, tiles of one texture twice the side of the
+   * cascades, so the largest tile fits in the blur target. */
+  Shadow_atlas shadow_atlas_;
+  const Shadow_atlas_target shadow_atlas_target_;
+
+  /** Cube maps of an environment probe. Faces are rendered into back, which
+   * once all six are rendered is prefiltered into the sampled front. */
+  struct Probe_targets {
+    std::unique_ptr<const Environment_map_target> front;
+    std::unique_ptr<const Environment_map_target> back;
+  };
 
-  /** Environment map targets. */
+  /** Environment probes, one per scene environment light. */
+  Probe_scheduler probe_scheduler_;
+  /** Newest mesh upload generation seen by the last probe schedule. */
+  Mesh_arena::Generation probe_generation_{0};
   const Render_buffer environment_render_buffer_;
-  const std::array<Environment_map_target, 2> environment_maps_targets_;
+  std::vector<Probe_targets> probe_targets_;
+  int environment_samples_{64};
 
   static constexpr const int cascade_count{4};
   //TODO: return all theese from the render method
@@ -198,9 +463,28 @@ private:
   //TODO: Blur directly into the cascaded shadowmaps to save memory.
   const std::array<Post_target, 4> cascaded_shadow_map_blur_targets_;
 
+  /** Updates a node stays still before it is drawn in the static layers. */
+  static constexpr std::uint32_t static_age{60};
+  /** Texels a cascade may lag behind the camera, before it moves and its
+   * static layer is rendered again. */
+  static constexpr float cascade_texel_threshold{8.0F};
+  /** Static cascade layers, with their own depth to composite over. */
+  const std::array<Render_buffer, cascade_count> static_cascade_depths_;
+  const std::array<Shadow_map_target, cascade_count> static_cascade_maps_;
+  /** Hash of what each static layer was rendered with. */
+  std::array<std::uint64_t, cascade_count> static_cascade_states_{};
+  std::array<bool, cascade_count> static_cascade_valid_{};
+  /** Cascades that had a dynamic layer in the last frame. */
+  std::array<bool, cascade_count> cascade_dynamic_{};
+  std::array<glm::vec3, cascade_count> cascade_centers_{};
+  glm::vec3 cascade_direction_{0.0F};
+  Cascade_stats cascade_stats_;
+
   glm::vec4 cascade_splits{}; //TODO: Generalize number of splits
   std::array<glm::mat4, cascade_count> directional_light_ortho_matrices{};
   std::array<glm::mat4, cascade_count> light_view_matrix{};
+  std::array<gfx::Camera, cascade_count> cascade_cameras_{};
+  std::array<float, cascade_count> cascade_radii_{};
 
 };
 }
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+#include <vector>
+
+#include <mos/core/slot_map.hpp>
+
+namespace mos::gl {
+
+/** Estimated GPU memory of loaded resources, kept in least recently used
+ * order, and which of them to evict when over budget. */
+class Residency final {
+public:
+  enum class Kind { Texture, Mesh };
+
+  struct Key {
+    Kind kind;
+    unsigned int id;
+    auto operator==(const Key &key) const -> bool = default;
+  };
+
+  struct Stats {
+    std::size_t budget{0};
+    std::size_t resident_bytes{0};
+    int resident{0};
+    /** Resources evicted during the last frame. */
+    int evictions{0};
+    std::size_t evicted_bytes{0};
+    /** Evicted resources loaded again during the last frame. */
+    int reloads{0};
+  };
+
+  explicit Residency(
+      std::size_t budget = std::numeric_limits<std::size_t>::max());
+
+  /** Bytes of resident resources to aim for. */
+  auto budget(std::size_t bytes) -> void;
+
+  /** Start a frame, resources used from now on are not evicted until the
+   * next frame. */
+  auto begin_frame() -> void;
+
+  /** Track a loaded resource or update its size, and mark it as used. */
+  auto add(const Key &key, std::size_t bytes) -> void;
+
+  /** Mark a resident resource as used this frame. */
+  auto use(const Key &key) -> void;
+
+  /** Stop tracking an unloaded resource. */
+  auto remove(const Key &key) -> void;
+
+  auto resident(const Key &key) const -> bool;
+
+  /** True if the resource was evicted and not loaded since. */
+  auto evicted(const Key &key) const -> bool;
+
+  /** Pinned resources are never evicted, pins are counted. */
+  auto pin(const Key &key) -> void;
+  auto unpin(const Key &key) -> void;
+
+  /** Least recently used resources to unload until within budget. Resources
+   * used this frame, pinned, or rejected by evictable are kept.
+   * @return Evicted resources, no longer resident. */
+  auto evict(const std::function<bool(const Key &)> &evictable)
+      -> std::vector<Key>;
+
+  /** Stop tracking everything, including pins. */
+  auto clear() -> void;
+
+  auto stats() const -> Stats;
+
+private:
+  struct Entry {
+    std::size_t bytes{0};
+    std::uint64_t frame{0};
+    bool resident{false};
+    std::list<Key>::iterator position;
+  };
+
+  auto entries(Kind kind) -> Slot_map<Entry> &;
+  auto entries(Kind kind) const -> const Slot_map<Entry> &;
+
+  std::array<Slot_map<Entry>, 2> entries_;
+  std::array<Slot_map<int>, 2> pins_;
+
+  /** Resident resources, least recently used first. */
+  std::list<Key> order_;
+
+  /** Starts at one, entries that were never resident have frame zero. */
+  std::uint64_t frame_{1};
+  Stats stats_;
+};
+
+} // namespace mos::gl
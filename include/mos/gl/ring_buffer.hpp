@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace mos::gl {
+
+/** Per frame streaming memory, one region per frame in flight, mapped
+ * persistently with buffer storage. The renderer requires GL 4.5, which
+ * always has buffer storage, so writing with glBufferSubData instead is a
+ * path forced on 4.5 contexts, to test and compare streaming without a
+ * mapping. A region is reused only after the fence placed at the end of
+ * its frame has signaled. */
+class Ring_buffer final {
+  friend class Renderer;
+public:
+  static constexpr int frames = 3;
+
+  /** Written bytes, in a buffer that stays valid until the frame ends. */
+  struct Range {
+    GLuint buffer{0};
+    GLintptr offset{0};
+    GLsizeiptr size{0};
+  };
+
+  struct Stats {
+    std::size_t written_bytes{0};
+    /** Writes that waited for the GPU to release a region. */
+    int stalls{0};
+    /** Reallocations to fit a frame's writes. */
+    int grows{0};
+  };
+
+private:
+  /** @param region_size Initial bytes per frame, grown when outgrown.
+   * @param persistent Use a persistent mapping if the context supports it. */
+  explicit Ring_buffer(GLsizeiptr region_size, bool persistent = true);
+
+public:
+  ~Ring_buffer();
+  Ring_buffer(const Ring_buffer &buffer) = delete;
+  Ring_buffer(Ring_buffer &&buffer) = delete;
+  Ring_buffer &operator=(const Ring_buffer &buffer) = delete;
+  Ring_buffer &operator=(Ring_buffer &&buffer) = delete;
+
+  /** Copy data into this frame's region, aligned to alignment bytes. */
+  auto write(const void *data, GLsizeiptr size, GLsizeiptr alignment = 16)
+      -> Range;
+
+  /** Copy a written range into another buffer, at offset bytes. */
+  static auto copy(const Range &range, GLuint buffer, GLintptr offset)
+      -> void;
+
+  /** Fence this frame's writes and move on to the next region. */
+  auto end_frame() -> void;
+
+  auto persistent() const -> bool;
+
+  /** True if the context has buffer storage for persistent mappings. */
+  static auto storage_supported() -> bool;
+
+  /** Counters of the last ended frame. */
+  auto stats() const -> Stats;
+
+  GLuint id{0};
+
+private:
+  auto allocate(GLsizeiptr region_size) -> void;
+  /** Wait for the GPU to finish with the current region. */
+  auto acquire() -> void;
+  void release();
+
+  const bool persistent_;
+  GLsizeiptr region_size_{0};
+  std::byte *mapped_{nullptr};
+  int region_{0};
+  GLsizeiptr offset_{0};
+  bool acquired_{false};
+  std::array<GLsync, frames> fences_{};
+  /** Outgrown buffers, deleted once the fence of their last frame signals. */
+  std::vector<std::pair<GLuint, GLsync>> retired_;
+  Stats stats_;
+  Stats frame_stats_;
+};
+}
@@ -13,6 +13,8 @@ class Shader {
   friend class Compositing_program;
   friend class Depth_program;
   friend class Blur_program;
+  friend class Blur_compute_program;
+  friend class Prefilter_program;
   friend class Standard_program;
 private:
   Shader(const std::string &source, GLuint type, const std::string &name);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mos::gl {
+
+/** Square tiles of one shadow map texture, one per light, sized by the
+ * importance of the light. Tracks what each tile was last rendered with, so
+ * lights whose view and casters did not change are not rendered again. */
+class Shadow_atlas final {
+public:
+  struct Tile {
+    glm::ivec2 offset{0};
+    /** Side in texels, zero if the light has no tile. */
+    int size{0};
+    auto operator==(const Tile &tile) const -> bool = default;
+  };
+
+  struct Stats {
+    int tiles{0};
+    /** Lights rendered and skipped since the last allocate. */
+    int rendered{0};
+    int skipped{0};
+    std::size_t texels{0};
+    std::size_t used_texels{0};
+  };
+
+  /** @param resolution Side of the atlas, a power of two.
+   * @param min_tile Side of the smallest tile, a power of two. */
+  Shadow_atlas(int resolution, int min_tile);
+
+  /** Assign tiles to lights, once per frame. The most important light gets
+   * half the atlas side, a light a quarter as important half of that, and
+   * lights of zero importance no tile. Tiles shrink until all fit. */
+  auto allocate(std::span<const float> importance) -> void;
+
+  auto tile(std::size_t light) const -> Tile;
+
+  /** Map shadow map coordinates in [0, 1] to the tile of a light. */
+  auto transform(std::size_t light) const -> glm::mat4;
+
+  /** Compare the state a light would be rendered with, such as a hash of
+   * its view and draws, to the one it was last rendered with.
+   * @return True if the light must be rendered, then state is kept. */
+  auto update(std::size_t light, std::uint64_t state) -> bool;
+
+  auto resolution() const -> int;
+
+  auto stats() const -> Stats;
+
+private:
+  struct Entry {
+    Tile tile;
+    /** State of the last render, valid while the tile stays in place. */
+    std::uint64_t rendered_state{0};
+    bool valid{false};
+  };
+
+  int resolution_;
+  int min_tile_;
+  std::vector<Entry> entries_;
+  Stats stats_;
+};
+
+} // namespace mos::gl
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace mos::gl {
+
+/** Shadow atlas texture of blurred depth moments, and a frame buffer that
+ * renders tiles to it with a depth texture, read by the compute blur. */
+class Shadow_atlas_target {
+  friend class Renderer;
+private:
+  explicit Shadow_atlas_target(int resolution);
+public:
+  ~Shadow_atlas_target();
+  Shadow_atlas_target(const Shadow_atlas_target &target) = delete;
+  Shadow_atlas_target(Shadow_atlas_target &&target) = delete;
+  Shadow_atlas_target &operator=(const Shadow_atlas_target &target) = delete;
+  Shadow_atlas_target &operator=(Shadow_atlas_target &&target) = delete;
+  const GLuint frame_buffer{};
+  const GLuint texture{};
+  const GLuint depth_texture{};
+  const int resolution;
+};
+}
@@ -10,6 +10,7 @@ namespace mos::gl {
 class Standard_program : public Program {
   friend class Renderer;
 public:
+  /** Material values are read from the material buffer, by instance. */
   struct Material_uniforms {
     GLint albedo_sampler;
     GLint normal_sampler;
@@ -17,77 +18,21 @@ public:
     GLint roughness_sampler;
     GLint emission_sampler;
     GLint ambient_occlusion_sampler;
-    GLint albedo;
-    GLint roughness;
-    GLint metallic;
-    GLint index_of_refraction;
-    GLint alpha;
-    GLint transmission;
-    GLint emission;
-    GLint ambient_occlusion;
   };
 
-  struct Environment_uniforms {
-    GLint sampler;
-    GLint position;
-    GLint extent;
-    GLint strength;
-    GLint falloff;
-  };
-
-  struct Light_uniforms {
-    GLint position;
-    GLint color;
-    GLint strength;
-    GLint view;
-    GLint projection;
-    GLint angle;
-    GLint direction;
-    GLint blend;
-  };
-
-  struct Directional_light_uniforms {
-    GLint position;
-    GLint direction;
-    GLint color;
-    GLint strength;
-  };
-
-  struct Camera_uniforms {
-    GLuint resolution;
-    GLuint position;
-  };
-
-  struct Fog_uniforms {
-    GLint color_near;
-    GLint color_far;
-    GLint attenuation_factor;
-    GLint min;
-    GLint max;
-  };
 private:
   explicit Standard_program(const Shader &functions_shader);
 
 public:
-  GLint model_view_projection;
-  GLint model_matrix;
-  GLint normal_matrix;
+  GLint view_projection;
 
   Material_uniforms material{};
-  Fog_uniforms fog{};
-  Camera_uniforms camera{};
-
-  std::array<Environment_uniforms, 2> environment_maps{};
-
-  std::array<GLuint, 4> shadow_samplers{};
-  std::array<Light_uniforms, 4> spot_lights{};
-  std::array<GLint, 4> depth_bias_mvps{};
 
-  Directional_light_uniforms directional_light{};
-  std::array<GLuint, 4> cascaded_shadow_samplers{};
-  std::array<GLint, 4> cascaded_depth_bias_mvps{};
-  GLint cascade_splits;
+  std::array<GLint, 2> environment_samplers{};
+  GLint shadow_atlas_sampler{};
+  std::array<GLint, 4> cascaded_shadow_samplers{};
 
   GLint brdf_lut_sampler;
+  GLint overdraw;
 };
 }
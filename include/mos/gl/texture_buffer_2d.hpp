@@ -16,6 +16,7 @@ private:
   Texture_buffer_2D(
       GLint internal_format, GLenum external_format, int width, int height,
       GLint filter_min, GLint filter_mag, GLint wrap, const void *data,
+      GLenum type = GL_UNSIGNED_BYTE,
       const Time_point &modified = std::chrono::system_clock::now());
 public:
   ~Texture_buffer_2D();
@@ -27,6 +28,9 @@ public:
   Time_point modified;
 
 private:
+  /** Upload all levels of the texture, generating mipmaps on the GPU if it
+   * has a single uncompressed level. */
+  void upload(const gfx::Texture_2D &texture_2d);
   void release();
 };
 }
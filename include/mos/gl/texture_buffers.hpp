@@ -1,9 +1,10 @@
 #pragma once
 
+#include <mos/core/slot_map.hpp>
 #include <mos/gl/texture_buffer_2d.hpp>
 
 namespace mos::gl {
 
-using Texture_buffers = std::unordered_map<unsigned int, Texture_buffer_2D>;
+using Texture_buffers = Slot_map<Texture_buffer_2D>;
 
 }
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace mos::gl {
+
+/** GPU time of sections of a frame, from GL_TIME_ELAPSED queries that are
+ * read back frames later, so reading never stalls. */
+class Time_queries final {
+  friend class Renderer;
+private:
+  Time_queries() = default;
+public:
+  ~Time_queries();
+  Time_queries(const Time_queries &queries) = delete;
+  Time_queries(Time_queries &&queries) = delete;
+  Time_queries &operator=(const Time_queries &queries) = delete;
+  Time_queries &operator=(Time_queries &&queries) = delete;
+
+  /** Time the GL commands until end, sections do not nest. */
+  auto begin() -> void;
+  auto end() -> void;
+
+  /** Start timing the next frame, and read back the oldest one if done. */
+  auto end_frame() -> void;
+
+  /** Summed time of the last frame read back. */
+  auto milliseconds() const -> float;
+
+private:
+  struct Frame {
+    std::vector<GLuint> queries;
+    std::size_t used{0};
+  };
+  std::array<Frame, 3> frames_;
+  std::size_t frame_{0};
+  float milliseconds_{0.0f};
+};
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+namespace mos::gl {
+
+/** Per scene light and fog data, std140 layout of the Scene uniform block
+ * in the standard and cloud shaders. */
+struct Scene_block {
+  static constexpr unsigned int binding = 1;
+
+  struct Spot_light {
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::vec3 position{0.0f};
+    float strength{0.0f};
+    glm::vec3 color{0.0f};
+    float angle{0.0f};
+    glm::vec3 direction{0.0f};
+    float blend{0.0f};
+    auto operator==(const Spot_light &light) const -> bool = default;
+  };
+
+  struct Directional_light {
+    glm::vec3 position{0.0f};
+    float strength{0.0f};
+    glm::vec3 direction{0.0f};
+    float padding0{0.0f};
+    glm::vec3 color{0.0f};
+    float padding1{0.0f};
+    auto operator==(const Directional_light &light) const -> bool = default;
+  };
+
+  struct Environment {
+    glm::vec3 position{0.0f};
+    float strength{0.0f};
+    glm::vec3 extent{0.0f};
+    float falloff{0.0f};
+    auto operator==(const Environment &environment) const -> bool = default;
+  };
+
+  struct Fog {
+    glm::vec3 color_near{0.0f};
+    float attenuation_factor{0.0f};
+    glm::vec3 color_far{0.0f};
+    float min{0.0f};
+    float max{0.0f};
+    std::array<float, 3> padding{};
+    auto operator==(const Fog &fog) const -> bool = default;
+  };
+
+  std::array<Spot_light, 4> spot_lights{};
+  Directional_light directional_light{};
+  std::array<Environment, 2> environments{};
+  Fog fog{};
+  glm::vec4 cascade_splits{0.0f};
+
+  auto operator==(const Scene_block &block) const -> bool = default;
+};
+
+/** Light space matrices for shadow lookups, std140 layout of the Shadows
+ * uniform block in the standard vertex shader. */
+struct Shadows_block {
+  static constexpr unsigned int binding = 2;
+
+  std::array<glm::mat4, 4> depth_bias_view_projections{};
+  std::array<glm::mat4, 4> cascaded_depth_bias_view_projections{};
+
+  auto operator==(const Shadows_block &block) const -> bool = default;
+};
+
+/** Per view camera data, std140 layout of the View uniform block. */
+struct View_block {
+  static constexpr unsigned int binding = 3;
+
+  glm::vec3 position{0.0f};
+  float padding0{0.0f};
+  glm::ivec2 resolution{0};
+  glm::ivec2 padding1{0};
+
+  auto operator==(const View_block &block) const -> bool = default;
+};
+
+static_assert(sizeof(Scene_block::Spot_light) == 176);
+static_assert(sizeof(Scene_block::Directional_light) == 48);
+static_assert(sizeof(Scene_block::Environment) == 32);
+static_assert(sizeof(Scene_block::Fog) == 48);
+static_assert(offsetof(Scene_block, directional_light) == 704);
+static_assert(offsetof(Scene_block, environments) == 752);
+static_assert(offsetof(Scene_block, fog) == 816);
+static_assert(offsetof(Scene_block, cascade_splits) == 864);
+static_assert(sizeof(Scene_block) == 880);
+static_assert(sizeof(Shadows_block) == 512);
+static_assert(sizeof(View_block) == 32);
+
+} // namespace mos::gl
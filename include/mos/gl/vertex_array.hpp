@@ -1,21 +1,17 @@
 #pragma once
 
 #include <mos/gfx/cloud.hpp>
-#include <mos/gfx/mesh.hpp>
 
-#include <mos/gl/buffer.hpp>
+#include <mos/gl/ring_buffer.hpp>
 
 namespace mos::gl {
 
 class Vertex_array {
   friend class Renderer;
 private:
-  explicit Vertex_array(
-      const gfx::Cloud &cloud,
-      std::unordered_map<unsigned int, Buffer> &array_buffers);
-  explicit Vertex_array(
-      const gfx::Mesh &mesh, std::unordered_map<unsigned int, Buffer> &array_buffers,
-      std::unordered_map<unsigned int, Buffer> &element_array_buffers);
+  /** Cloud points streamed through the ring buffer. The range of each cloud
+   * is bound to binding 0 with glBindVertexBuffer before drawing. */
+  explicit Vertex_array(const Ring_buffer &ring_buffer);
 public:
   ~Vertex_array();
   Vertex_array(Vertex_array &&array) noexcept;
@@ -1,9 +0,0 @@
-#pragma once
-
-#include <mos/gl/vertex_array.hpp>
-
-namespace mos::gl {
-
-using Vertex_arrays = std::unordered_map<unsigned int, Vertex_array>;
-
-}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mos/gfx/mesh.hpp>
+#include <mos/gfx/mesh_file.hpp>
 #include <mos/gpu/resource.hpp>
 
 namespace mos::gl {
@@ -22,6 +23,7 @@ private:
 
   Mesh(const mos::gfx::Mesh& mesh);
   Mesh(const mos::gfx::Shared_mesh &shared_mesh);
+  Mesh(const mos::gfx::Mesh_file &file);
   glm::vec3 centroid_{0.0f};
   float radius_{0.0f};
   int num_indices_{0};
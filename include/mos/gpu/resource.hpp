@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace mos::gfx {
 class Renderer;
 }
@@ -11,12 +13,16 @@ public:
   friend class mos::gfx::Renderer;
   static constexpr int invalid_id = -1;
 
-  Resource(int id = invalid_id);
+  Resource(int id = invalid_id, std::uint32_t generation = 0);
 
   auto valid() const -> bool;
 
   auto id() const -> int;
+
+  /** Generation of the id, which tells apart resources reusing it. */
+  auto generation() const -> std::uint32_t;
 private:
   int id_{invalid_id};
+  std::uint32_t generation_{0};
 };
 }
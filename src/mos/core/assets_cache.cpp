@@ -0,0 +1,72 @@
+#include <mos/core/assets_cache.hpp>
+#include <mos/core/mapped_file.hpp>
+#include <cstdio>
+#include <thread>
+
+namespace mos {
+
+namespace {
+/** Part of every cached file name, increase when the cached layout changes. */
+constexpr int version = 1;
+} // namespace
+
+Assets_cache::Assets_cache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {}
+
+auto Assets_cache::hash(const std::filesystem::path &path) -> std::uint64_t {
+  const Mapped_file file(path);
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (std::size_t i = 0; i < file.size(); i++) {
+    hash ^= std::uint64_t(file.data()[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+auto Assets_cache::path(const std::filesystem::path &source,
+                        const std::string &variant) const
+    -> std::filesystem::path {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx-%d-",
+                static_cast<unsigned long long>(hash(source)), version);
+  return directory_ / (name + variant);
+}
+
+auto Assets_cache::store(
+    const std::filesystem::path &path,
+    const std::function<void(const std::filesystem::path &)> &write) const
+    -> bool {
+  // Unique per thread, so concurrent stores of the same content do not clash.
+  const auto temporary = path.string() + "." +
+                         std::to_string(std::hash<std::thread::id>{}(
+                             std::this_thread::get_id())) +
+                         ".tmp" + path.extension().string();
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  if (error) {
+    return false;
+  }
+  try {
+    write(temporary);
+  } catch (const std::exception &) {
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  return true;
+}
+
+auto Assets_cache::clear() const -> void {
+  std::error_code error;
+  std::filesystem::remove_all(directory_, error);
+}
+
+auto Assets_cache::directory() const -> std::filesystem::path {
+  return directory_;
+}
+
+} // namespace mos
@@ -0,0 +1,119 @@
+#include <mos/core/handle_allocator.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace mos {
+
+namespace {
+
+auto pack(const std::uint32_t tag, const std::uint32_t index)
+    -> std::uint64_t {
+  return std::uint64_t(tag) << 32 | index;
+}
+
+auto index_of(const std::uint64_t head) -> std::uint32_t {
+  return std::uint32_t(head);
+}
+
+auto tag_of(const std::uint64_t head) -> std::uint32_t {
+  return std::uint32_t(head >> 32);
+}
+
+} // namespace
+
+Handle_allocator::Handle_allocator() : free_(pack(0, Handle::invalid_index)) {}
+
+Handle_allocator::~Handle_allocator() {
+  for (auto &block : blocks_) {
+    delete[] block.load(std::memory_order_relaxed);
+  }
+}
+
+auto Handle_allocator::slot(const std::uint32_t index) const -> Slot & {
+  return blocks_[index / block_size].load(
+      std::memory_order_acquire)[index % block_size];
+}
+
+auto Handle_allocator::create() -> Handle {
+  size_.fetch_add(1, std::memory_order_relaxed);
+
+  auto head = free_.load(std::memory_order_acquire);
+  while (index_of(head) != Handle::invalid_index) {
+    // Slots are never freed, so reading next of a slot another thread just
+    // popped is safe, the tag makes the exchange fail in that case.
+    auto &free = slot(index_of(head));
+    const auto next = free.next.load(std::memory_order_relaxed);
+    if (free_.compare_exchange_weak(head, pack(tag_of(head) + 1, next),
+                                    std::memory_order_acquire,
+                                    std::memory_order_acquire)) {
+      free.references.store(1, std::memory_order_relaxed);
+      return Handle{index_of(head),
+                    free.generation.load(std::memory_order_relaxed)};
+    }
+  }
+
+  const auto index = capacity_.fetch_add(1, std::memory_order_relaxed);
+  if (index >= block_size * max_blocks) {
+    capacity_.fetch_sub(1, std::memory_order_relaxed);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    throw std::runtime_error("Out of handles.");
+  }
+  auto &block = blocks_[index / block_size];
+  if (!block.load(std::memory_order_acquire)) {
+    auto *slots = new Slot[block_size];
+    Slot *expected = nullptr;
+    if (!block.compare_exchange_strong(expected, slots,
+                                       std::memory_order_acq_rel)) {
+      delete[] slots;
+    }
+  }
+  auto &created = slot(index);
+  created.references.store(1, std::memory_order_relaxed);
+  return Handle{index, created.generation.load(std::memory_order_relaxed)};
+}
+
+auto Handle_allocator::retain(const Handle &handle) -> void {
+  if (handle.valid()) {
+    slot(handle.index).references.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+auto Handle_allocator::release(const Handle &handle) -> bool {
+  if (!handle.valid()) {
+    return false;
+  }
+  auto &released = slot(handle.index);
+  if (released.references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return false;
+  }
+  released.generation.fetch_add(1, std::memory_order_relaxed);
+  auto head = free_.load(std::memory_order_relaxed);
+  do {
+    released.next.store(index_of(head), std::memory_order_relaxed);
+  } while (!free_.compare_exchange_weak(head,
+                                        pack(tag_of(head) + 1, handle.index),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+  size_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+auto Handle_allocator::alive(const Handle &handle) const -> bool {
+  if (!handle.valid() || handle.index >= capacity()) {
+    return false;
+  }
+  const auto &s = slot(handle.index);
+  return s.generation.load(std::memory_order_acquire) == handle.generation &&
+         s.references.load(std::memory_order_acquire) > 0;
+}
+
+auto Handle_allocator::size() const -> std::uint32_t {
+  return size_.load(std::memory_order_relaxed);
+}
+
+auto Handle_allocator::capacity() const -> std::uint32_t {
+  return std::min(capacity_.load(std::memory_order_relaxed),
+                  block_size * max_blocks);
+}
+
+} // namespace mos
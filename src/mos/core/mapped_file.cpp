@@ -0,0 +1,136 @@
+#include <mos/core/mapped_file.hpp>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mos {
+
+#ifdef _WIN32
+
+Mapped_file::Mapped_file(const std::filesystem::path &path) {
+  file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    file_ = nullptr;
+    throw std::runtime_error(path.string() + " does not exist.");
+  }
+  LARGE_INTEGER size{};
+  GetFileSizeEx(file_, &size);
+  size_ = static_cast<std::size_t>(size.QuadPart);
+  if (size_ > 0) {
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr) {
+      release();
+      throw std::runtime_error("Could not map " + path.string() + ".");
+    }
+    data_ = static_cast<const std::byte *>(
+        MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+      release();
+      throw std::runtime_error("Could not map " + path.string() + ".");
+    }
+  }
+}
+
+void Mapped_file::release() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+  }
+  if (file_ != nullptr) {
+    CloseHandle(file_);
+  }
+  data_ = nullptr;
+  mapping_ = nullptr;
+  file_ = nullptr;
+  size_ = 0;
+}
+
+Mapped_file::Mapped_file(Mapped_file &&file) noexcept
+    : data_(file.data_), size_(file.size_), file_(file.file_),
+      mapping_(file.mapping_) {
+  file.data_ = nullptr;
+  file.size_ = 0;
+  file.file_ = nullptr;
+  file.mapping_ = nullptr;
+}
+
+auto Mapped_file::operator=(Mapped_file &&file) noexcept -> Mapped_file & {
+  if (this != &file) {
+    release();
+    std::swap(data_, file.data_);
+    std::swap(size_, file.size_);
+    std::swap(file_, file.file_);
+    std::swap(mapping_, file.mapping_);
+  }
+  return *this;
+}
+
+#else
+
+Mapped_file::Mapped_file(const std::filesystem::path &path) {
+  const int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor == -1) {
+    throw std::runtime_error(path.string() + " does not exist.");
+  }
+  struct stat status {};
+  if (fstat(descriptor, &status) == -1) {
+    close(descriptor);
+    throw std::runtime_error("Could not stat " + path.string() + ".");
+  }
+  size_ = static_cast<std::size_t>(status.st_size);
+  if (size_ > 0) {
+    void *address =
+        mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (address == MAP_FAILED) {
+      close(descriptor);
+      throw std::runtime_error("Could not map " + path.string() + ".");
+    }
+    data_ = static_cast<const std::byte *>(address);
+  }
+  // The mapping keeps its own reference to the file.
+  close(descriptor);
+}
+
+void Mapped_file::release() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::byte *>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+Mapped_file::Mapped_file(Mapped_file &&file) noexcept
+    : data_(file.data_), size_(file.size_) {
+  file.data_ = nullptr;
+  file.size_ = 0;
+}
+
+auto Mapped_file::operator=(Mapped_file &&file) noexcept -> Mapped_file & {
+  if (this != &file) {
+    release();
+    std::swap(data_, file.data_);
+    std::swap(size_, file.size_);
+  }
+  return *this;
+}
+
+#endif
+
+Mapped_file::~Mapped_file() { release(); }
+
+auto Mapped_file::data() const -> const std::byte * { return data_; }
+
+auto Mapped_file::size() const -> std::size_t { return size_; }
+
+} // namespace mos
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <stdexcept>
+#include <mos/core/range_allocator.hpp>
+
+namespace mos {
+
+auto Range_allocator::Stats::fragmentation() const -> float {
+  const auto free = capacity - used;
+  return free == 0 ? 0.0f : 1.0f - float(largest_free) / float(free);
+}
+
+Range_allocator::Range_allocator(const Offset capacity) { grow(capacity); }
+
+auto Range_allocator::allocate(const Offset size) -> std::optional<Offset> {
+  if (size == 0) {
+    return Offset(0);
+  }
+  for (auto it = free_.begin(); it != free_.end(); it++) {
+    const auto [offset, free_size] = *it;
+    if (free_size >= size) {
+      free_.erase(it);
+      if (free_size > size) {
+        free_.emplace(offset + size, free_size - size);
+      }
+      used_ += size;
+      ranges_++;
+      return offset;
+    }
+  }
+  return std::nullopt;
+}
+
+auto Range_allocator::free(Offset offset, Offset size) -> void {
+  if (size == 0) {
+    return;
+  }
+  if (offset + size > capacity_ || size > used_) {
+    throw std::runtime_error("Range freed outside of the allocated space.");
+  }
+  used_ -= size;
+  ranges_--;
+  auto next = free_.lower_bound(offset);
+  if (next != free_.begin()) {
+    const auto previous = std::prev(next);
+    if (previous->first + previous->second == offset) {
+      offset = previous->first;
+      size += previous->second;
+      free_.erase(previous);
+    }
+  }
+  if (next != free_.end() && offset + size == next->first) {
+    size += next->second;
+    free_.erase(next);
+  }
+  free_.emplace(offset, size);
+}
+
+auto Range_allocator::grow(const Offset capacity) -> void {
+  if (capacity <= capacity_) {
+    return;
+  }
+  auto offset = capacity_;
+  auto size = capacity - capacity_;
+  if (!free_.empty()) {
+    const auto last = std::prev(free_.end());
+    if (last->first + last->second == capacity_) {
+      offset = last->first;
+      size += last->second;
+      free_.erase(last);
+    }
+  }
+  free_.emplace(offset, size);
+  capacity_ = capacity;
+}
+
+auto Range_allocator::clear() -> void {
+  free_.clear();
+  if (capacity_ > 0) {
+    free_.emplace(0, capacity_);
+  }
+  used_ = 0;
+  ranges_ = 0;
+}
+
+auto Range_allocator::compact(std::span<Range> ranges, const Offset capacity)
+    -> void {
+  std::vector<std::size_t> order(ranges.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const std::size_t a, const std::size_t b) {
+                     return ranges[a].offset < ranges[b].offset;
+                   });
+  Offset cursor = 0;
+  for (const auto i : order) {
+    ranges[i].offset = ranges[i].size == 0 ? 0 : cursor;
+    cursor += ranges[i].size;
+  }
+  if (cursor != used_) {
+    throw std::runtime_error("Compacted ranges differ from the used space.");
+  }
+  capacity_ = std::max(capacity, used_);
+  free_.clear();
+  if (capacity_ > used_) {
+    free_.emplace(used_, capacity_ - used_);
+  }
+}
+
+auto Range_allocator::shrinkable(const Offset minimum) const -> bool {
+  return capacity_ - used_ > capacity_ / 4 &&
+         std::max(used_, minimum) < capacity_;
+}
+
+auto Range_allocator::capacity() const -> Offset { return capacity_; }
+
+auto Range_allocator::stats() const -> Stats {
+  Offset largest = 0;
+  for (const auto &[offset, size] : free_) {
+    largest = std::max(largest, size);
+  }
+  return Stats{capacity_, used_, ranges_, int(free_.size()), largest};
+}
+
+} // namespace mos
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <mos/core/thread_pool.hpp>
+
+namespace mos {
+
+namespace {
+/** Pool of the worker running on this thread, if any. */
+thread_local const Thread_pool *current_pool = nullptr;
+} // namespace
+
+Thread_pool::Thread_pool(const unsigned int count) {
+  const auto num_workers = std::max(count, 1U);
+  for (unsigned int i = 0; i < num_workers; i++) {
+    workers_.emplace_back([this]() { work(); });
+  }
+}
+
+Thread_pool::~Thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+auto Thread_pool::shared() -> Thread_pool & {
+  static Thread_pool pool;
+  return pool;
+}
+
+auto Thread_pool::size() const -> std::size_t { return workers_.size(); }
+
+auto Thread_pool::worker() const -> bool { return current_pool == this; }
+
+auto Thread_pool::work() -> void {
+  current_pool = this;
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      // Queued tasks are finished before stopping, so no future is broken.
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+} // namespace mos
@@ -1,5 +1,6 @@
 #include <mos/gfx/assets.hpp>
 #include <cstring>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <glm/gtc/type_ptr.hpp>
@@ -7,19 +8,140 @@
 #include <glm/gtx/io.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <mos/util.hpp>
+#include <mos/gfx/model_description.hpp>
+#include <spdlog/spdlog.h>
 #include <iostream>
+#include <utility>
 
 namespace mos::gfx {
 using namespace nlohmann;
 
-Assets::Assets(std::string directory) : directory_(std::move(directory)) {}
+namespace {
+
+/** Decoded texture from the cache, or decode it and fill the cache. */
+auto cached_texture(const Assets_cache &cache, const std::string &path,
+                    const bool color_data, const bool mipmaps,
+                    const Texture_2D::Filter &filter,
+                    const Texture_2D::Wrap &wrap) -> Texture_2D {
+  const auto extension = std::filesystem::path(path).extension();
+  if (extension == ".ktx" || extension == ".dds") {
+    return Texture_2D::load(path, color_data, mipmaps, filter, wrap);
+  }
+  const auto cached_path = cache.path(path, std::string(color_data ? "srgb" : "linear") + (mipmaps ? "-mipmaps" : "") + ".ktx");
+  if (std::filesystem::exists(cached_path)) {
+    return Texture_2D::load(cached_path.string(), color_data, mipmaps, filter, wrap);
+  }
+  auto texture = Texture_2D::load(path, color_data, mipmaps, filter, wrap);
+  if (mipmaps) {
+    texture.build_mipmaps();
+  }
+  cache.store(cached_path, [&](const std::filesystem::path &temporary) {
+    texture.save(temporary.string());
+  });
+  return texture;
+}
+
+/** Image file and sampling of a texture. */
+struct Texture_source {
+  std::string image;
+  Texture_2D::Filter filter;
+  Texture_2D::Wrap wrap;
+};
+
+/** Resolves *.texture files, on the calling thread since documents are
+ * cached. */
+auto texture_source(Assets &assets, const std::string &path,
+                    const Texture_2D::Filter &filter,
+                    const Texture_2D::Wrap &wrap) -> Texture_source {
+  if (std::filesystem::path(path).extension() == ".texture") {
+    const auto &texture_json = *assets.document(path);
+    const std::string image_path = texture_json.at("image");
+    const std::string filter_key = texture_json.at("filter");
+    const std::string wrap_key = texture_json.at("wrap");
+
+    static const std::map<std::string, Texture_2D::Filter> filter_map{{"linear", Texture_2D::Filter::Linear}, {"closest", Texture_2D::Filter::Closest}};
+    static const std::map<std::string, Texture_2D::Wrap> wrap_map{{"clamp", Texture_2D::Wrap::Clamp}, {"repeat", Texture_2D::Wrap::Repeat}};
+
+    return {assets.directory() + image_path, filter_map.at(filter_key), wrap_map.at(wrap_key)};
+  }
+  return {assets.directory() + path, filter, wrap};
+}
+
+/** Decode a texture, safe to call from any thread. */
+auto load_texture(const Assets_cache &cache, const Texture_source &source,
+                  const bool color_data, const bool mipmaps) -> Shared_texture_2D {
+  return std::make_shared<Texture_2D>(cached_texture(cache, source.image, color_data, mipmaps, source.filter, source.wrap));
+}
+
+/** Next to the assets directory, "assets/" is cached in "assets.cache/". */
+auto cache_directory(const std::string &directory) -> std::filesystem::path {
+  auto path = std::filesystem::path(directory);
+  if (!path.has_filename()) {
+    path = path.parent_path();
+  }
+  return path.string() + ".cache";
+}
+
+template <class T>
+auto ready(const std::shared_future<T> &future) -> bool {
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+template <class T>
+auto ready_future(const T &value) -> std::shared_future<T> {
+  std::promise<T> promise;
+  promise.set_value(value);
+  return promise.get_future().share();
+}
+
+} // namespace
+
+Assets::Assets(std::string directory, const Parser parser)
+    : directory_(std::move(directory)), parser_(parser),
+      cache_(cache_directory(directory_)) {}
+
+auto Assets::document(const std::string &path)
+    -> std::shared_ptr<const nlohmann::json> {
+  if (documents_.find(path) == documents_.end()) {
+    documents_.insert({path, std::make_shared<const json>(json::parse(mos::text(directory_ + path)))});
+  }
+  return documents_.at(path);
+}
+
+auto Assets::model(const std::string &path) -> Model {
+  if (models_.find(path) == models_.end()) {
+    spdlog::info("Loading: {}", path);
+    const auto description = parser_ == Parser::Sax
+                                 ? Model_description::read(directory_ + path)
+                                 : Model_description::parse(*document(path));
+    models_.insert({path, std::make_shared<const Model>(Model::load(description, *this))});
+  }
+  return *models_.at(path);
+}
+
+auto Assets::material(const std::string &path) -> Material {
+  if (path.empty()) {
+    return Material::load(*this, path);
+  }
+  if (materials_.find(path) == materials_.end()) {
+    materials_.insert({path, std::make_shared<const Material>(Material::load(*this, path))});
+  }
+  return *materials_.at(path);
+}
 
 auto Assets::mesh(const std::string &path) -> Shared_mesh {
   if (path.empty()){
     return Shared_mesh(nullptr);
   }
   if (meshes_.find(path) == meshes_.end()) {
-    meshes_.insert({path, std::make_shared<Mesh>(Mesh::load(directory_ + path))});
+    auto pending = pending_meshes_.find(path);
+    if (pending != pending_meshes_.end()) {
+      auto future = pending->second;
+      pending_meshes_.erase(pending);
+      meshes_.insert({path, future.get()});
+    } else {
+      meshes_.insert({path, std::make_shared<Mesh>(Mesh::load(directory_ + path))});
+    }
   }
   return meshes_.at(path);
 }
@@ -30,29 +152,100 @@ auto Assets::texture(const std::string &path,
                                             const Texture_2D::Filter &filter,
                                             const Texture_2D::Wrap &wrap) -> Shared_texture_2D {
   if (!path.empty()) {
-    std::filesystem::path fpath = path;
     if (textures_.find(path) == textures_.end()) {
-      if (fpath.extension() == ".texture") {
-          auto texture_json = json::parse(mos::text(directory() + path));
-          std::string image_path = texture_json["image"];
-          std::string filter_key = texture_json["filter"];
-          std::string wrap_key = texture_json["wrap"];
+      auto pending = pending_textures_.find(path);
+      if (pending != pending_textures_.end()) {
+        auto future = pending->second;
+        pending_textures_.erase(pending);
+        textures_.insert({path, future.get()});
+      } else {
+        textures_.insert({path, load_texture(cache_, texture_source(*this, path, filter, wrap), color_data, mipmaps)});
+      }
+    }
+    return textures_.at(path);
+  }
+  return Shared_texture_2D(nullptr);
+}
 
-          static const std::map<std::string, Texture_2D::Filter> filter_map{{"linear", Texture_2D::Filter::Linear}, {"closest", Texture_2D::Filter::Closest}};
-          static const std::map<std::string, Texture_2D::Wrap> wrap_map{{"clamp", Texture_2D::Wrap::Clamp}, {"repeat", Texture_2D::Wrap::Repeat}};
+auto Assets::mesh_async(const std::string &path)
+    -> std::shared_future<Shared_mesh> {
+  if (path.empty()) {
+    return ready_future(Shared_mesh(nullptr));
+  }
+  if (meshes_.find(path) != meshes_.end()) {
+    return ready_future(meshes_.at(path));
+  }
+  if (pending_meshes_.find(path) == pending_meshes_.end()) {
+    auto future = Thread_pool::shared().enqueue([full_path = directory_ + path]() {
+      return std::make_shared<Mesh>(Mesh::load(full_path));
+    });
+    pending_meshes_.insert({path, future.share()});
+  }
+  return pending_meshes_.at(path);
+}
 
-          textures_.insert({path, std::make_shared<Texture_2D>(Texture_2D::load(directory_ + image_path, color_data, mipmaps, filter_map.at(filter_key), wrap_map.at(wrap_key)))});
+auto Assets::texture_async(const std::string &path, const bool color_data,
+                           const bool mipmaps,
+                           const Texture_2D::Filter &filter,
+                           const Texture_2D::Wrap &wrap)
+    -> std::shared_future<Shared_texture_2D> {
+  if (path.empty()) {
+    return ready_future(Shared_texture_2D(nullptr));
+  }
+  if (textures_.find(path) != textures_.end()) {
+    return ready_future(textures_.at(path));
+  }
+  if (pending_textures_.find(path) == pending_textures_.end()) {
+    // The pool is shared and may outlive this, so the cache is copied.
+    auto future = Thread_pool::shared().enqueue([=, cache = cache_, source = texture_source(*this, path, filter, wrap)]() {
+      return load_texture(cache, source, color_data, mipmaps);
+    });
+    pending_textures_.insert({path, future.share()});
+  }
+  return pending_textures_.at(path);
+}
+
+auto Assets::commit() -> Loaded {
+  // Loads cached by a call that threw are returned by this one.
+  auto loaded = std::exchange(unreturned_, Loaded{});
+  std::exception_ptr error;
+  const auto drain = [&](auto &pending, auto &cache, auto &results) {
+    for (auto it = pending.begin(); it != pending.end();) {
+      if (!ready(it->second)) {
+        ++it;
+        continue;
       }
-      else {
-        textures_.insert({path, std::make_shared<Texture_2D>(Texture_2D::load(directory_ + path, color_data, mipmaps, filter, wrap))});
+      const auto path = it->first;
+      const auto future = it->second;
+      it = pending.erase(it);
+      try {
+        const auto &result = future.get();
+        cache.insert({path, result});
+        results.push_back(result);
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
       }
     }
-    return textures_.at(path);
+  };
+  drain(pending_meshes_, meshes_, loaded.meshes);
+  drain(pending_textures_, textures_, loaded.textures);
+  if (error) {
+    unreturned_ = std::move(loaded);
+    std::rethrow_exception(error);
   }
-  return Shared_texture_2D(nullptr);
+  return loaded;
+}
+
+auto Assets::pending() const -> size_t {
+  return pending_meshes_.size() + pending_textures_.size();
 }
 
 void Assets::clear_unused() {
+  documents_.clear();
+  models_.clear();
+  materials_.clear();
   for (auto it = textures_.begin(); it != textures_.end();) {
     if (it->second.use_count() <= 1) {
       textures_.erase(it++);
@@ -74,8 +267,13 @@ auto Assets::directory() const -> std::string {
 }
 
 void Assets::clear() {
+  documents_.clear();
+  models_.clear();
+  materials_.clear();
   textures_.clear();
   meshes_.clear();
+  pending_textures_.clear();
+  pending_meshes_.clear();
 }
 
 }
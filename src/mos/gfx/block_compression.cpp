@@ -0,0 +1,233 @@
+#include <mos/gfx/block_compression.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mos::gfx {
+
+namespace {
+
+using Color = std::array<float, 3>;
+
+auto pack_565(const Color &color) -> std::uint16_t {
+  auto quantize = [](const float value, const int max) {
+    return int(std::clamp(value, 0.0f, 255.0f) * float(max) / 255.0f + 0.5f);
+  };
+  return std::uint16_t(quantize(color[0], 31) << 11 |
+                       quantize(color[1], 63) << 5 | quantize(color[2], 31));
+}
+
+auto unpack_565(const std::uint16_t color) -> std::array<int, 3> {
+  const int r = (color >> 11) & 31;
+  const int g = (color >> 5) & 63;
+  const int b = color & 31;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+/** Colors of a BC1 block, as the decoder computes them. */
+auto bc1_palette(const std::uint16_t c0, const std::uint16_t c1)
+    -> std::array<std::array<int, 3>, 4> {
+  const auto e0 = unpack_565(c0);
+  const auto e1 = unpack_565(c1);
+  std::array<std::array<int, 3>, 4> palette{e0, e1};
+  for (int i = 0; i < 3; i++) {
+    if (c0 > c1) {
+      palette[2][i] = (2 * e0[i] + e1[i]) / 3;
+      palette[3][i] = (e0[i] + 2 * e1[i]) / 3;
+    } else {
+      palette[2][i] = (e0[i] + e1[i]) / 2;
+      palette[3][i] = 0;
+    }
+  }
+  return palette;
+}
+
+/** Values of a BC4 block, as the decoder computes them. */
+auto bc4_palette(const int r0, const int r1) -> std::array<int, 8> {
+  std::array<int, 8> palette{r0, r1};
+  if (r0 > r1) {
+    for (int i = 1; i < 7; i++) {
+      palette[i + 1] = ((7 - i) * r0 + i * r1 + 3) / 7;
+    }
+  } else {
+    for (int i = 1; i < 5; i++) {
+      palette[i + 1] = ((5 - i) * r0 + i * r1 + 2) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+  return palette;
+}
+
+/** Principal axis of the colors, through their mean. */
+auto principal_axis(const Pixel_block &pixels, const Color &mean) -> Color {
+  std::array<float, 6> covariance{};
+  for (const auto &pixel : pixels) {
+    const Color d{pixel[0] - mean[0], pixel[1] - mean[1], pixel[2] - mean[2]};
+    covariance[0] += d[0] * d[0];
+    covariance[1] += d[0] * d[1];
+    covariance[2] += d[0] * d[2];
+    covariance[3] += d[1] * d[1];
+    covariance[4] += d[1] * d[2];
+    covariance[5] += d[2] * d[2];
+  }
+  // Start from the covariance column of the channel with most variance, a
+  // fixed start may be orthogonal to the axis.
+  const std::array<Color, 3> columns{
+      Color{covariance[0], covariance[1], covariance[2]},
+      Color{covariance[1], covariance[3], covariance[4]},
+      Color{covariance[2], covariance[4], covariance[5]}};
+  int largest = 0;
+  if (covariance[3] > covariance[0] && covariance[3] >= covariance[5]) {
+    largest = 1;
+  } else if (covariance[5] > covariance[0] && covariance[5] > covariance[3]) {
+    largest = 2;
+  }
+  Color axis = columns[largest];
+  for (int iteration = 0; iteration < 8; iteration++) {
+    const Color next{
+        covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+        covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+        covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]};
+    const auto length =
+        std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+    if (length < std::numeric_limits<float>::epsilon()) {
+      break;
+    }
+    axis = {next[0] / length, next[1] / length, next[2] / length};
+  }
+  return axis;
+}
+
+} // namespace
+
+auto encode_bc1(const Pixel_block &pixels) -> std::array<std::uint8_t, 8> {
+  Color mean{};
+  for (const auto &pixel : pixels) {
+    for (int i = 0; i < 3; i++) {
+      mean[i] += float(pixel[i]) / 16.0f;
+    }
+  }
+  const auto axis = principal_axis(pixels, mean);
+  float min_t = std::numeric_limits<float>::max();
+  float max_t = std::numeric_limits<float>::lowest();
+  for (const auto &pixel : pixels) {
+    const auto t = (pixel[0] - mean[0]) * axis[0] +
+                   (pixel[1] - mean[1]) * axis[1] +
+                   (pixel[2] - mean[2]) * axis[2];
+    min_t = std::min(min_t, t);
+    max_t = std::max(max_t, t);
+  }
+  auto c0 = pack_565({mean[0] + axis[0] * max_t, mean[1] + axis[1] * max_t,
+                      mean[2] + axis[2] * max_t});
+  auto c1 = pack_565({mean[0] + axis[0] * min_t, mean[1] + axis[1] * min_t,
+                      mean[2] + axis[2] * min_t});
+  // Four color mode needs c0 > c1, equal endpoints only use index zero.
+  if (c0 < c1) {
+    std::swap(c0, c1);
+  }
+  const auto palette = bc1_palette(c0, c1);
+
+  std::uint32_t indices = 0;
+  if (c0 != c1) {
+    for (int p = 0; p < 16; p++) {
+      int best = 0;
+      int best_error = std::numeric_limits<int>::max();
+      for (int i = 0; i < 4; i++) {
+        int error = 0;
+        for (int c = 0; c < 3; c++) {
+          const int d = int(pixels[p][c]) - palette[i][c];
+          error += d * d;
+        }
+        if (error < best_error) {
+          best = i;
+          best_error = error;
+        }
+      }
+      indices |= std::uint32_t(best) << (2 * p);
+    }
+  }
+  return {std::uint8_t(c0 & 0xFF),      std::uint8_t(c0 >> 8),
+          std::uint8_t(c1 & 0xFF),      std::uint8_t(c1 >> 8),
+          std::uint8_t(indices & 0xFF), std::uint8_t((indices >> 8) & 0xFF),
+          std::uint8_t((indices >> 16) & 0xFF), std::uint8_t(indices >> 24)};
+}
+
+auto encode_bc4(const Pixel_block &pixels, const int channel)
+    -> std::array<std::uint8_t, 8> {
+  int r0 = 0;
+  int r1 = 255;
+  for (const auto &pixel : pixels) {
+    r0 = std::max(r0, int(pixel[channel]));
+    r1 = std::min(r1, int(pixel[channel]));
+  }
+  std::array<std::uint8_t, 8> block{std::uint8_t(r0), std::uint8_t(r1)};
+  if (r0 == r1) {
+    return block;
+  }
+  const auto palette = bc4_palette(r0, r1);
+  std::uint64_t indices = 0;
+  for (int p = 0; p < 16; p++) {
+    int best = 0;
+    for (int i = 1; i < 8; i++) {
+      if (std::abs(palette[i] - pixels[p][channel]) <
+          std::abs(palette[best] - pixels[p][channel])) {
+        best = i;
+      }
+    }
+    indices |= std::uint64_t(best) << (3 * p);
+  }
+  for (int i = 0; i < 6; i++) {
+    block[2 + i] = std::uint8_t((indices >> (8 * i)) & 0xFF);
+  }
+  return block;
+}
+
+auto encode_bc3(const Pixel_block &pixels) -> std::array<std::uint8_t, 16> {
+  const auto alpha = encode_bc4(pixels, 3);
+  const auto color = encode_bc1(pixels);
+  std::array<std::uint8_t, 16> block{};
+  std::copy(alpha.begin(), alpha.end(), block.begin());
+  std::copy(color.begin(), color.end(), block.begin() + 8);
+  return block;
+}
+
+auto encode_bc5(const Pixel_block &pixels) -> std::array<std::uint8_t, 16> {
+  const auto red = encode_bc4(pixels, 0);
+  const auto green = encode_bc4(pixels, 1);
+  std::array<std::uint8_t, 16> block{};
+  std::copy(red.begin(), red.end(), block.begin());
+  std::copy(green.begin(), green.end(), block.begin() + 8);
+  return block;
+}
+
+auto decode_bc1(const std::array<std::uint8_t, 8> &block) -> Pixel_block {
+  const auto c0 = std::uint16_t(block[0] | block[1] << 8);
+  const auto c1 = std::uint16_t(block[2] | block[3] << 8);
+  const auto palette = bc1_palette(c0, c1);
+  const auto indices = std::uint32_t(block[4] | block[5] << 8 |
+                                     block[6] << 16 | std::uint32_t(block[7]) << 24);
+  Pixel_block pixels{};
+  for (int p = 0; p < 16; p++) {
+    const auto &color = palette[(indices >> (2 * p)) & 3];
+    pixels[p] = {std::uint8_t(color[0]), std::uint8_t(color[1]),
+                 std::uint8_t(color[2]), 255};
+  }
+  return pixels;
+}
+
+auto decode_bc4(const std::array<std::uint8_t, 8> &block, const int channel)
+    -> Pixel_block {
+  const auto palette = bc4_palette(block[0], block[1]);
+  std::uint64_t indices = 0;
+  for (int i = 0; i < 6; i++) {
+    indices |= std::uint64_t(block[2 + i]) << (8 * i);
+  }
+  Pixel_block pixels{};
+  for (int p = 0; p < 16; p++) {
+    pixels[p][channel] = std::uint8_t(palette[(indices >> (3 * p)) & 7]);
+  }
+  return pixels;
+}
+
+} // namespace mos::gfx
@@ -0,0 +1,127 @@
+#include <mos/gfx/brdf_lut.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <glm/gtc/constants.hpp>
+#include <mos/core/simd.hpp>
+#include <mos/core/thread_pool.hpp>
+
+namespace mos::gfx {
+
+using simd::Float4;
+
+namespace {
+
+/** Van der Corput sequence, the second coordinate of Hammersley points. */
+auto radical_inverse(std::uint32_t bits) -> float {
+  bits = (bits << 16u) | (bits >> 16u);
+  bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+  bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+  bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+  bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+  return float(bits) * 2.3283064365386963e-10f;
+}
+
+/** Half vectors of one roughness, in the plane of the view vector, which
+ * has no y component. */
+struct Half_vector {
+  float x;
+  float z;
+};
+
+auto half_vectors(const float roughness, const int samples)
+    -> std::vector<Half_vector> {
+  const auto a = roughness * roughness;
+  std::vector<Half_vector> half_vectors(samples);
+  for (int i = 0; i < samples; i++) {
+    const auto phi = glm::two_pi<float>() * float(i) / float(samples);
+    const auto u = radical_inverse(std::uint32_t(i));
+    const auto cos_theta =
+        std::sqrt((1.0f - u) / (1.0f + (a * a - 1.0f) * u));
+    const auto sin_theta = std::sqrt(1.0f - cos_theta * cos_theta);
+    half_vectors[i] = {sin_theta * std::cos(phi), cos_theta};
+  }
+  return half_vectors;
+}
+
+/** Integrate four values of n dot v for the same half vectors. The
+ * geometry term uses k = roughness^2 / 2, as for image based lighting. */
+auto integrate(const Float4 n_dot_v, const float roughness,
+               const std::vector<Half_vector> &half_vectors)
+    -> std::pair<Float4, Float4> {
+  const Float4 zero(0.0f);
+  const Float4 one(1.0f);
+  const Float4 two(2.0f);
+  const Float4 k(roughness * roughness / 2.0f);
+  const auto v_x = sqrt(max(one - n_dot_v * n_dot_v, zero));
+  const auto g_v = n_dot_v / (n_dot_v * (one - k) + k);
+  Float4 scale(0.0f);
+  Float4 bias(0.0f);
+  for (const auto &h : half_vectors) {
+    const Float4 h_x(h.x);
+    const Float4 h_z(h.z);
+    const auto v_dot_h = max(v_x * h_x + n_dot_v * h_z, zero);
+    // Directions below the horizon get a geometry term of zero.
+    const auto n_dot_l = max(two * v_dot_h * h_z - n_dot_v, zero);
+    const auto g_l = n_dot_l / (n_dot_l * (one - k) + k);
+    const auto g_vis = g_v * g_l * v_dot_h / (h_z * n_dot_v);
+    const auto c = one - v_dot_h;
+    const auto c2 = c * c;
+    const auto fresnel = c2 * c2 * c;
+    scale = scale + (one - fresnel) * g_vis;
+    bias = bias + fresnel * g_vis;
+  }
+  const Float4 count(float(half_vectors.size()));
+  return {scale / count, bias / count};
+}
+
+auto compute(const int size, const int samples) -> std::vector<glm::vec2> {
+  std::vector<glm::vec2> lut(std::size_t(size) * std::size_t(size));
+  Thread_pool::shared().parallel_for(
+      std::size_t(size),
+      [&](std::size_t, const std::size_t begin, const std::size_t end) {
+        for (auto row = begin; row < end; row++) {
+          const auto roughness = (float(row) + 0.5f) / float(size);
+          const auto hs = half_vectors(roughness, samples);
+          for (int x = 0; x < size; x += 4) {
+            std::array<float, 4> n_dot_v{};
+            for (int lane = 0; lane < 4; lane++) {
+              n_dot_v[lane] = (float(x + lane) + 0.5f) / float(size);
+            }
+            const auto [scale, bias] =
+                integrate(Float4::load(n_dot_v.data()), roughness, hs);
+            for (int lane = 0; lane < 4 && x + lane < size; lane++) {
+              lut[row * std::size_t(size) + std::size_t(x + lane)] =
+                  glm::vec2(scale[lane], bias[lane]);
+            }
+          }
+        }
+      });
+  return lut;
+}
+
+} // namespace
+
+auto brdf_lut(const int size, const int samples)
+    -> std::shared_ptr<const std::vector<glm::vec2>> {
+  if (size <= 0 || samples <= 0) {
+    throw std::runtime_error("BRDF LUT size and samples must be positive.");
+  }
+  static std::mutex mutex;
+  static std::map<std::pair<int, int>,
+                  std::shared_ptr<const std::vector<glm::vec2>>>
+      cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &lut = cache[{size, samples}];
+  if (!lut) {
+    lut = std::make_shared<const std::vector<glm::vec2>>(
+        compute(size, samples));
+  }
+  return lut;
+}
+
+} // namespace mos::gfx
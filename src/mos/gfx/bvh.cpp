@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <array>
+#include <mos/gfx/bvh.hpp>
+
+namespace mos::gfx {
+
+namespace {
+
+constexpr float infinity = std::numeric_limits<float>::infinity();
+
+/** Bounds of a sphere, empty if it is never found. */
+auto box(const Bvh::Sphere &sphere) -> std::pair<glm::vec3, glm::vec3> {
+  if (sphere.radius < 0.0f) {
+    return {glm::vec3(infinity), glm::vec3(-infinity)};
+  }
+  return {sphere.center - glm::vec3(sphere.radius),
+          sphere.center + glm::vec3(sphere.radius)};
+}
+
+auto outside(const glm::vec4 &plane, const Bvh::Sphere &sphere) -> bool {
+  return plane.x * sphere.center.x + plane.y * sphere.center.y +
+             plane.z * sphere.center.z + plane.w <=
+         -sphere.radius;
+}
+
+/** Distance along the ray to a sphere, or infinity if missed. */
+auto distance(const sim::Ray &ray, const Bvh::Sphere &sphere) -> float {
+  const auto to_center = sphere.center - ray.origin;
+  const auto closest = glm::dot(to_center, ray.direction());
+  const auto squared =
+      sphere.radius * sphere.radius -
+      (glm::dot(to_center, to_center) - closest * closest);
+  if (sphere.radius < 0.0f || squared < 0.0f) {
+    return infinity;
+  }
+  const auto half_chord = std::sqrt(squared);
+  if (closest + half_chord < 0.0f) {
+    return infinity;
+  }
+  return std::max(closest - half_chord, 0.0f);
+}
+
+} // namespace
+
+auto Bvh::build(const std::span<const Sphere> spheres) -> void {
+  spheres_.assign(spheres.begin(), spheres.end());
+  items_.resize(spheres_.size());
+  for (std::size_t i = 0; i < items_.size(); i++) {
+    items_[i] = Index(i);
+  }
+  nodes_.clear();
+  nodes_.reserve(2 * (spheres_.size() / leaf_size + 1));
+  if (!spheres_.empty()) {
+    split(0, std::uint32_t(items_.size()));
+  }
+  built_area_ = area();
+  builds_++;
+}
+
+auto Bvh::split(const std::uint32_t begin, const std::uint32_t end)
+    -> std::uint32_t {
+  const auto index = std::uint32_t(nodes_.size());
+  Node node{glm::vec3(infinity), begin, glm::vec3(-infinity), end, 0};
+  auto centers_min = glm::vec3(infinity);
+  auto centers_max = glm::vec3(-infinity);
+  for (auto i = begin; i < end; i++) {
+    const auto &sphere = spheres_[items_[i]];
+    const auto [min, max] = box(sphere);
+    node.min = glm::min(node.min, min);
+    node.max = glm::max(node.max, max);
+    centers_min = glm::min(centers_min, sphere.center);
+    centers_max = glm::max(centers_max, sphere.center);
+  }
+  nodes_.push_back(node);
+  if (end - begin > leaf_size) {
+    const auto extent = centers_max - centers_min;
+    const int axis =
+        extent.x > extent.y ? (extent.x > extent.z ? 0 : 2)
+                            : (extent.y > extent.z ? 1 : 2);
+    const auto middle = begin + (end - begin) / 2;
+    std::nth_element(items_.begin() + begin, items_.begin() + middle,
+                     items_.begin() + end, [&](const Index a, const Index b) {
+                       return spheres_[a].center[axis] <
+                              spheres_[b].center[axis];
+                     });
+    split(begin, middle);
+    const auto right = split(middle, end);
+    nodes_[index].right = right;
+  }
+  return index;
+}
+
+auto Bvh::refit(const std::span<const Sphere> spheres) -> void {
+  if (spheres.size() != spheres_.size()) {
+    build(spheres);
+    return;
+  }
+  std::copy(spheres.begin(), spheres.end(), spheres_.begin());
+  // Children are stored after their parent.
+  for (auto index = nodes_.size(); index-- > 0;) {
+    auto &node = nodes_[index];
+    if (node.right == 0) {
+      node.min = glm::vec3(infinity);
+      node.max = glm::vec3(-infinity);
+      for (auto i = node.begin; i < node.end; i++) {
+        const auto [min, max] = box(spheres_[items_[i]]);
+        node.min = glm::min(node.min, min);
+        node.max = glm::max(node.max, max);
+      }
+    } else {
+      const auto &left = nodes_[index + 1];
+      const auto &right = nodes_[node.right];
+      node.min = glm::min(left.min, right.min);
+      node.max = glm::max(left.max, right.max);
+    }
+  }
+  if (area() > 2.0f * built_area_) {
+    build(spheres);
+  }
+}
+
+auto Bvh::area() const -> float {
+  float area = 0.0f;
+  for (const auto &node : nodes_) {
+    const auto extent = node.max - node.min;
+    if (extent.x >= 0.0f) {
+      area += extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+  }
+  return area;
+}
+
+template <class Visit>
+auto Bvh::visit(const Camera::Planes &planes, Visit &&visit) const -> void {
+  if (nodes_.empty()) {
+    return;
+  }
+  // Planes a node is not known to be inside of, one bit each.
+  std::array<std::pair<std::uint32_t, std::uint8_t>, 64> stack;
+  std::size_t size = 0;
+  stack[size++] = {0, 0x3F};
+  while (size > 0) {
+    auto [index, mask] = stack[--size];
+    const auto &node = nodes_[index];
+    if (node.min.x > node.max.x) {
+      continue;
+    }
+    const auto center = (node.min + node.max) * 0.5f;
+    const auto extent = (node.max - node.min) * 0.5f;
+    bool culled = false;
+    for (std::size_t i = 0; i < planes.size() && !culled; i++) {
+      if (mask & (1 << i)) {
+        const auto normal = glm::vec3(planes[i]);
+        const auto distance = glm::dot(normal, center) + planes[i].w;
+        const auto radius = glm::dot(glm::abs(normal), extent);
+        culled = distance + radius <= 0.0f;
+        if (distance - radius > 0.0f) {
+          mask &= ~(1 << i);
+        }
+      }
+    }
+    if (culled) {
+      continue;
+    }
+    if (mask == 0 || node.right == 0) {
+      for (auto i = node.begin; i < node.end; i++) {
+        const auto &sphere = spheres_[items_[i]];
+        bool found = sphere.radius >= 0.0f;
+        for (std::size_t p = 0; p < planes.size() && found && mask; p++) {
+          found = !(mask & (1 << p)) || !outside(planes[p], sphere);
+        }
+        if (found) {
+          visit(items_[i]);
+        }
+      }
+    } else {
+      stack[size++] = {node.right, mask};
+      stack[size++] = {index + 1, mask};
+    }
+  }
+}
+
+auto Bvh::query(const Camera::Planes &planes,
+                std::vector<Index> &indices) const -> void {
+  visit(planes, [&](const Index index) { indices.push_back(index); });
+}
+
+auto Bvh::query(const Camera::Planes &planes,
+                const std::span<std::uint64_t> bits) const -> void {
+  visit(planes, [&](const Index index) {
+    bits[index / 64] |= std::uint64_t(1) << (index % 64);
+  });
+}
+
+auto Bvh::intersect(const sim::Ray &ray, const float max_distance) const
+    -> std::optional<Hit> {
+  std::optional<Hit> hit;
+  if (nodes_.empty()) {
+    return hit;
+  }
+  const auto inverse = 1.0f / ray.direction();
+  auto closest = max_distance;
+  std::array<std::uint32_t, 64> stack;
+  std::size_t size = 0;
+  stack[size++] = 0;
+  while (size > 0) {
+    const auto index = stack[--size];
+    const auto &node = nodes_[index];
+    if (node.min.x > node.max.x) {
+      continue;
+    }
+    const auto t0 = (node.min - ray.origin) * inverse;
+    const auto t1 = (node.max - ray.origin) * inverse;
+    const auto near = glm::min(t0, t1);
+    const auto far = glm::max(t0, t1);
+    const auto enter =
+        std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+    const auto exit =
+        std::min(std::min(far.x, far.y), std::min(far.z, closest));
+    if (enter > exit) {
+      continue;
+    }
+    if (node.right == 0) {
+      for (auto i = node.begin; i < node.end; i++) {
+        const auto d = distance(ray, spheres_[items_[i]]);
+        if (d <= closest) {
+          closest = d;
+          hit = Hit{items_[i], d};
+        }
+      }
+    } else {
+      stack[size++] = node.right;
+      stack[size++] = index + 1;
+    }
+  }
+  return hit;
+}
+
+auto Bvh::size() const -> std::size_t { return spheres_.size(); }
+
+auto Bvh::builds() const -> int { return builds_; }
+
+} // namespace mos::gfx
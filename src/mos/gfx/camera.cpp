@@ -106,6 +106,10 @@ auto Camera::in_frustum(const glm::vec3 &point, const float radius) const
                       });
 }
 
+auto Camera::frustum_planes() const -> const Planes & {
+  return frustum_planes_;
+}
+
 auto Camera::near_plane() const -> float {
   return near_;
 }
@@ -0,0 +1,104 @@
+#include <array>
+#include <limits>
+#include <mos/core/simd.hpp>
+#include <mos/gfx/culling.hpp>
+
+namespace mos::gfx {
+
+using simd::Float4;
+
+namespace {
+
+constexpr float invisible = -std::numeric_limits<float>::infinity();
+
+} // namespace
+
+auto Culling::clear() -> void {
+  x_.clear();
+  y_.clear();
+  z_.clear();
+  radius_.clear();
+  size_ = 0;
+  views_.clear();
+  visibility_.clear();
+}
+
+auto Culling::add(const glm::vec3 &center, const float radius) -> Index {
+  if (size_ == x_.size()) {
+    for (int i = 0; i < 4; i++) {
+      x_.push_back(0.0f);
+      y_.push_back(0.0f);
+      z_.push_back(0.0f);
+      radius_.push_back(invisible);
+    }
+  }
+  x_[size_] = center.x;
+  y_[size_] = center.y;
+  z_[size_] = center.z;
+  radius_[size_] = radius < 0.0f ? invisible : radius;
+  return Index(size_++);
+}
+
+auto Culling::add(const Camera &camera) -> Index {
+  views_.push_back(camera.frustum_planes());
+  return Index(views_.size() - 1);
+}
+
+auto Culling::words() const -> std::size_t {
+  return (size_ + word_bits - 1) / word_bits;
+}
+
+auto Culling::cull() -> void {
+  const auto words = this->words();
+  visibility_.assign(views_.size() * words, 0);
+  if (size_ >= hierarchy_size) {
+    spheres_.resize(size_);
+    for (std::size_t i = 0; i < size_; i++) {
+      spheres_[i] = {{x_[i], y_[i], z_[i]}, radius_[i]};
+    }
+    bvh_.refit(spheres_);
+    for (std::size_t view = 0; view < views_.size(); view++) {
+      bvh_.query(views_[view], {visibility_.data() + view * words, words});
+    }
+    return;
+  }
+  const Float4 zero(0.0f);
+  for (std::size_t view = 0; view < views_.size(); view++) {
+    std::array<std::array<Float4, 4>, 6> planes;
+    for (std::size_t i = 0; i < planes.size(); i++) {
+      const auto &plane = views_[view][i];
+      planes[i] = {Float4(plane.x), Float4(plane.y), Float4(plane.z),
+                   Float4(plane.w)};
+    }
+    auto *visibility = visibility_.data() + view * words;
+    for (std::size_t i = 0; i < size_; i += 4) {
+      const auto x = Float4::load(x_.data() + i);
+      const auto y = Float4::load(y_.data() + i);
+      const auto z = Float4::load(z_.data() + i);
+      const auto negative_radius = zero - Float4::load(radius_.data() + i);
+      int outside = 0;
+      for (const auto &plane : planes) {
+        const auto distance =
+            plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+        outside |= less_equal(distance, negative_radius);
+      }
+      visibility[i / word_bits] |= Word(~outside & 0xF) << (i % word_bits);
+    }
+  }
+}
+
+auto Culling::visible(const Index view, const Index sphere) const -> bool {
+  return (visibility_[view * words() + sphere / word_bits] >>
+          (sphere % word_bits)) &
+         1;
+}
+
+auto Culling::visibility(const Index view) const -> std::span<const Word> {
+  return {visibility_.data() + view * words(), words()};
+}
+
+auto Culling::size() const -> std::size_t { return size_; }
+
+auto Culling::views() const -> std::size_t { return views_.size(); }
+
+} // namespace mos::gfx
@@ -15,7 +15,8 @@ auto Material::load(Assets &assets, const std::string &path) -> Material
   if (!path.empty()) {
     std::filesystem::path fpath = path;
     if (fpath.extension() == ".material") {
-      auto value = json::parse(mos::text(assets.directory() + fpath.generic_string()));
+      // Copied, since missing fields are added as null on access.
+      auto value = *assets.document(fpath.generic_string());
 
       auto read_texture = [&](const std::string &name, const bool color_data = true) {
         std::string file_name{};
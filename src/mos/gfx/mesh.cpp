@@ -1,11 +1,10 @@
 #include <fstream>
 #include <array>
-#include <map>
 #include <algorithm>
 #include <mos/gfx/mesh.hpp>
+#include <mos/gfx/mesh_file.hpp>
+#include <mos/gfx/mesh_kernels.hpp>
 #include <mos/util.hpp>
-#include <glm/gtx/normal.hpp>
-#include <glm/gtx/io.hpp>
 #include <glm/gtx/io.hpp>
 
 namespace mos::gfx {
@@ -20,8 +19,17 @@ Mesh::Mesh() {
   calculate_sphere();
 }
 
+Mesh::Mesh(const Mesh_file &file)
+    : vertices(file.vertices().begin(), file.vertices().end()),
+      indices(file.indices().begin(), file.indices().end()),
+      centroid_(file.centroid()), radius_(file.radius()) {}
+
 auto Mesh::load(const std::string &path) -> Mesh {
-  if (path.substr(path.find_last_of('.') + 1) == "mesh") {
+  const auto extension = path.substr(path.find_last_of('.') + 1);
+  if (extension == "mesh2") {
+    return Mesh(Mesh_file(path));
+  }
+  if (extension == "mesh") {
 
     Mesh mesh;
 
@@ -69,138 +77,42 @@ auto Mesh::positions() const -> Positions {
 }
 
 auto Mesh::mix(const Mesh &mesh1, const Mesh &mesh2, const float amount) -> void {
-  auto it = vertices.begin();
-  auto it1 = mesh1.vertices.begin();
-  auto it2 = mesh2.vertices.begin();
-
-  while (it != vertices.end()) {
-    it->position = glm::mix(it1->position, it2->position, amount);
-    it->normal = glm::mix(it1->normal, it2->normal, amount);
-    it->uv = glm::mix(it1->uv, it2->uv, amount);
-
-    it++;
-    it1++;
-    it2++;
-  }
+  kernels::mix(mutable_vertices(), std::span(mesh1.vertices.data(), mesh1.vertices.size()),
+               std::span(mesh2.vertices.data(), mesh2.vertices.size()), amount);
 }
 
 auto Mesh::apply_transform(const glm::mat4 &transform) -> void {
-  for (auto &vertex : vertices) {
-    vertex.apply_transform(transform);
-  }
-}
-
-auto Mesh::calculate_tangents(Vertex &v0,
-                              Vertex &v1,
-                              Vertex &v2) -> void {
-  auto pos1 = v0.position;
-  auto pos2 = v1.position;
-  auto pos3 = v2.position;
-
-  auto uv1 = v0.uv;
-  auto uv2 = v1.uv;
-  auto uv3 = v2.uv;
-
-  glm::vec3 edge1 = pos2 - pos1;
-  glm::vec3 edge2 = pos3 - pos1;
-  glm::vec2 delta_uv1 = uv2 - uv1;
-  glm::vec2 delta_uv2 = uv3 - uv1;
-
-  float f = 1.0F / (delta_uv1.x * delta_uv2.y - delta_uv2.x * delta_uv1.y);
-
-  glm::vec3 tangent;
-  tangent.x = f * (delta_uv2.y * edge1.x - delta_uv1.y * edge2.x);
-  tangent.y = f * (delta_uv2.y * edge1.y - delta_uv1.y * edge2.y);
-  tangent.z = f * (delta_uv2.y * edge1.z - delta_uv1.y * edge2.z);
-  tangent = glm::normalize(tangent);
-
-  v0.tangent = tangent;
-  v1.tangent = tangent;
-  v2.tangent = tangent;
-}
-
-void Mesh::for_each_triangle(const std::function<void (const Mesh::Triangle &)> &callback)
-{
-  if (indices.size() == 0) {
-    for (size_t i = 0; i < vertices.size(); i += 3) {
-      Triangle triangle{vertices[i], vertices[i + 1], vertices[i + 2]};
-      callback(triangle);
-    }
-  } else {
-    for (const auto triangle_indices: indices) {
-      Triangle triangle{vertices[triangle_indices[0]], vertices[triangle_indices[1]], vertices[triangle_indices[2]]};
-      callback(triangle);
-    }
-  }
+  kernels::transform(mutable_vertices(), transform);
 }
 
 auto Mesh::calculate_normals() -> void {
   if (indices.size() == 0) {
-    for (size_t i = 0; i < vertices.size(); i += 3) {
-      //TODO: Generalize
-      auto &v0 = vertices[i];
-      auto &v1 = vertices[i + 1];
-      auto &v2 = vertices[i + 2];
-
-      auto normal = glm::triangleNormal(v0.position, v1.position, v2.position);
-      v0.normal = normal;
-      v1.normal = normal;
-      v2.normal = normal;
-    }
+    kernels::flat_normals(mutable_vertices(), triangles());
   } else {
-    //TODO: Slow brute force, improve?
-    using P = std::pair<int, std::vector<Triangle>>;
-    std::map<int, std::vector<Triangle>> triangle_map;
-    for (const auto tri : indices) {
-      Triangle t{vertices[tri[0]], vertices[tri[1]], vertices[tri[2]]};
-      for (auto i0 : tri) {
-        if (triangle_map.find(i0) == triangle_map.end()) {
-          triangle_map.insert(P(i0, std::vector<Triangle>{t}));
-        } else {
-          triangle_map[i0].push_back(t);
-        }
-      }
-    }
-    for (const auto & p : triangle_map) {
-      auto &v = vertices[p.first];
-      auto normal = glm::vec3(0.0F);
-      for (const auto &neighbour : p.second) {
-        normal += neighbour.normal();
-      }
-      v.normal = glm::normalize(normal);
-    }
+    kernels::smooth_normals(mutable_vertices(), triangles());
   }
 }
 
 auto Mesh::calculate_tangents() -> void {
-  for_each_triangle([](const Triangle& triangle) {
-    calculate_tangents(triangle.v0, triangle.v1, triangle.v2);
-  });
+  kernels::tangents(mutable_vertices(), triangles());
 }
 
 auto Mesh::calculate_flat_normals() -> void {
-  for_each_triangle([](const Triangle& triangle) {
-    auto normal = glm::triangleNormal(triangle.v0.position, triangle.v1.position, triangle.v2.position);
-    triangle.v0.normal = normal;
-    triangle.v1.normal = normal;
-    triangle.v2.normal = normal;
-  });
+  kernels::flat_normals(mutable_vertices(), triangles());
 }
 
 auto Mesh::calculate_sphere() -> void {
-  const auto & all_positions = positions();
-
-  centroid_ = std::accumulate(all_positions.begin(), all_positions.end(), glm::vec3(0.0));
-  centroid_ /= all_positions.size();
+  const auto sphere = kernels::bounding_sphere(std::span(vertices.data(), vertices.size()));
+  centroid_ = sphere.centroid;
+  radius_ = sphere.radius;
+}
 
-  radius_ = 0.0F;
+auto Mesh::mutable_vertices() -> std::span<Vertex> {
+  return std::span<Vertex>(vertices.begin(), vertices.end());
+}
 
-  for (const auto & position : all_positions) {
-    auto distance = glm::distance(centroid_, position);
-    if (distance > radius_) {
-      radius_ = distance;
-    }
-  }
+auto Mesh::triangles() const -> std::span<const Triangle_indices> {
+  return std::span(indices.data(), indices.size());
 }
 
 auto Mesh::centroid() const -> glm::vec3 {
@@ -211,7 +123,4 @@ auto Mesh::radius() const -> float {
   return radius_;
 }
 
-auto Mesh::Triangle::normal() const -> glm::vec3 {
-  return glm::triangleNormal(v0.position, v1.position, v2.position);
-}
 }
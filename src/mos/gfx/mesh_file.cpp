@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <mos/gfx/mesh_file.hpp>
+
+namespace mos::gfx {
+
+namespace {
+
+auto align(const std::uint64_t offset) -> std::uint64_t {
+  return (offset + Mesh_file::alignment - 1) & ~(Mesh_file::alignment - 1);
+}
+
+auto pad(std::ofstream &os, const std::uint64_t offset) -> void {
+  static const std::array<char, Mesh_file::alignment> zeros{};
+  const auto position = static_cast<std::uint64_t>(os.tellp());
+  os.write(zeros.data(), std::streamsize(offset - position));
+}
+
+} // namespace
+
+Mesh_file::Mesh_file(const std::string &path) : file_(path) {
+  if (file_.size() < sizeof(Header)) {
+    throw std::runtime_error(path + " is not a valid mesh2 file.");
+  }
+  header_ = reinterpret_cast<const Header *>(file_.data());
+  if (header_->magic != magic) {
+    throw std::runtime_error(path + " is not a valid mesh2 file.");
+  }
+  if (header_->version != version) {
+    throw std::runtime_error(path + " has unsupported mesh2 version " +
+                             std::to_string(header_->version) + ".");
+  }
+  // Compared as counts of what fits after each offset, as offset plus
+  // size could wrap for hostile headers.
+  const auto fits = [this](const std::uint64_t offset, const std::uint64_t count,
+                           const std::size_t size) {
+    return offset % alignment == 0 && offset <= file_.size() &&
+           count <= (file_.size() - offset) / size;
+  };
+  if (!fits(header_->vertices_offset, header_->num_vertices, sizeof(Vertex)) ||
+      !fits(header_->indices_offset, header_->num_triangles,
+            sizeof(Triangle_indices))) {
+    throw std::runtime_error(path + " is truncated or corrupt.");
+  }
+}
+
+auto Mesh_file::write(const std::string &path, const Mesh &mesh) -> void {
+  std::ofstream os(path, std::ios::binary);
+  if (!os.good()) {
+    throw std::runtime_error("Could not open " + path + " for writing.");
+  }
+  Header header{};
+  header.magic = magic;
+  header.version = version;
+  header.num_vertices = static_cast<std::uint32_t>(mesh.vertices.size());
+  header.num_triangles = static_cast<std::uint32_t>(mesh.indices.size());
+  header.vertices_offset = align(sizeof(Header));
+  header.indices_offset =
+      align(header.vertices_offset + mesh.vertices.size() * sizeof(Vertex));
+  header.centroid = mesh.centroid();
+  header.radius = mesh.radius();
+
+  os.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  pad(os, header.vertices_offset);
+  os.write(reinterpret_cast<const char *>(mesh.vertices.data()),
+           std::streamsize(mesh.vertices.size() * sizeof(Vertex)));
+  pad(os, header.indices_offset);
+  os.write(reinterpret_cast<const char *>(mesh.indices.data()),
+           std::streamsize(mesh.indices.size() * sizeof(Triangle_indices)));
+  if (!os.good()) {
+    throw std::runtime_error("Could not write " + path + ".");
+  }
+}
+
+auto Mesh_file::vertices() const -> std::span<const Vertex> {
+  return {reinterpret_cast<const Vertex *>(file_.data() +
+                                           header_->vertices_offset),
+          header_->num_vertices};
+}
+
+auto Mesh_file::indices() const -> std::span<const Triangle_indices> {
+  return {reinterpret_cast<const Triangle_indices *>(file_.data() +
+                                                     header_->indices_offset),
+          header_->num_triangles};
+}
+
+auto Mesh_file::centroid() const -> glm::vec3 { return header_->centroid; }
+
+auto Mesh_file::radius() const -> float { return header_->radius; }
+
+} // namespace mos::gfx
@@ -0,0 +1,267 @@
+#include <mos/gfx/mesh_kernels.hpp>
+#include <algorithm>
+#include <vector>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtx/normal.hpp>
+#include <mos/core/simd.hpp>
+#include <mos/core/thread_pool.hpp>
+
+namespace mos::gfx::kernels {
+
+using simd::Float4;
+
+namespace {
+
+auto parallel(const Execution execution, const std::size_t count) -> bool {
+  switch (execution) {
+  case Execution::Sequential:
+    return false;
+  case Execution::Parallel:
+    return true;
+  default:
+    return count >= parallel_threshold;
+  }
+}
+
+/** Call f(chunk, begin, end) for ranges covering [0, count). */
+template <class F>
+auto for_chunks(const Execution execution, const std::size_t count, F &&f)
+    -> void {
+  if (parallel(execution, count)) {
+    Thread_pool::shared().parallel_for(count, f);
+  } else {
+    f(std::size_t(0), std::size_t(0), count);
+  }
+}
+
+/** Number of chunks for_chunks will use. */
+auto num_chunks(const Execution execution, const std::size_t count)
+    -> std::size_t {
+  return parallel(execution, count) ? Thread_pool::shared().chunks(count) : 1;
+}
+
+/** Calls f(v0, v1, v2) per triangle, every three vertices if no indices. */
+template <class F>
+auto for_each_triangle(std::span<Vertex> vertices,
+                       std::span<const Triangle_indices> triangles, F &&f)
+    -> void {
+  if (triangles.empty()) {
+    for (std::size_t i = 0; i + 2 < vertices.size(); i += 3) {
+      f(vertices[i], vertices[i + 1], vertices[i + 2]);
+    }
+  } else {
+    for (const auto &triangle : triangles) {
+      f(vertices[triangle[0]], vertices[triangle[1]], vertices[triangle[2]]);
+    }
+  }
+}
+
+/** Matrix columns padded to four lanes. */
+template <int N> auto columns(const glm::mat<N, N, float> &m) {
+  std::array<Float4, N> result;
+  for (int i = 0; i < N; i++) {
+    result[i] = Float4(m[i][0], m[i][1], m[i][2], N == 4 ? m[i][3] : 0.0f);
+  }
+  return result;
+}
+
+/** Same association as glm, so results match glm::mat3 * glm::vec3. */
+auto rotate(const std::array<Float4, 3> &m, const glm::vec3 &v) -> Float4 {
+  return (m[0] * Float4(v.x) + m[1] * Float4(v.y)) + m[2] * Float4(v.z);
+}
+
+/** Same expression as glm::mix. */
+auto lerp(const glm::vec3 &from, const glm::vec3 &to, const Float4 &a,
+          const Float4 &one_minus_a) -> Float4 {
+  return Float4::load(&from.x) * one_minus_a + Float4::load(&to.x) * a;
+}
+
+/** Vertices per block, one per lane. */
+constexpr std::size_t block = 4;
+
+/** Positions of a block of vertices as streams of x, y and z. */
+struct Float4x3 {
+  Float4 x;
+  Float4 y;
+  Float4 z;
+};
+
+/** Loads read one float past each position, which is still within the
+ * vertex. */
+auto gather_positions(const Vertex *vertices) -> Float4x3 {
+  auto r0 = Float4::load(&vertices[0].position.x);
+  auto r1 = Float4::load(&vertices[1].position.x);
+  auto r2 = Float4::load(&vertices[2].position.x);
+  auto r3 = Float4::load(&vertices[3].position.x);
+  transpose(r0, r1, r2, r3);
+  return {r0, r1, r2};
+}
+
+} // namespace
+
+auto smooth_normals(std::span<Vertex> vertices,
+                    std::span<const Triangle_indices> triangles) -> void {
+  // Accumulated in triangle order, so each sum is the same as when gathering
+  // the adjacent triangles per vertex first.
+  std::vector<glm::vec3> sums(vertices.size(), glm::vec3(0.0f));
+  std::vector<bool> referenced(vertices.size(), false);
+  auto accumulate = [&](const int i0, const int i1, const int i2) {
+    const auto normal = glm::triangleNormal(
+        vertices[i0].position, vertices[i1].position, vertices[i2].position);
+    for (const auto i : {i0, i1, i2}) {
+      sums[i] += normal;
+      referenced[i] = true;
+    }
+  };
+  if (triangles.empty()) {
+    for (std::size_t i = 0; i + 2 < vertices.size(); i += 3) {
+      accumulate(int(i), int(i + 1), int(i + 2));
+    }
+  } else {
+    for (const auto &triangle : triangles) {
+      accumulate(triangle[0], triangle[1], triangle[2]);
+    }
+  }
+  for (std::size_t i = 0; i < vertices.size(); i++) {
+    if (referenced[i]) {
+      vertices[i].normal = glm::normalize(sums[i]);
+    }
+  }
+}
+
+auto flat_normals(std::span<Vertex> vertices,
+                  std::span<const Triangle_indices> triangles) -> void {
+  for_each_triangle(vertices, triangles,
+                    [](Vertex &v0, Vertex &v1, Vertex &v2) {
+                      const auto normal = glm::triangleNormal(
+                          v0.position, v1.position, v2.position);
+                      v0.normal = normal;
+                      v1.normal = normal;
+                      v2.normal = normal;
+                    });
+}
+
+auto tangents(std::span<Vertex> vertices,
+              std::span<const Triangle_indices> triangles) -> void {
+  for_each_triangle(vertices, triangles, [](Vertex &v0, Vertex &v1,
+                                            Vertex &v2) {
+    const glm::vec3 edge1 = v1.position - v0.position;
+    const glm::vec3 edge2 = v2.position - v0.position;
+    const glm::vec2 delta_uv1 = v1.uv - v0.uv;
+    const glm::vec2 delta_uv2 = v2.uv - v0.uv;
+
+    const float f =
+        1.0F / (delta_uv1.x * delta_uv2.y - delta_uv2.x * delta_uv1.y);
+
+    glm::vec3 tangent;
+    tangent.x = f * (delta_uv2.y * edge1.x - delta_uv1.y * edge2.x);
+    tangent.y = f * (delta_uv2.y * edge1.y - delta_uv1.y * edge2.y);
+    tangent.z = f * (delta_uv2.y * edge1.z - delta_uv1.y * edge2.z);
+    tangent = glm::normalize(tangent);
+
+    v0.tangent = tangent;
+    v1.tangent = tangent;
+    v2.tangent = tangent;
+  });
+}
+
+// Transform and mix take one vertex per Float4, as vertices are interleaved
+// for upload. Transposing blocks of four to x, y and z streams and back costs
+// more shuffles than the unused lane.
+auto transform(std::span<Vertex> vertices, const glm::mat4 &transform,
+               const Execution execution) -> void {
+  const auto m = columns<4>(transform);
+  const auto n = columns<3>(glm::mat3(glm::inverseTranspose(transform)));
+  for_chunks(execution, vertices.size(),
+             [&](std::size_t, const std::size_t begin, const std::size_t end) {
+               for (auto i = begin; i < end; i++) {
+                 auto &vertex = vertices[i];
+                 const auto &p = vertex.position;
+                 const auto position = (m[0] * Float4(p.x) + m[1] * Float4(p.y)) +
+                                       (m[2] * Float4(p.z) + m[3]);
+                 const auto normal = rotate(n, vertex.normal);
+                 const auto tangent = rotate(n, vertex.tangent);
+                 position.store3(&vertex.position.x);
+                 normal.store3(&vertex.normal.x);
+                 tangent.store3(&vertex.tangent.x);
+               }
+             });
+}
+
+auto mix(std::span<Vertex> vertices, std::span<const Vertex> from,
+         std::span<const Vertex> to, const float amount,
+         const Execution execution) -> void {
+  const Float4 a(amount);
+  const Float4 one_minus_a(1.0f - amount);
+  for_chunks(execution, vertices.size(),
+             [&](std::size_t, const std::size_t begin, const std::size_t end) {
+               for (auto i = begin; i < end; i++) {
+                 auto &vertex = vertices[i];
+                 // Loads read one float past each vec3, which is still
+                 // within the vertex.
+                 const auto position =
+                     lerp(from[i].position, to[i].position, a, one_minus_a);
+                 const auto normal =
+                     lerp(from[i].normal, to[i].normal, a, one_minus_a);
+                 position.store3(&vertex.position.x);
+                 normal.store3(&vertex.normal.x);
+                 vertex.uv = glm::mix(from[i].uv, to[i].uv, amount);
+               }
+             });
+}
+
+auto bounding_sphere(std::span<const Vertex> vertices,
+                     const Execution execution) -> Sphere {
+  const auto count = vertices.size();
+  std::vector<Float4> sums(num_chunks(execution, count), Float4(0.0f));
+  for_chunks(execution, count,
+             [&](const std::size_t chunk, const std::size_t begin,
+                 const std::size_t end) {
+               auto sum = Float4(0.0f);
+               for (auto i = begin; i < end; i++) {
+                 sum = sum + Float4::load(&vertices[i].position.x);
+               }
+               sums[chunk] = sum;
+             });
+  auto sum = Float4(0.0f);
+  for (const auto &s : sums) {
+    sum = sum + s;
+  }
+
+  Sphere sphere;
+  sphere.centroid = glm::vec3(sum[0], sum[1], sum[2]) / float(count);
+
+  // Squared distances of four vertices at a time, one per lane, instead of
+  // summing the lanes of each.
+  const Float4x3 centroid{Float4(sphere.centroid.x), Float4(sphere.centroid.y),
+                          Float4(sphere.centroid.z)};
+  std::vector<float> maximums(sums.size(), 0.0f);
+  for_chunks(execution, count,
+             [&](const std::size_t chunk, const std::size_t begin,
+                 const std::size_t end) {
+               auto lanes = Float4(0.0f);
+               auto i = begin;
+               for (; i + block <= end; i += block) {
+                 const auto p = gather_positions(&vertices[i]);
+                 const auto dx = p.x - centroid.x;
+                 const auto dy = p.y - centroid.y;
+                 const auto dz = p.z - centroid.z;
+                 lanes = max(lanes, (dx * dx + dy * dy) + dz * dz);
+               }
+               float maximum = std::max(std::max(lanes[0], lanes[1]),
+                                        std::max(lanes[2], lanes[3]));
+               for (; i < end; i++) {
+                 const auto d = vertices[i].position - sphere.centroid;
+                 maximum =
+                     std::max(maximum, (d.x * d.x + d.y * d.y) + d.z * d.z);
+               }
+               maximums[chunk] = maximum;
+             });
+  // sqrt is monotonic, so the root of the largest square is the largest
+  // distance.
+  sphere.radius =
+      std::sqrt(*std::max_element(maximums.begin(), maximums.end()));
+  return sphere;
+}
+
+} // namespace mos::gfx::kernels
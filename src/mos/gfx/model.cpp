@@ -1,9 +1,9 @@
 #include <filesystem>
 #include <iostream>
-#include <spdlog/spdlog.h>
 #include <mos/gfx/model.hpp>
 #include <mos/util.hpp>
 #include <mos/gfx/material.hpp>
+#include <mos/gfx/model_description.hpp>
 #include <glm/gtx/io.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
@@ -20,32 +20,18 @@ Model::Model(std::string name,
       name_(std::move(name)) {}
 
 auto Model::load(const nlohmann::json &json, Assets &assets,  const glm::mat4 &parent_transform) -> Model {
-  auto parsed = json;
-  if (parsed.is_string()) {
-    spdlog::info("Loading: {}", parsed);
-    std::string path = parsed;
-    parsed = nlohmann::json::parse(mos::text(assets.directory() + path));
-  }
-  auto name = parsed.value("name", "");
-  auto mesh_path = std::string("");
-  if (!parsed["mesh"].is_null()) {
-    mesh_path = parsed.value("mesh", "");
-  }
-  std::string material_path;
-  if (!parsed["material"].is_null()) {
-    material_path = parsed.value("material", "");
-  }
-
-  auto mesh = assets.mesh(mesh_path);
-  auto transform = parent_transform * jsonarray_to_mat4(parsed["transform"]);
-  auto material = Material::load(assets, material_path);
+  auto model = json.is_string() ? assets.model(json.get<std::string>())
+                                : load(Model_description::parse(json), assets);
+  model.transform = parent_transform * model.transform;
+  return model;
+}
 
-  auto model = Model(name, mesh, transform, material);
-  for (auto &m : parsed["children"]) {
-    const std::string str_path = m;
-    std::filesystem::path path = str_path;
-    if (path.extension() == ".model") {
-      model.models.push_back(load(path.generic_string(), assets));
+auto Model::load(const Model_description &description, Assets &assets) -> Model {
+  auto model = Model(description.name, assets.mesh(description.mesh),
+                     description.transform, assets.material(description.material));
+  for (const auto &child : description.children) {
+    if (std::filesystem::path(child).extension() == ".model") {
+      model.models.push_back(assets.model(child));
     }
   }
   return model;
@@ -0,0 +1,122 @@
+#include <mos/gfx/model_description.hpp>
+#include <array>
+#include <stdexcept>
+#include <glm/gtc/type_ptr.hpp>
+#include <mos/core/mapped_file.hpp>
+#include <mos/util.hpp>
+
+namespace mos::gfx {
+
+namespace {
+
+using json = nlohmann::json;
+
+/** SAX events to description fields. Values nested below the fields are
+ * skipped. */
+class Model_handler {
+public:
+  explicit Model_handler(Model_description &description)
+      : description_(description) {}
+
+  bool null() { return true; }
+  bool boolean(bool) { return true; }
+  bool number_integer(const json::number_integer_t value) {
+    return number(float(value));
+  }
+  bool number_unsigned(const json::number_unsigned_t value) {
+    return number(float(value));
+  }
+  bool number_float(const json::number_float_t value, const json::string_t &) {
+    return number(float(value));
+  }
+  bool string(json::string_t &value) {
+    if (depth_ == 1) {
+      if (key_ == "name") {
+        description_.name = value;
+      } else if (key_ == "mesh") {
+        description_.mesh = value;
+      } else if (key_ == "material") {
+        description_.material = value;
+      }
+    } else if (depth_ == 2 && key_ == "children") {
+      description_.children.push_back(value);
+    }
+    return true;
+  }
+  bool binary(json::binary_t &) { return true; }
+  bool start_object(std::size_t) {
+    depth_++;
+    return true;
+  }
+  bool end_object() {
+    depth_--;
+    return true;
+  }
+  bool start_array(std::size_t) {
+    depth_++;
+    return true;
+  }
+  bool end_array() {
+    depth_--;
+    if (depth_ == 1 && key_ == "transform" && num_values_ == values_.size()) {
+      description_.transform = glm::make_mat4x4(values_.data());
+    }
+    return true;
+  }
+  bool key(json::string_t &key) {
+    if (depth_ == 1) {
+      key_ = key;
+    }
+    return true;
+  }
+  bool parse_error(std::size_t, const std::string &,
+                   const nlohmann::detail::exception &exception) {
+    throw std::runtime_error(exception.what());
+  }
+
+private:
+  bool number(const float value) {
+    if (depth_ == 2 && key_ == "transform" && num_values_ < values_.size()) {
+      values_[num_values_++] = value;
+    }
+    return true;
+  }
+
+  Model_description &description_;
+  int depth_{0};
+  std::string key_;
+  std::array<float, 16> values_{};
+  std::size_t num_values_{0};
+};
+
+} // namespace
+
+auto Model_description::parse(const nlohmann::json &json) -> Model_description {
+  Model_description description;
+  description.name = json.value("name", "");
+  if (json.contains("mesh") && !json["mesh"].is_null()) {
+    description.mesh = json["mesh"];
+  }
+  if (json.contains("material") && !json["material"].is_null()) {
+    description.material = json["material"];
+  }
+  if (json.contains("transform")) {
+    description.transform = jsonarray_to_mat4(json["transform"]);
+  }
+  if (json.contains("children")) {
+    for (const auto &child : json["children"]) {
+      description.children.push_back(child);
+    }
+  }
+  return description;
+}
+
+auto Model_description::read(const std::string &path) -> Model_description {
+  const Mapped_file file(path);
+  const auto *begin = reinterpret_cast<const char *>(file.data());
+  Model_description description;
+  Model_handler handler(description);
+  json::sax_parse(begin, begin + file.size(), &handler);
+  return description;
+}
+} // namespace mos::gfx
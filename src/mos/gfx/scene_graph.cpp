@@ -0,0 +1,129 @@
+#include <stdexcept>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <mos/core/thread_pool.hpp>
+#include <mos/gfx/scene_graph.hpp>
+
+namespace mos::gfx {
+
+namespace {
+
+constexpr auto max_age = std::numeric_limits<std::uint32_t>::max();
+
+} // namespace
+
+auto Scene_graph::clear() -> void {
+  parents_.clear();
+  locals_.clear();
+  bounds_.clear();
+  changed_.clear();
+  ages_.clear();
+  worlds_.clear();
+  normals_.clear();
+  spheres_.clear();
+  updated_.clear();
+}
+
+auto Scene_graph::add(const Index parent, const glm::mat4 &local,
+                      const Bvh::Sphere &bounds) -> Index {
+  const auto index = Index(parents_.size());
+  if (parent != none && parent >= index) {
+    throw std::runtime_error("Parent must be added before its children.");
+  }
+  parents_.push_back(parent);
+  locals_.push_back(local);
+  bounds_.push_back(bounds);
+  changed_.push_back(1);
+  ages_.push_back(0);
+  worlds_.emplace_back(1.0f);
+  normals_.emplace_back(1.0f);
+  spheres_.emplace_back();
+  return index;
+}
+
+auto Scene_graph::local(const Index node, const glm::mat4 &local) -> void {
+  if (locals_[node] != local) {
+    locals_[node] = local;
+    changed_[node] = 1;
+  }
+}
+
+auto Scene_graph::bounds(const Index node, const Bvh::Sphere &bounds)
+    -> void {
+  if (bounds_[node].center != bounds.center ||
+      bounds_[node].radius != bounds.radius) {
+    bounds_[node] = bounds;
+    changed_[node] = 1;
+  }
+}
+
+auto Scene_graph::update(const kernels::Execution execution) -> void {
+  updated_.clear();
+  for (Index i = 0; i < Index(parents_.size()); i++) {
+    const auto parent = parents_[i];
+    if (parent == none) {
+      if (changed_[i]) {
+        worlds_[i] = locals_[i];
+        updated_.push_back(i);
+      }
+    } else if (changed_[i] || changed_[parent]) {
+      changed_[i] = 1;
+      worlds_[i] = worlds_[parent] * locals_[i];
+      updated_.push_back(i);
+    }
+  }
+  for (std::size_t i = 0; i < ages_.size(); i++) {
+    ages_[i] = changed_[i] ? 0 : ages_[i] + (ages_[i] != max_age);
+  }
+  std::fill(changed_.begin(), changed_.end(), 0);
+
+  const auto derive = [&](std::size_t, const std::size_t begin,
+                          const std::size_t end) {
+    for (auto u = begin; u < end; u++) {
+      const auto i = updated_[u];
+      const auto &world = worlds_[i];
+      normals_[i] = glm::mat4(glm::inverseTranspose(glm::mat3(world)));
+      const auto scale = glm::max(glm::max(glm::length(glm::vec3(world[0])),
+                                           glm::length(glm::vec3(world[1]))),
+                                  glm::length(glm::vec3(world[2])));
+      const auto &bounds = bounds_[i];
+      spheres_[i] = {glm::vec3(world * glm::vec4(bounds.center, 1.0f)),
+                     bounds.radius < 0.0f ? bounds.radius
+                                          : bounds.radius * scale};
+    }
+  };
+  const bool parallel =
+      execution == kernels::Execution::Parallel ||
+      (execution == kernels::Execution::Automatic &&
+       updated_.size() >= kernels::parallel_threshold);
+  if (parallel) {
+    Thread_pool::shared().parallel_for(updated_.size(), derive);
+  } else {
+    derive(0, 0, updated_.size());
+  }
+}
+
+auto Scene_graph::parent(const Index node) const -> Index {
+  return parents_[node];
+}
+
+auto Scene_graph::world(const Index node) const -> const glm::mat4 & {
+  return worlds_[node];
+}
+
+auto Scene_graph::normal(const Index node) const -> const glm::mat4 & {
+  return normals_[node];
+}
+
+auto Scene_graph::age(const Index node) const -> std::uint32_t {
+  return ages_[node];
+}
+
+auto Scene_graph::spheres() const -> std::span<const Bvh::Sphere> {
+  return spheres_;
+}
+
+auto Scene_graph::size() const -> std::size_t { return parents_.size(); }
+
+auto Scene_graph::stats() const -> Stats { return Stats{updated_.size()}; }
+
+} // namespace mos::gfx
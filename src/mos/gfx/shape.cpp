@@ -5,6 +5,8 @@ namespace mos::gfx {
 auto Shape::id() const -> unsigned int {
   return id_;
 }
+
+auto Shape::generation() const -> std::uint32_t { return id_.generation(); }
 }
 
 
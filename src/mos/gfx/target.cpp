@@ -4,4 +4,8 @@ namespace mos::gfx {
 
 auto Target::id() const -> int { return id_; }
 
+auto Target::generation() const -> std::uint32_t {
+  return id_.generation();
+}
+
 }
@@ -10,4 +10,6 @@ Texture::Texture(const Filter &filter, const Wrap &wrap, const bool generate_mip
 
 auto Texture::id() const -> int { return id_; }
 
+auto Texture::generation() const -> std::uint32_t { return id_.generation(); }
+
 } // namespace mos::gfx
@@ -1,5 +1,8 @@
 #include <iostream>
+#include <filesystem>
 #include <mos/gfx/texture_2d.hpp>
+#include <mos/gfx/block_compression.hpp>
+#include <cstring>
 #include <map>
 #include <stb_image.h>
 
@@ -11,10 +14,24 @@ Texture_2D::Texture_2D(const int width,
                        const Filter &filter,
                        const Wrap &wrap,
                        const bool generate_mipmaps)
-  :  Texture(filter, wrap, generate_mipmaps), texture_(format, gli::extent2d(width, height)) {}
+  :  Texture(filter, wrap, generate_mipmaps), texture_(format, gli::extent2d(width, height), 1) {}
+
+Texture_2D::Texture_2D(gli::texture2d texture,
+                       const Filter &filter,
+                       const Wrap &wrap,
+                       const bool generate_mipmaps)
+  :  Texture(filter, wrap, generate_mipmaps), texture_(std::move(texture)) {}
 
 auto Texture_2D::load(const std::string &path, bool color_data, bool generate_mipmaps, const Texture::Filter &filter, const Texture::Wrap &wrap) -> Texture_2D
 {
+  const auto extension = std::filesystem::path(path).extension();
+  if (extension == ".ktx" || extension == ".dds") {
+    gli::texture2d texture(gli::load(path));
+    if (texture.empty()) {
+      throw std::runtime_error("Could not read texture: " + path);
+    }
+    return Texture_2D(std::move(texture), filter, wrap, generate_mipmaps);
+  }
 
   std::map<int, gli::format> gli_map{{1, gli::FORMAT_R8_UNORM_PACK8},
                                      {2, gli::FORMAT_RG8_UNORM_PACK8},
@@ -28,24 +45,108 @@ auto Texture_2D::load(const std::string &path, bool color_data, bool generate_mi
     throw std::runtime_error("Could not read texture: " + path);
   }
 
-  return Texture_2D(pixels, pixels + width * height * bpp,
-                    width, height,
-                    gli_map[bpp],
-                    filter,
-                    wrap,
-                    generate_mipmaps);
+  auto texture = Texture_2D(pixels, pixels + width * height * bpp,
+                            width, height,
+                            gli_map[bpp],
+                            filter,
+                            wrap,
+                            generate_mipmaps);
+  stbi_image_free(pixels);
+  return texture;
+}
+
+auto Texture_2D::save(const std::string &path) const -> void {
+  if (!gli::save(texture_, path)) {
+    throw std::runtime_error("Could not write texture: " + path);
+  }
+}
+
+auto Texture_2D::build_mipmaps() -> void {
+  if (compressed()) {
+    throw std::runtime_error("Can not build mipmaps for a compressed texture.");
+  }
+  gli::texture2d texture(texture_.format(), texture_.extent(), texture_.swizzles());
+  std::memcpy(texture.data(0, 0, 0), texture_.data(0, 0, 0), texture_.size(0));
+  texture_ = gli::generate_mipmaps(texture, gli::FILTER_LINEAR);
+}
+
+auto Texture_2D::compress() const -> Texture_2D {
+  static const std::map<gli::format, gli::format> formats{
+      {gli::FORMAT_R8_UNORM_PACK8, gli::FORMAT_R_ATI1N_UNORM_BLOCK8},
+      {gli::FORMAT_RG8_UNORM_PACK8, gli::FORMAT_RG_ATI2N_UNORM_BLOCK16},
+      {gli::FORMAT_RGB8_UNORM_PACK8, gli::FORMAT_RGB_DXT1_UNORM_BLOCK8},
+      {gli::FORMAT_RGB8_SRGB_PACK8, gli::FORMAT_RGB_DXT1_SRGB_BLOCK8},
+      {gli::FORMAT_RGBA8_UNORM_PACK8, gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16},
+      {gli::FORMAT_RGBA8_SRGB_PACK8, gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16}};
+  const auto format = formats.find(texture_.format());
+  if (format == formats.end()) {
+    throw std::runtime_error("Texture format can not be compressed.");
+  }
+  const auto channels = int(gli::component_count(texture_.format()));
+  const auto block_size = gli::block_size(format->second);
+
+  gli::texture2d texture(format->second, texture_.extent(), texture_.levels(), texture_.swizzles());
+  for (int level = 0; level < levels(); level++) {
+    const auto w = width(level);
+    const auto h = height(level);
+    const auto blocks_x = (w + 3) / 4;
+    const auto *source = static_cast<const std::uint8_t *>(data(level));
+    auto *destination = static_cast<std::uint8_t *>(texture.data(0, 0, level));
+    for (int by = 0; by < (h + 3) / 4; by++) {
+      for (int bx = 0; bx < blocks_x; bx++) {
+        // Levels smaller than a block repeat their edge pixels.
+        Pixel_block pixels{};
+        for (int y = 0; y < 4; y++) {
+          for (int x = 0; x < 4; x++) {
+            const auto sx = std::min(bx * 4 + x, w - 1);
+            const auto sy = std::min(by * 4 + y, h - 1);
+            auto &pixel = pixels[y * 4 + x];
+            pixel[3] = 255;
+            std::memcpy(pixel.data(), source + (sy * w + sx) * channels, channels);
+          }
+        }
+        auto *block = destination + (by * blocks_x + bx) * block_size;
+        if (channels == 1) {
+          const auto encoded = encode_bc4(pixels);
+          std::memcpy(block, encoded.data(), encoded.size());
+        } else if (channels == 2) {
+          const auto encoded = encode_bc5(pixels);
+          std::memcpy(block, encoded.data(), encoded.size());
+        } else if (channels == 3) {
+          const auto encoded = encode_bc1(pixels);
+          std::memcpy(block, encoded.data(), encoded.size());
+        } else {
+          const auto encoded = encode_bc3(pixels);
+          std::memcpy(block, encoded.data(), encoded.size());
+        }
+      }
+    }
+  }
+  return Texture_2D(std::move(texture), filter, wrap, generate_mipmaps);
+}
+
+auto Texture_2D::levels() const -> int {
+  return int(texture_.levels());
+}
+
+auto Texture_2D::compressed() const -> bool {
+  return gli::is_compressed(texture_.format());
+}
+
+auto Texture_2D::size(const int level) const -> std::size_t {
+  return texture_.size(level);
 }
 
-auto Texture_2D::width() const -> int {
-  return texture_.extent().x;
+auto Texture_2D::width(const int level) const -> int {
+  return texture_.extent(level).x;
 }
 
-auto Texture_2D::height() const -> int {
-  return texture_.extent().y;
+auto Texture_2D::height(const int level) const -> int {
+  return texture_.extent(level).y;
 }
 
-auto Texture_2D::data() const -> const void* {
-  return texture_.data();
+auto Texture_2D::data(const int level) const -> const void* {
+  return texture_.data(0, 0, level);
 }
 
 auto Texture_2D::format() const -> gli::format {
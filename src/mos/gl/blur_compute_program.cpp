@@ -0,0 +1,22 @@
+#include <mos/gl/renderer.hpp>
+#include <mos/util.hpp>
+
+namespace mos::gl {
+Blur_compute_program::Blur_compute_program() {
+  const std::string name = "blur";
+
+  const auto compute_shader = Shader(name, GL_COMPUTE_SHADER);
+
+  glAttachShader(program, compute_shader.id);
+  link(name);
+  check(name);
+
+  glDetachShader(program, compute_shader.id);
+  input_sampler = glGetUniformLocation(program, "input_sampler");
+  source = glGetUniformLocation(program, "source");
+  destination = glGetUniformLocation(program, "destination");
+  radius = glGetUniformLocation(program, "radius");
+  weights = glGetUniformLocation(program, "weights");
+  moments = glGetUniformLocation(program, "moments");
+}
+} // namespace mos::gfx
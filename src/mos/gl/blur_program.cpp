@@ -20,5 +20,6 @@ Blur_program::Blur_program() {
   glDetachShader(program, fragment_shader.id);
   color_sampler = glGetUniformLocation(program, "color_sampler");
   horizontal = glGetUniformLocation(program, "horizontal");
+  region = glGetUniformLocation(program, "region");
 }
 } // namespace mos::gfx
@@ -3,14 +3,17 @@
 namespace mos::gl {
 
 Buffer::Buffer(GLenum type, GLsizeiptr size, const void *data,
-                         GLenum hint, Time_point modified)
-    : id(Renderer::generate(glGenBuffers)), modified(modified) {
+                         GLenum hint, Generation generation)
+    : id(Renderer::generate(glGenBuffers)), size(size), capacity(size),
+      generation(generation) {
   glBindBuffer(type, id);
   glBufferData(type, size, data, hint);
   glBindBuffer(type, 0);
 }
 
-Buffer::Buffer(Buffer &&buffer) noexcept : id(buffer.id) {
+Buffer::Buffer(Buffer &&buffer) noexcept
+    : id(buffer.id), size(buffer.size), capacity(buffer.capacity),
+      generation(buffer.generation) {
   buffer.id = 0;
 }
 
@@ -19,6 +22,9 @@ Buffer::operator=(Buffer &&buffer) noexcept -> Buffer & {
   if (this != &buffer) {
     release();
     std::swap(id, buffer.id);
+    std::swap(size, buffer.size);
+    std::swap(capacity, buffer.capacity);
+    std::swap(generation, buffer.generation);
   }
   return *this;
 }
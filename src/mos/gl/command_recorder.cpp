@@ -0,0 +1,78 @@
+#include <bit>
+#include <mos/gl/command_recorder.hpp>
+
+namespace mos::gl {
+
+auto Command_recorder::record(const std::span<const Pass> passes,
+                              const std::span<const Drawable> drawables,
+                              const gfx::Scene_graph &graph,
+                              Thread_pool *pool) -> void {
+  // Lists are kept between frames, to reuse their memory.
+  if (lists_.size() < passes.size()) {
+    lists_.resize(passes.size());
+  }
+  size_ = passes.size();
+  const auto record_range = [&](std::size_t, const std::size_t begin,
+                                const std::size_t end) {
+    for (auto i = begin; i < end; i++) {
+      record(passes[i], drawables, graph, lists_[i]);
+    }
+  };
+  if (pool && passes.size() > 1) {
+    pool->parallel_for(passes.size(), record_range);
+  } else {
+    record_range(0, 0, passes.size());
+  }
+}
+
+auto Command_recorder::record(const Pass &pass,
+                              const std::span<const Drawable> drawables,
+                              const gfx::Scene_graph &graph,
+                              Draw_list &list) const -> void {
+  list.clear();
+  const auto spheres = graph.spheres();
+  for (auto word = pass.begin / 64; word * 64 < pass.end; word++) {
+    auto bits = pass.visible[word];
+    while (bits != 0) {
+      const auto i = word * 64 + std::size_t(std::countr_zero(bits));
+      bits &= bits - 1;
+      if (i < pass.begin || i >= pass.end) {
+        continue;
+      }
+      const auto &drawable = drawables[i];
+      if (drawable.vertex_array == 0) {
+        continue;
+      }
+      Draw draw;
+      draw.program = pass.program;
+      draw.vertex_array = drawable.vertex_array;
+      if (pass.depth) {
+        draw.textures = {drawable.textures[0]};
+        draw.material.albedo = drawable.material.albedo;
+        draw.material.emission = drawable.material.emission;
+      } else {
+        draw.textures = drawable.textures;
+        draw.material = drawable.material;
+      }
+      draw.transform = graph.world(i);
+      draw.normal = &graph.normal(i);
+      draw.first_index = drawable.first_index;
+      draw.base_vertex = drawable.base_vertex;
+      draw.num_indices = drawable.num_indices;
+      draw.vertex_generation = drawable.vertex_generation;
+      draw.index_generation = drawable.index_generation;
+      draw.distance = glm::distance(pass.eye, spheres[i].center);
+      list.add(draw);
+    }
+  }
+  list.prepare(pass.order);
+}
+
+auto Command_recorder::list(const std::size_t pass) const
+    -> const Draw_list & {
+  return lists_.at(pass);
+}
+
+auto Command_recorder::size() const -> std::size_t { return size_; }
+
+} // namespace mos::gl
@@ -13,15 +13,14 @@ Depth_program::Depth_program() {
   glAttachShader(program, fragment_shader.id);
   glBindAttribLocation(program, 0, "position");
   glBindAttribLocation(program, 3, "uv");
+  glBindAttribLocation(program, Mesh_arena::instance_attribute,
+                       "instance_index");
   link(name);
   check(name);
   glDetachShader(program, vertex_shader.id);
   glDetachShader(program, fragment_shader.id);
 
-  model_view_projection =
-      glGetUniformLocation(program, "model_view_projection");
+  view_projection = glGetUniformLocation(program, "view_projection");
   albedo_sampler = glGetUniformLocation(program, "albedo_sampler");
-  albedo = glGetUniformLocation(program, "albedo");
-  emission = glGetUniformLocation(program, "emission");
 }
 } // namespace mos::gfx
@@ -0,0 +1,230 @@
+#include <mos/gl/draw_list.hpp>
+#include <algorithm>
+#include <bit>
+#include <glm/gtc/matrix_inverse.hpp>
+
+namespace mos::gl {
+
+namespace {
+
+auto combine(const std::uint32_t hash, const std::uint32_t value)
+    -> std::uint32_t {
+  return (hash ^ value) * 16777619u;
+}
+
+/** Positive floats order as their bits, keep the top 16. */
+auto depth_bits(const float distance) -> std::uint64_t {
+  return std::bit_cast<std::uint32_t>(std::max(distance, 0.0f)) >> 15;
+}
+
+} // namespace
+
+auto Material_uniforms::hash() const -> std::uint32_t {
+  std::uint32_t hash = 2166136261u;
+  for (const auto value :
+       {albedo.x, albedo.y, albedo.z, emission.x, emission.y, emission.z,
+        roughness, metallic, index_of_refraction, alpha, transmission,
+        ambient_occlusion}) {
+    hash = combine(hash, std::bit_cast<std::uint32_t>(value));
+  }
+  return hash;
+}
+
+auto Material_uniforms::translucent() const -> bool {
+  return alpha < 1.0f || transmission > 0.0f;
+}
+
+auto Draw_list::Stats::operator+=(const Stats &stats) -> Stats & {
+  draws += stats.draws;
+  programs += stats.programs;
+  vertex_arrays += stats.vertex_arrays;
+  textures += stats.textures;
+  materials += stats.materials;
+  batches += stats.batches;
+  multi_draws += stats.multi_draws;
+  return *this;
+}
+
+auto Draw_list::key(const Draw &draw) -> std::uint64_t {
+  std::uint32_t textures = 2166136261u;
+  for (const auto texture : draw.textures) {
+    textures = combine(textures, texture);
+  }
+  const auto mesh =
+      combine(combine(2166136261u, draw.vertex_array), draw.first_index);
+  const std::uint64_t state =
+      std::uint64_t(draw.program & 0xF) << 43 |
+      std::uint64_t(textures & 0xFFFF) << 27 |
+      std::uint64_t(draw.material.hash() & 0x7FFF) << 12 |
+      std::uint64_t(mesh & 0xFFF);
+  if (draw.material.translucent()) {
+    return std::uint64_t(1) << 63 | (0xFFFF - depth_bits(draw.distance)) << 47 |
+           state;
+  }
+  // Front to back last, it only matters between draws with the same state.
+  return state << 16 | depth_bits(draw.distance);
+}
+
+auto Draw_list::add(const Draw &draw) -> void {
+  draws_.push_back(draw);
+  draws_.back().key = key(draw);
+}
+
+auto Draw_list::clear() -> void {
+  draws_.clear();
+  batches_.clear();
+  instances_.clear();
+  materials_.clear();
+  commands_.clear();
+  opaque_batches_ = 0;
+  stats_ = Stats{};
+}
+
+auto Draw_list::prepare(const Order order) -> void {
+  if (order == Order::Key) {
+    std::sort(draws_.begin(), draws_.end(),
+              [](const Draw &a, const Draw &b) { return a.key < b.key; });
+  } else if (order == Order::Depth) {
+    std::sort(draws_.begin(), draws_.end(), [](const Draw &a, const Draw &b) {
+      const auto translucent_a = a.key >> 63;
+      const auto translucent_b = b.key >> 63;
+      if (translucent_a != translucent_b) {
+        return translucent_a < translucent_b;
+      }
+      if (translucent_a == 0 && a.distance != b.distance) {
+        return a.distance < b.distance;
+      }
+      return a.key < b.key;
+    });
+  }
+  stats_ = Stats{};
+  batches_.clear();
+  instances_.clear();
+  materials_.clear();
+  commands_.clear();
+  opaque_batches_ = 0;
+  instances_.reserve(draws_.size());
+  const Draw *previous = nullptr;
+  for (auto &draw : draws_) {
+    draw.program_changed = !previous || draw.program != previous->program;
+    draw.vertex_array_changed =
+        !previous || draw.vertex_array != previous->vertex_array;
+    draw.material_changed = !previous || draw.material != previous->material;
+    draw.textures_changed = 0;
+    for (std::size_t i = 0; i < draw.textures.size(); i++) {
+      if (!previous || draw.textures[i] != previous->textures[i]) {
+        draw.textures_changed |= std::uint8_t(1 << i);
+      }
+    }
+    stats_.draws++;
+    stats_.programs += draw.program_changed;
+    stats_.vertex_arrays += draw.vertex_array_changed;
+    stats_.materials += draw.material_changed;
+    stats_.textures += std::popcount(draw.textures_changed);
+    stats_.multi_draws += draw.program_changed || draw.vertex_array_changed ||
+                          draw.textures_changed != 0;
+
+    if (draw.material_changed) {
+      const auto &material = draw.material;
+      materials_.push_back(Material_block{
+          material.albedo, material.roughness, material.emission,
+          material.metallic, material.index_of_refraction, material.alpha,
+          material.transmission, material.ambient_occlusion});
+    }
+    const bool batched = previous && !draw.program_changed &&
+                         !draw.vertex_array_changed && !draw.material_changed &&
+                         draw.textures_changed == 0 &&
+                         draw.num_indices == previous->num_indices &&
+                         draw.first_index == previous->first_index &&
+                         draw.base_vertex == previous->base_vertex;
+    if (batched) {
+      batches_.back().count++;
+      commands_.back().instance_count++;
+    } else {
+      const auto first = std::uint32_t(instances_.size());
+      batches_.push_back(Batch{first, std::uint32_t(1)});
+      if (!draw.material.translucent() &&
+          opaque_batches_ == batches_.size() - 1) {
+        opaque_batches_++;
+      }
+      commands_.push_back(Draw_command{std::uint32_t(draw.num_indices * 3), 1,
+                                       draw.first_index, draw.base_vertex,
+                                       first});
+    }
+    instances_.push_back(Instance{
+        draw.transform,
+        draw.normal
+            ? *draw.normal
+            : glm::mat4(glm::inverseTranspose(glm::mat3(draw.transform))),
+        std::uint32_t(materials_.size() - 1)});
+    previous = &draw;
+  }
+  stats_.batches = int(batches_.size());
+}
+
+auto Draw_list::batches() const -> const std::vector<Batch> & {
+  return batches_;
+}
+
+auto Draw_list::instances() const -> const std::vector<Instance> & {
+  return instances_;
+}
+
+auto Draw_list::materials() const -> const std::vector<Material_block> & {
+  return materials_;
+}
+
+auto Draw_list::commands() const -> const std::vector<Draw_command> & {
+  return commands_;
+}
+
+auto Draw_list::opaque_batches() const -> std::size_t {
+  return opaque_batches_;
+}
+
+auto Draw_list::hash() const -> std::uint64_t {
+  std::uint64_t hash = 14695981039346656037ull;
+  const auto add = [&hash](const std::uint32_t value) {
+    hash = (hash ^ value) * 1099511628211ull;
+  };
+  for (std::size_t i = 0; i < batches_.size(); i++) {
+    const auto &command = commands_[i];
+    for (const auto value : {command.count, command.instance_count,
+                             command.first_index,
+                             std::uint32_t(command.base_vertex)}) {
+      add(value);
+    }
+    // Draws of a batch share the mesh, and so its generations.
+    const auto &draw = draws_[batches_[i].first];
+    for (const auto generation :
+         {draw.vertex_generation, draw.index_generation}) {
+      add(std::uint32_t(generation));
+      add(std::uint32_t(generation >> 32));
+    }
+    for (const auto texture : draw.textures) {
+      add(texture);
+    }
+  }
+  for (const auto &instance : instances_) {
+    for (int column = 0; column < 4; column++) {
+      for (int row = 0; row < 4; row++) {
+        add(std::bit_cast<std::uint32_t>(instance.model[column][row]));
+      }
+    }
+  }
+  return hash;
+}
+
+auto Draw_list::stats() const -> Stats { return stats_; }
+
+auto Draw_list::size() const -> std::size_t { return draws_.size(); }
+
+auto Draw_list::begin() const -> std::vector<Draw>::const_iterator {
+  return draws_.begin();
+}
+
+auto Draw_list::end() const -> std::vector<Draw>::const_iterator {
+  return draws_.end();
+}
+
+} // namespace mos::gl
@@ -25,7 +25,8 @@ Environment_map_target::Environment_map_target(
       data.push_back(0);
       data.push_back(0);
     }
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F,
+    // Four channels, as three channel formats can not be image stores.
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA16F,
                  render_buffer.resolution().x, render_buffer.resolution().y, 0,
                  GL_RGB, GL_UNSIGNED_BYTE, data.data());
   }
@@ -4,20 +4,20 @@ namespace mos::gl {
 
 Frame_buffer::Frame_buffer(
     const gfx::Texture_target &target,
-    std::unordered_map<unsigned int, Texture_buffer_2D> &texture_buffers,
-    std::unordered_map<unsigned int, Render_buffer> &render_buffers) {
+    Texture_buffers &texture_buffers,
+    Render_buffers &render_buffers) {
   glGenFramebuffers(1, &id);
   glBindFramebuffer(GL_FRAMEBUFFER, id);
 
-  texture_buffers.insert(
-      {target.texture->id(), Texture_buffer_2D(*target.texture)});
+  texture_buffers.insert(target.texture->id(),
+                         Texture_buffer_2D(*target.texture));
 
   glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
                          texture_buffers.at(target.texture->id()).texture, 0);
 
-  render_buffers.insert({target.target.id(),
-                         Render_buffer(glm::ivec2(target.texture->width(),
-                                                  target.texture->height()))});
+  render_buffers.insert(target.target.id(),
+                        Render_buffer(glm::ivec2(target.texture->width(),
+                                                 target.texture->height())));
 
   glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
                             GL_RENDERBUFFER,
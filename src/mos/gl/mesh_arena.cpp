@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <mos/gl/mesh_arena.hpp>
+
+namespace mos::gl {
+
+namespace {
+
+/** Upload the modified items of a container to its range of a buffer.
+ * @return False if nothing was modified. */
+template <class T>
+auto upload(const GLuint buffer, const std::uint32_t first,
+            const Tracked_container<T> &container,
+            Mesh_arena::Generation &generation, Ring_buffer &staging)
+    -> bool {
+  if (container.modified() == generation) {
+    return false;
+  }
+  std::size_t begin = 0;
+  std::size_t end = container.size();
+  const auto dirty = container.dirty();
+  if (generation == container.clean_generation() && !dirty.empty()) {
+    begin = dirty.begin;
+    end = std::min(std::size_t(dirty.end), end);
+  }
+  if (end > begin) {
+    Ring_buffer::copy(staging.write(container.data() + begin,
+                                    GLsizeiptr((end - begin) * sizeof(T))),
+                      buffer, GLintptr((first + begin) * sizeof(T)));
+  }
+  generation = container.modified();
+  container.mark_clean();
+  return true;
+}
+
+auto create_buffer(const GLsizeiptr size) -> GLuint {
+  GLuint buffer{0};
+  glCreateBuffers(1, &buffer);
+  glNamedBufferData(buffer, size, nullptr, GL_DYNAMIC_DRAW);
+  return buffer;
+}
+
+} // namespace
+
+Mesh_arena::Mesh_arena(const std::uint32_t vertices,
+                       const std::uint32_t triangles)
+    : min_vertices_(vertices), min_triangles_(triangles), vertices_(vertices),
+      triangles_(triangles) {
+  vertex_buffer_ =
+      create_buffer(GLsizeiptr(vertices) * GLsizeiptr(sizeof(gfx::Vertex)));
+  element_buffer_ = create_buffer(GLsizeiptr(triangles) *
+                                  GLsizeiptr(sizeof(gfx::Triangle_indices)));
+
+  glCreateVertexArrays(1, &vertex_array);
+  bind_buffers();
+  glVertexArrayAttribFormat(vertex_array, 0,
+                            decltype(gfx::Vertex::position)::length(),
+                            GL_FLOAT, GL_FALSE,
+                            offsetof(gfx::Vertex, position));
+  glVertexArrayAttribFormat(vertex_array, 1,
+                            decltype(gfx::Vertex::normal)::length(), GL_FLOAT,
+                            GL_FALSE, offsetof(gfx::Vertex, normal));
+  glVertexArrayAttribFormat(vertex_array, 2,
+                            decltype(gfx::Vertex::tangent)::length(),
+                            GL_FLOAT, GL_FALSE,
+                            offsetof(gfx::Vertex, tangent));
+  glVertexArrayAttribFormat(vertex_array, 3,
+                            decltype(gfx::Vertex::uv)::length(), GL_FLOAT,
+                            GL_FALSE, offsetof(gfx::Vertex, uv));
+  for (GLuint attribute = 0; attribute < 4; attribute++) {
+    glVertexArrayAttribBinding(vertex_array, attribute, 0);
+    glEnableVertexArrayAttrib(vertex_array, attribute);
+  }
+
+  // Instanced indices from binding 1, offset by the base instance of a draw.
+  glVertexArrayAttribIFormat(vertex_array, instance_attribute, 1,
+                             GL_UNSIGNED_INT, 0);
+  glVertexArrayAttribBinding(vertex_array, instance_attribute, 1);
+  glVertexArrayBindingDivisor(vertex_array, 1, 1);
+  glEnableVertexArrayAttrib(vertex_array, instance_attribute);
+  reserve_instances(1024);
+}
+
+Mesh_arena::~Mesh_arena() { release(); }
+
+auto Mesh_arena::allocate(Range_allocator &allocator, GLuint &buffer,
+                          const GLsizeiptr stride, const std::uint32_t size)
+    -> std::uint32_t {
+  if (const auto offset = allocator.allocate(size)) {
+    return *offset;
+  }
+  const auto capacity = allocator.capacity();
+  const auto grown = std::max(capacity * 2, capacity + size);
+  const auto copy = create_buffer(GLsizeiptr(grown) * stride);
+  glCopyNamedBufferSubData(buffer, copy, 0, 0, GLsizeiptr(capacity) * stride);
+  glDeleteBuffers(1, &buffer);
+  buffer = copy;
+  bind_buffers();
+  allocator.grow(grown);
+  grows_++;
+  const auto offset = allocator.allocate(size);
+  if (!offset) {
+    throw std::runtime_error("Mesh arena could not grow to fit a mesh.");
+  }
+  return *offset;
+}
+
+auto Mesh_arena::load(const gfx::Mesh &mesh, Ring_buffer &staging)
+    -> const Allocation & {
+  const auto vertices = std::uint32_t(mesh.vertices.size());
+  const auto triangles = std::uint32_t(mesh.indices.size());
+  const auto *loaded = allocations_.find(mesh.id());
+  if (loaded &&
+      (loaded->vertices != vertices || loaded->triangles != triangles)) {
+    unload(mesh.id());
+  }
+  if (!allocations_.contains(mesh.id())) {
+    Allocation allocation;
+    allocation.vertices = vertices;
+    allocation.triangles = triangles;
+    allocation.base_vertex = allocate(vertices_, vertex_buffer_,
+                                      sizeof(gfx::Vertex), vertices);
+    allocation.first_triangle =
+        allocate(triangles_, element_buffer_,
+                 sizeof(gfx::Triangle_indices), triangles);
+    allocations_.insert(mesh.id(), std::move(allocation));
+  }
+  auto &allocation = allocations_.at(mesh.id());
+  if (upload(vertex_buffer_, allocation.base_vertex, mesh.vertices,
+             allocation.vertex_generation, staging)) {
+    uploads_++;
+  }
+  if (upload(element_buffer_, allocation.first_triangle, mesh.indices,
+             allocation.index_generation, staging)) {
+    uploads_++;
+  }
+  return allocation;
+}
+
+auto Mesh_arena::load(const gfx::Mesh_file &file) -> const Allocation & {
+  if (const auto *loaded = allocations_.find(file.id())) {
+    return *loaded;
+  }
+  const auto vertices = file.vertices();
+  const auto indices = file.indices();
+  Allocation allocation;
+  allocation.vertices = std::uint32_t(vertices.size());
+  allocation.triangles = std::uint32_t(indices.size());
+  allocation.base_vertex = allocate(vertices_, vertex_buffer_,
+                                    sizeof(gfx::Vertex), allocation.vertices);
+  allocation.first_triangle =
+      allocate(triangles_, element_buffer_, sizeof(gfx::Triangle_indices),
+               allocation.triangles);
+  // Files do not change, so the generations only need to differ from unset.
+  allocation.vertex_generation = 0;
+  allocation.index_generation = 0;
+  glBindBuffer(GL_COPY_WRITE_BUFFER, vertex_buffer_);
+  glBufferSubData(GL_COPY_WRITE_BUFFER,
+                  GLintptr(allocation.base_vertex) *
+                      GLintptr(sizeof(gfx::Vertex)),
+                  GLsizeiptr(vertices.size_bytes()), vertices.data());
+  glBindBuffer(GL_COPY_WRITE_BUFFER, element_buffer_);
+  glBufferSubData(GL_COPY_WRITE_BUFFER,
+                  GLintptr(allocation.first_triangle) *
+                      GLintptr(sizeof(gfx::Triangle_indices)),
+                  GLsizeiptr(indices.size_bytes()), indices.data());
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  uploads_ += 2;
+  return allocations_.insert(file.id(), std::move(allocation));
+}
+
+auto Mesh_arena::unload(const unsigned int id) -> void {
+  if (const auto *allocation = allocations_.find(id)) {
+    vertices_.free(allocation->base_vertex, allocation->vertices);
+    triangles_.free(allocation->first_triangle, allocation->triangles);
+    allocations_.erase(id);
+  }
+}
+
+auto Mesh_arena::compact() -> bool {
+  // Each buffer on its own, since moved ranges change the draws and with
+  // them cached shadows.
+  const bool vertices = vertices_.shrinkable(min_vertices_);
+  const bool triangles = triangles_.shrinkable(min_triangles_);
+  if (vertices) {
+    compact(vertices_, vertex_buffer_, sizeof(gfx::Vertex),
+            &Allocation::base_vertex, &Allocation::vertices, min_vertices_);
+  }
+  if (triangles) {
+    compact(triangles_, element_buffer_, sizeof(gfx::Triangle_indices),
+            &Allocation::first_triangle, &Allocation::triangles,
+            min_triangles_);
+  }
+  if (!vertices && !triangles) {
+    return false;
+  }
+  bind_buffers();
+  compactions_++;
+  return true;
+}
+
+auto Mesh_arena::compact(Range_allocator &allocator, GLuint &buffer,
+                         const GLsizeiptr stride,
+                         std::uint32_t Allocation::*offset,
+                         std::uint32_t Allocation::*size,
+                         const std::uint32_t minimum) -> void {
+  std::vector<Range_allocator::Range> ranges;
+  ranges.reserve(allocations_.size());
+  for (const auto &allocation : allocations_) {
+    ranges.push_back({allocation.*offset, allocation.*size});
+  }
+  allocator.compact(ranges, std::max(allocator.stats().used, minimum));
+  const auto packed = create_buffer(GLsizeiptr(allocator.capacity()) * stride);
+  auto range = ranges.begin();
+  for (auto &allocation : allocations_) {
+    if (range->size > 0) {
+      glCopyNamedBufferSubData(buffer, packed,
+                               GLintptr(allocation.*offset) * stride,
+                               GLintptr(range->offset) * stride,
+                               GLsizeiptr(range->size) * stride);
+    }
+    allocation.*offset = range->offset;
+    range++;
+  }
+  glDeleteBuffers(1, &buffer);
+  buffer = packed;
+}
+
+auto Mesh_arena::bind_buffers() -> void {
+  glVertexArrayVertexBuffer(vertex_array, 0, vertex_buffer_, 0,
+                            sizeof(gfx::Vertex));
+  glVertexArrayElementBuffer(vertex_array, element_buffer_);
+}
+
+auto Mesh_arena::find(const unsigned int id) const -> const Allocation * {
+  return allocations_.find(id);
+}
+
+auto Mesh_arena::clear() -> void {
+  allocations_.clear();
+  vertices_.clear();
+  triangles_.clear();
+}
+
+auto Mesh_arena::reserve_instances(const std::uint32_t count) -> void {
+  if (count <= instances_) {
+    return;
+  }
+  instances_ = std::max(count, instances_ * 2);
+  std::vector<std::uint32_t> indices(instances_);
+  std::iota(indices.begin(), indices.end(), 0u);
+  glDeleteBuffers(1, &instance_buffer_);
+  glCreateBuffers(1, &instance_buffer_);
+  glNamedBufferStorage(instance_buffer_,
+                       GLsizeiptr(indices.size() * sizeof(std::uint32_t)),
+                       indices.data(), 0);
+  glVertexArrayVertexBuffer(vertex_array, 1, instance_buffer_, 0,
+                            sizeof(std::uint32_t));
+}
+
+auto Mesh_arena::stats() const -> Stats {
+  return Stats{vertices_.stats(), triangles_.stats(), grows_, compactions_,
+               uploads_};
+}
+
+void Mesh_arena::release() {
+  glDeleteVertexArrays(1, &vertex_array);
+  glDeleteBuffers(1, &vertex_buffer_);
+  glDeleteBuffers(1, &element_buffer_);
+  glDeleteBuffers(1, &instance_buffer_);
+  vertex_array = 0;
+}
+
+} // namespace mos::gl
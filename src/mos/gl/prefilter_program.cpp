@@ -0,0 +1,19 @@
+#include <mos/gl/renderer.hpp>
+#include <mos/util.hpp>
+
+namespace mos::gl {
+Prefilter_program::Prefilter_program() {
+  const std::string name = "prefilter";
+
+  const auto compute_shader = Shader(name, GL_COMPUTE_SHADER);
+
+  glAttachShader(program, compute_shader.id);
+  link(name);
+  check(name);
+
+  glDetachShader(program, compute_shader.id);
+  source_sampler = glGetUniformLocation(program, "source_sampler");
+  roughness = glGetUniformLocation(program, "roughness");
+  samples = glGetUniformLocation(program, "samples");
+}
+} // namespace mos::gfx
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <numeric>
+#include <mos/gl/probe_scheduler.hpp>
+
+namespace mos::gl {
+
+Probe_scheduler::Probe_scheduler(const int budget)
+    : budget_(std::max(budget, 1)) {}
+
+auto Probe_scheduler::budget(const int faces) -> void {
+  budget_ = std::max(faces, 1);
+}
+
+auto Probe_scheduler::budget() const -> int { return budget_; }
+
+auto Probe_scheduler::schedule(std::span<const Probe> probes) -> void {
+  entries_.resize(probes.size());
+  faces_.clear();
+  stats_ = Stats{};
+
+  std::vector<std::size_t> pending;
+  for (std::size_t i = 0; i < probes.size(); i++) {
+    auto &entry = entries_[i];
+    const auto &probe = probes[i];
+    if (!probe.enabled) {
+      entry = Entry{};
+      continue;
+    }
+    if (!entry.valid) {
+      entry = Entry{probe.state, 0, false, true};
+    } else if (probe.changed || entry.state != probe.state) {
+      // Faces already rendered of the cycle are stale, but starting over
+      // would never complete a probe that changes every frame.
+      entry.state = probe.state;
+      entry.dirty = entry.rendered > 0;
+    }
+    if (entry.rendered == cube_faces && entry.dirty) {
+      entry.rendered = 0;
+      entry.dirty = false;
+    }
+    if (entry.rendered == cube_faces) {
+      stats_.converged++;
+    } else {
+      pending.push_back(i);
+    }
+  }
+  stats_.pending = int(pending.size());
+
+  std::stable_sort(pending.begin(), pending.end(),
+                   [&](const std::size_t a, const std::size_t b) {
+                     return probes[a].distance < probes[b].distance;
+                   });
+
+  // One face per probe and round, so the nearest probe does not take the
+  // whole budget while the others wait.
+  bool progress = true;
+  while (progress && int(faces_.size()) < budget_) {
+    progress = false;
+    for (const auto i : pending) {
+      auto &entry = entries_[i];
+      if (int(faces_.size()) == budget_) {
+        break;
+      }
+      if (entry.rendered == cube_faces) {
+        continue;
+      }
+      faces_.push_back(Face{i, entry.rendered, entry.rendered + 1 == cube_faces});
+      entry.rendered++;
+      progress = true;
+    }
+  }
+  stats_.faces = int(faces_.size());
+}
+
+auto Probe_scheduler::faces() const -> const std::vector<Face> & {
+  return faces_;
+}
+
+auto Probe_scheduler::stats() const -> Stats { return stats_; }
+
+} // namespace mos::gl
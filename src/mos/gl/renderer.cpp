@@ -1,4 +1,5 @@
-﻿#include <cstdlib>
+﻿#include <bit>
+#include <cstdlib>
 #include <functional>
 #include <spdlog/spdlog.h>
 #include <glm/glm.hpp>
@@ -14,9 +15,13 @@
 #include <glm/gtx/transform2.hpp>
 #include <gli/gli.hpp>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <utility>
+#include <mos/gfx/assets.hpp>
 #include <mos/gfx/box.hpp>
+#include <mos/gfx/brdf_lut.hpp>
 #include <mos/gfx/camera.hpp>
 #include <mos/gfx/cloud.hpp>
 #include <mos/gfx/environment_light.hpp>
@@ -38,6 +43,56 @@
 
 namespace mos::gl {
 
+namespace {
+
+/** Estimated GPU memory, including mipmaps generated on upload. */
+auto texture_bytes(const gfx::Texture_2D &texture) -> std::size_t {
+  std::size_t bytes = 0;
+  for (int level = 0; level < texture.levels(); level++) {
+    bytes += texture.size(level);
+  }
+  if (texture.levels() == 1 && texture.generate_mipmaps) {
+    bytes += bytes / 3;
+  }
+  return bytes;
+}
+
+auto mesh_bytes(const gfx::Mesh &mesh) -> std::size_t {
+  return mesh.vertices.size() * sizeof(gfx::Vertex) +
+         mesh.indices.size() * sizeof(gfx::Triangle_indices);
+}
+
+/** Combine the bits of a matrix into a hash. */
+auto hash(std::uint64_t seed, const glm::mat4 &matrix) -> std::uint64_t {
+  for (int column = 0; column < 4; column++) {
+    for (int row = 0; row < 4; row++) {
+      seed = (seed ^ std::bit_cast<std::uint32_t>(matrix[column][row])) *
+             1099511628211ull;
+    }
+  }
+  return seed;
+}
+
+/** Combine the bits of floats into a hash. */
+auto hash(std::uint64_t seed, std::initializer_list<float> values)
+    -> std::uint64_t {
+  for (const auto value : values) {
+    seed = (seed ^ std::bit_cast<std::uint32_t>(value)) * 1099511628211ull;
+  }
+  return seed;
+}
+
+/** Upload a uniform block unless equal to the one uploaded last. */
+template <class T>
+auto upload_block(const T &block, T &uploaded, const Buffer &buffer) -> void {
+  if (!(block == uploaded)) {
+    glNamedBufferSubData(buffer.id, 0, sizeof(T), &block);
+    uploaded = block;
+  }
+}
+
+} // namespace
+
 auto Renderer::generate(const std::function<void(GLsizei, GLuint *)> &f)
     -> GLuint {
   GLuint id{0};
@@ -78,13 +133,22 @@ void APIENTRY message_callback(GLenum source, GLenum type, GLuint id,
   }
 }
 
-Renderer::Renderer(const glm::ivec2 &resolution, const int samples)
+Renderer::Renderer(const glm::ivec2 &resolution, const int samples,
+                   const bool persistent_streaming)
     : context_(gladLoadGL() != 0),
       functions_shader_(text("assets/shaders/functions.frag"),
                         GL_FRAGMENT_SHADER, "functions"),
       standard_program_(functions_shader_),
       point_cloud_program_("points", functions_shader_),
       line_cloud_program_("lines", functions_shader_),
+      stream_buffer_(GLsizeiptr(4) << 20, persistent_streaming),
+      cloud_vertex_array_(stream_buffer_), arena_(1 << 18, 1 << 18),
+      scene_buffer_(GL_UNIFORM_BUFFER, sizeof(Scene_block), &scene_block_,
+                    GL_DYNAMIC_DRAW, 0),
+      shadows_buffer_(GL_UNIFORM_BUFFER, sizeof(Shadows_block),
+                      &shadows_block_, GL_DYNAMIC_DRAW, 0),
+      view_buffer_(GL_UNIFORM_BUFFER, sizeof(View_block), &view_block_,
+                   GL_DYNAMIC_DRAW, 0),
       standard_target_(resolution, samples),
       multisample_target_(resolution, GL_RGBA16F),
       post_target0_(resolution / 4, GL_R11F_G11F_B10F),
@@ -95,25 +159,13 @@ Renderer::Renderer(const glm::ivec2 &resolution, const int samples)
       white_texture_(Texture_buffer_2D(
           GL_RGBA, GL_RGBA, 1, 1, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT,
           std::array<unsigned char, 4>{255, 255, 255, 255}.data())),
-      brdf_lut_texture_(gl::Texture_buffer_2D(gfx::Texture_2D::load(
-          "assets/brdfLUT.png", false, false, gfx::Texture_2D::Filter::Linear,
-          gfx::Texture_2D::Wrap::Clamp))),
-      cube_camera_index_({0, 0}), shadow_maps_render_buffer_(resolution.y),
-      shadow_maps_{Shadow_map_target(shadow_maps_render_buffer_),
-                   Shadow_map_target(shadow_maps_render_buffer_),
-                   Shadow_map_target(shadow_maps_render_buffer_),
-                   Shadow_map_target(shadow_maps_render_buffer_)},
-      shadow_map_blur_target_(
-          Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F)),
-      shadow_map_blur_targets_{
-          Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F),
-          Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F),
-          Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F),
-          Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F)},
-      environment_render_buffer_(128),
-      environment_maps_targets_{
-          Environment_map_target(environment_render_buffer_),
-          Environment_map_target(environment_render_buffer_)},
+      brdf_lut_texture_(Texture_buffer_2D(
+          GL_RG16F, GL_RG, brdf_lut_size, brdf_lut_size, GL_LINEAR, GL_LINEAR,
+          GL_CLAMP_TO_EDGE, gfx::brdf_lut(brdf_lut_size)->data(), GL_FLOAT)),
+      shadow_maps_render_buffer_(resolution.y),
+      shadow_atlas_(2 * int(std::bit_floor(unsigned(resolution.y))), 64),
+      shadow_atlas_target_(shadow_atlas_.resolution()),
+      probe_scheduler_(2), environment_render_buffer_(128),
       cascaded_shadow_maps_{Shadow_map_target(shadow_maps_render_buffer_),
                             Shadow_map_target(shadow_maps_render_buffer_),
                             Shadow_map_target(shadow_maps_render_buffer_),
@@ -122,7 +174,15 @@ Renderer::Renderer(const glm::ivec2 &resolution, const int samples)
           Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F),
           Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F),
           Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F),
-          Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F)} {
+          Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F)},
+      static_cascade_depths_{Render_buffer(resolution.y),
+                             Render_buffer(resolution.y),
+                             Render_buffer(resolution.y),
+                             Render_buffer(resolution.y)},
+      static_cascade_maps_{Shadow_map_target(static_cascade_depths_[0]),
+                           Shadow_map_target(static_cascade_depths_[1]),
+                           Shadow_map_target(static_cascade_depths_[2]),
+                           Shadow_map_target(static_cascade_depths_[3])} {
 
   if (!context_) {
     spdlog::error("No valid OpenGL context");
@@ -143,6 +203,56 @@ Renderer::Renderer(const glm::ivec2 &resolution, const int samples)
   glDepthMask(GL_TRUE);
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT,
+                &storage_alignment_);
+  if (persistent_streaming && !stream_buffer_.persistent()) {
+    spdlog::warn("No buffer storage, streaming with glBufferSubData");
+  }
+
+  for (std::size_t i = 0; i < std::tuple_size_v<gfx::Environment_lights>;
+       i++) {
+    probe_targets_.push_back(Probe_targets{
+        std::unique_ptr<const Environment_map_target>(
+            new Environment_map_target(environment_render_buffer_)),
+        std::unique_ptr<const Environment_map_target>(
+            new Environment_map_target(environment_render_buffer_))});
+  }
+
+  glBindBufferBase(GL_UNIFORM_BUFFER, Scene_block::binding, scene_buffer_.id);
+  glBindBufferBase(GL_UNIFORM_BUFFER, Shadows_block::binding,
+                   shadows_buffer_.id);
+  glBindBufferBase(GL_UNIFORM_BUFFER, View_block::binding, view_buffer_.id);
+
+  // Texture units never change, set them once.
+  const auto standard = standard_program_.program;
+  glProgramUniform1i(standard, standard_program_.brdf_lut_sampler, 0);
+  glProgramUniform1i(standard, standard_program_.shadow_atlas_sampler, 1);
+  for (int i = 0; i < 4; i++) {
+    glProgramUniform1i(standard,
+                       standard_program_.cascaded_shadow_samplers.at(i),
+                       13 + i);
+  }
+  for (int i = 0; i < 2; i++) {
+    glProgramUniform1i(standard, standard_program_.environment_samplers.at(i),
+                       5 + i);
+  }
+  glProgramUniform1i(standard, standard_program_.material.albedo_sampler, 7);
+  glProgramUniform1i(standard, standard_program_.material.emission_sampler, 8);
+  glProgramUniform1i(standard, standard_program_.material.normal_sampler, 9);
+  glProgramUniform1i(standard, standard_program_.material.metallic_sampler,
+                     10);
+  glProgramUniform1i(standard, standard_program_.material.roughness_sampler,
+                     11);
+  glProgramUniform1i(standard,
+                     standard_program_.material.ambient_occlusion_sampler, 12);
+
+  for (const auto *cloud : {&point_cloud_program_, &line_cloud_program_}) {
+    glProgramUniform1i(cloud->program, cloud->albedo_sampler, 10);
+    glProgramUniform1i(cloud->program, cloud->environment_samplers[0], 5);
+    glProgramUniform1i(cloud->program, cloud->environment_samplers[1], 6);
+  }
+  glProgramUniform1i(depth_program_.program, depth_program_.albedo_sampler, 7);
 }
 
 auto Renderer::load(const mos::gfx::Model &model) -> gpu::Model {
@@ -159,78 +269,189 @@ auto Renderer::load(const mos::gfx::Model &model) -> gpu::Model {
   return mos::gpu::Model(model);
 }
 
+auto Renderer::recycled(std::vector<std::uint32_t> &generations,
+                        const unsigned int id, const std::uint32_t generation)
+    -> bool {
+  constexpr auto unused = std::numeric_limits<std::uint32_t>::max();
+  if (id >= generations.size()) {
+    generations.resize(id + 1, unused);
+  }
+  const auto previous = std::exchange(generations[id], generation);
+  return previous != unused && previous != generation;
+}
+
+auto Renderer::stale(const std::vector<std::uint32_t> &generations,
+                     const gpu::Resource &resource) -> bool {
+  const auto id = std::size_t(resource.id());
+  return id < generations.size() &&
+         generations[id] != std::numeric_limits<std::uint32_t>::max() &&
+         generations[id] != resource.generation();
+}
+
 void Renderer::load_or_update(const gfx::Texture_2D &texture) {
-  if (textures_.find(texture.id()) == textures_.end()) {
-    textures_.insert({texture.id(), Texture_buffer_2D(texture)});
+  const Residency::Key key{Residency::Kind::Texture, unsigned(texture.id())};
+  if (recycled(texture_generations_, texture.id(), texture.generation())) {
+    textures_.erase(texture.id());
+    residency_.remove(key);
+  }
+  if (!textures_.contains(texture.id())) {
+    textures_.insert(texture.id(), Texture_buffer_2D(texture));
   } else {
     auto &buffer = textures_.at(texture.id());
     if (texture.modified > buffer.modified) {
-      glBindTexture(GL_TEXTURE_2D, buffer.texture);
-
-      gli::gl::format const format = gli_converter.translate(texture.format(), texture.swizzles());
-
-      glTexImage2D(GL_TEXTURE_2D, 0,
-                   format.Internal,
-                   texture.width(), texture.height(), 0,
-                   format.External, GL_UNSIGNED_BYTE,
-                   texture.data());
-      if (texture.generate_mipmaps) {
-        glGenerateMipmap(GL_TEXTURE_2D);
-      }
-      glBindTexture(GL_TEXTURE_2D, 0);
+      buffer.upload(texture);
       buffer.modified = texture.modified;
     }
   }
+  residency_.add(key, texture_bytes(texture));
 }
 
 void Renderer::load(const gfx::Shared_texture_2D &texture) {
   if (texture) {
     load_or_update(*texture);
+    texture_sources_.emplace(texture->id()) = texture;
   }
 }
 
 void Renderer::unload(const gfx::Shared_texture_2D &texture) {
   if (texture) {
-    if (textures_.find(texture->id()) != textures_.end()) {
+    if (textures_.contains(texture->id())) {
       textures_.erase(texture->id());
     }
+    texture_sources_.erase(texture->id());
+    residency_.remove({Residency::Kind::Texture, unsigned(texture->id())});
+  }
+}
+
+void Renderer::load(const gfx::Assets::Loaded &loaded) {
+  for (const auto &mesh : loaded.meshes) {
+    load(mesh);
+  }
+  for (const auto &texture : loaded.textures) {
+    load(texture);
   }
 }
 
 void Renderer::clear_buffers() {
+  // Frame buffers refer to target textures, so they go too.
+  frame_buffers_.clear();
+  render_buffers_.clear();
   textures_.clear();
-  array_buffers_.clear();
-  element_array_buffers_.clear();
+  arena_.clear();
+  texture_generations_.clear();
+  shape_generations_.clear();
+  target_generations_.clear();
+  mesh_sources_.clear();
+  texture_sources_.clear();
+  target_textures_.clear();
+  residency_.clear();
 }
 
-void Renderer::render_scene(const gfx::Camera &camera, const gfx::Scene &scene,
-                            const glm::ivec2 &resolution) {
-  glViewport(0, 0, resolution.x, resolution.y);
-  glUseProgram(standard_program_.program);
-  glUniform1i(standard_program_.brdf_lut_sampler, 0);
+void Renderer::vram_budget(const std::size_t bytes) {
+  residency_.budget(bytes);
+}
 
-  glUniform1i(standard_program_.shadow_samplers[0], 1);
-  glUniform1i(standard_program_.shadow_samplers[1], 2);
-  glUniform1i(standard_program_.shadow_samplers[2], 3);
-  glUniform1i(standard_program_.shadow_samplers[3], 4);
+void Renderer::depth_prepass(const bool enabled) { depth_prepass_ = enabled; }
 
-  glUniform1i(standard_program_.environment_maps[0].sampler, 5);
-  glUniform1i(standard_program_.environment_maps[1].sampler, 6);
+void Renderer::front_to_back(const bool enabled) { front_to_back_ = enabled; }
 
-  glUniform1i(standard_program_.material.albedo_sampler, 7);
-  glUniform1i(standard_program_.material.emission_sampler, 8);
-  glUniform1i(standard_program_.material.normal_sampler, 9);
-  glUniform1i(standard_program_.material.metallic_sampler, 10);
-  glUniform1i(standard_program_.material.roughness_sampler, 11);
-  glUniform1i(standard_program_.material.ambient_occlusion_sampler, 12);
+void Renderer::overdraw(const bool enabled) {
+  overdraw_ = enabled;
+  glProgramUniform1i(standard_program_.program, standard_program_.overdraw,
+                     GLint(enabled));
+}
 
-  glUniform1i(standard_program_.cascaded_shadow_samplers[0], 13);
-  glUniform1i(standard_program_.cascaded_shadow_samplers[1], 14);
-  glUniform1i(standard_program_.cascaded_shadow_samplers[2], 15);
-  glUniform1i(standard_program_.cascaded_shadow_samplers[3], 16);
+void Renderer::cached_shadows(const bool enabled) {
+  cached_shadows_ = enabled;
+  static_cascade_valid_.fill(false);
+}
 
-  // Cascaded
+void Renderer::blur_compute(const bool enabled) { blur_compute_ = enabled; }
+
+void Renderer::environment_budget(const int faces) {
+  probe_scheduler_.budget(faces);
+}
+
+void Renderer::environment_samples(const int samples) {
+  environment_samples_ = std::max(samples, 1);
+}
+
+auto Renderer::stats() const -> Stats {
+  // Moments and depth of every atlas texel.
+  const auto shadow_atlas_bytes =
+      shadow_atlas_.stats().texels * (sizeof(glm::vec2) + sizeof(float));
+  return Stats{residency_.stats(), draw_stats_, stream_buffer_.stats(),
+               arena_.stats(), shadow_atlas_.stats(), shadow_atlas_bytes,
+               cascade_stats_, blur_times_.milliseconds(),
+               probe_scheduler_.stats()};
+}
+
+auto Renderer::mesh(const gpu::Mesh &mesh) -> const Mesh_arena::Allocation * {
+  if (stale(shape_generations_, mesh)) {
+    return nullptr;
+  }
+  if (!arena_.find(mesh.id())) {
+    const auto *source = mesh_sources_.find(mesh.id());
+    const auto shared = source ? source->lock() : nullptr;
+    if (!shared) {
+      return nullptr;
+    }
+    load(*shared);
+  }
+  residency_.use({Residency::Kind::Mesh, unsigned(mesh.id())});
+  return arena_.find(mesh.id());
+}
+
+auto Renderer::texture(const gpu::Texture_2D &texture, const GLuint fallback)
+    -> GLuint {
+  if (!texture.valid() || stale(texture_generations_, texture)) {
+    return fallback;
+  }
+  if (!textures_.contains(texture.id())) {
+    const auto *source = texture_sources_.find(texture.id());
+    const auto shared = source ? source->lock() : nullptr;
+    if (!shared) {
+      return fallback;
+    }
+    load_or_update(*shared);
+  }
+  residency_.use({Residency::Kind::Texture, unsigned(texture.id())});
+  return textures_.at(texture.id()).texture;
+}
+
+void Renderer::evict() {
+  const auto evicted =
+      residency_.evict([this](const Residency::Key &key) {
+        // Only what can be loaded again on next use.
+        if (key.kind == Residency::Kind::Texture) {
+          const auto *source = texture_sources_.find(key.id);
+          return source && !source->expired();
+        }
+        const auto *source = mesh_sources_.find(key.id);
+        return source && !source->expired();
+      });
+  bool meshes = false;
+  for (const auto &key : evicted) {
+    if (key.kind == Residency::Kind::Texture) {
+      textures_.erase(key.id);
+    } else {
+      arena_.unload(key.id);
+      meshes = true;
+    }
+  }
+  // Freed ranges alone keep the buffers at their largest, over budget.
+  if (meshes) {
+    arena_.compact();
+  }
+}
+
+void Renderer::render_scene(const gfx::Camera &camera, const gfx::Scene &scene,
+                            const glm::ivec2 &resolution,
+                            const Draw_list &list) {
+  glViewport(0, 0, resolution.x, resolution.y);
+  upload_blocks(camera, scene, resolution);
 
+  // Cascaded
   glActiveTexture(GL_TEXTURE13);
   glBindTexture(GL_TEXTURE_2D, cascaded_shadow_map_blur_targets_[0].texture);
 
@@ -243,177 +464,149 @@ void Renderer::render_scene(const gfx::Camera &camera, const gfx::Scene &scene,
   glActiveTexture(GL_TEXTURE16);
   glBindTexture(GL_TEXTURE_2D, cascaded_shadow_map_blur_targets_[3].texture);
 
-  // Cascaded Splits
-  glUniform4fv(standard_program_.cascade_splits, 1,
-               glm::value_ptr(cascade_splits));
-
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, brdf_lut_texture_.texture);
 
   glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, shadow_map_blur_targets_[0].texture);
-
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, shadow_map_blur_targets_[1].texture);
-
-  glActiveTexture(GL_TEXTURE3);
-  glBindTexture(GL_TEXTURE_2D, shadow_map_blur_targets_[2].texture);
-
-  glActiveTexture(GL_TEXTURE4);
-  glBindTexture(GL_TEXTURE_2D, shadow_map_blur_targets_[3].texture);
+  glBindTexture(GL_TEXTURE_2D, shadow_atlas_target_.texture);
 
   glActiveTexture(GL_TEXTURE5);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, environment_maps_targets_[0].texture);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, probe_targets_[0].front->texture);
 
   glActiveTexture(GL_TEXTURE6);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, environment_maps_targets_[1].texture);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, probe_targets_[1].front->texture);
 
+  if (overdraw_) {
+    glBlendFunc(GL_ONE, GL_ONE);
+  }
+  render_sky(scene.sky, camera, standard_program_);
+
+  if (list.size() > 0) {
+    const auto commands = upload_draws(list);
+    const auto batches = list.batches().size();
+    if (depth_prepass_) {
+      const auto opaque = list.opaque_batches();
+      glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+      submit_depth(list, commands, 0, opaque, camera, depth_program_);
+      glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+      glDepthFunc(GL_EQUAL);
+      glDepthMask(GL_FALSE);
+      submit(list, commands, 0, opaque, camera, standard_program_);
+      glDepthFunc(GL_LEQUAL);
+      glDepthMask(GL_TRUE);
+      submit(list, commands, opaque, batches, camera, standard_program_);
+    } else {
+      submit(list, commands, 0, batches, camera, standard_program_);
+    }
+    draw_stats_ += list.stats();
+  }
+  if (overdraw_) {
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
+}
+
+void Renderer::upload_blocks(const gfx::Camera &camera,
+                             const gfx::Scene &scene,
+                             const glm::ivec2 &resolution) {
+  Scene_block scene_block;
+  for (size_t i = 0; i < scene.spot_lights.size(); i++) {
+    const auto &light = scene.spot_lights.at(i);
+    auto &block = scene_block.spot_lights.at(i);
+    block.view = light.camera.view();
+    block.projection = light.camera.projection();
+    block.position = light.position();
+    block.strength = light.strength;
+    block.color = light.color;
+    block.angle = light.angle();
+    block.direction = light.direction();
+    block.blend = light.blend();
+  }
+  scene_block.directional_light.position = scene.directional_light.position;
+  scene_block.directional_light.strength = scene.directional_light.strength;
+  scene_block.directional_light.direction = scene.directional_light.direction;
+  scene_block.directional_light.color = scene.directional_light.color;
   for (size_t i = 0; i < scene.environment_lights.size(); i++) {
-    auto position = scene.environment_lights.at(i).position();
-    glUniform3fv(standard_program_.environment_maps.at(i).position, 1,
-                 glm::value_ptr(position));
-    auto extent = scene.environment_lights.at(i).extent();
-    glUniform3fv(standard_program_.environment_maps.at(i).extent, 1,
-                 glm::value_ptr(extent));
-    glUniform1fv(standard_program_.environment_maps.at(i).strength, 1,
-                 &scene.environment_lights.at(i).strength);
-    glUniform1fv(standard_program_.environment_maps.at(i).falloff, 1,
-                 &scene.environment_lights.at(i).falloff);
-  }
-
-  // Camera in world space
-  auto position = camera.position();
-  glUniform3fv(standard_program_.camera.position, 1, glm::value_ptr(position));
-
-  // Spotlights
+    const auto &light = scene.environment_lights.at(i);
+    auto &block = scene_block.environments.at(i);
+    block.position = light.position();
+    block.strength = light.strength;
+    block.extent = light.extent();
+    block.falloff = light.falloff;
+  }
+  scene_block.fog.color_near = scene.fog.color_near;
+  scene_block.fog.attenuation_factor = scene.fog.attenuation_factor;
+  scene_block.fog.color_far = scene.fog.color_far;
+  scene_block.fog.min = scene.fog.min;
+  scene_block.fog.max = scene.fog.max;
+  scene_block.cascade_splits = cascade_splits;
+  upload_block(scene_block, scene_block_, scene_buffer_);
+
+  static const glm::mat4 bias(0.5, 0.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.0, 0.0,
+                              0.0, 0.5, 0.0, 0.5, 0.5, 0.5, 1.0);
+  Shadows_block shadows_block;
   for (size_t i = 0; i < scene.spot_lights.size(); i++) {
-    auto light_position = scene.spot_lights.at(i).position();
-    glUniform3fv(standard_program_.spot_lights.at(i).position, 1,
-                 glm::value_ptr(light_position));
-
-    glUniform3fv(standard_program_.spot_lights.at(i).color, 1,
-                 glm::value_ptr(scene.spot_lights.at(i).color));
-    glUniform1fv(standard_program_.spot_lights.at(i).strength, 1,
-                 &scene.spot_lights.at(i).strength);
-
-    auto view = scene.spot_lights.at(i).camera.view();
-    glUniformMatrix4fv(standard_program_.spot_lights.at(i).view, 1, GL_FALSE,
-                       glm::value_ptr(view));
-
-    auto projection = scene.spot_lights.at(i).camera.projection();
-    glUniformMatrix4fv(standard_program_.spot_lights.at(i).projection, 1,
-                       GL_FALSE, glm::value_ptr(projection));
-
-    auto light_angle = scene.spot_lights.at(i).angle();
-    glUniform1fv(standard_program_.spot_lights.at(i).angle, 1, &light_angle);
-    auto light_direction = scene.spot_lights.at(i).direction();
-    glUniform3fv(standard_program_.spot_lights.at(i).direction, 1,
-                 glm::value_ptr(light_direction));
-
-    auto light_blend = scene.spot_lights.at(i).blend();
-    glUniform1fv(standard_program_.spot_lights.at(i).blend, 1, &light_blend);
+    const auto &light = scene.spot_lights.at(i);
+    shadows_block.depth_bias_view_projections.at(i) =
+        shadow_atlas_.transform(i) * bias * light.camera.projection() *
+        light.camera.view();
   }
-
-  // Directional light
-  glUniform3fv(standard_program_.directional_light.position, 1,
-               glm::value_ptr(scene.directional_light.position));
-
-  glUniform3fv(standard_program_.directional_light.direction, 1,
-               glm::value_ptr(scene.directional_light.direction));
-
-  glUniform3fv(standard_program_.directional_light.color, 1,
-               glm::value_ptr(scene.directional_light.color));
-
-  glUniform1fv(standard_program_.directional_light.strength, 1,
-               &scene.directional_light.strength);
-
-  glUniform2iv(standard_program_.camera.resolution, 1,
-               glm::value_ptr(resolution));
-
-  glUniform3fv(standard_program_.fog.color_near, 1,
-               glm::value_ptr(scene.fog.color_near));
-  glUniform3fv(standard_program_.fog.color_far, 1,
-               glm::value_ptr(scene.fog.color_far));
-  glUniform1fv(standard_program_.fog.attenuation_factor, 1,
-               &scene.fog.attenuation_factor);
-  glUniform1fv(standard_program_.fog.min, 1, &scene.fog.min);
-  glUniform1fv(standard_program_.fog.max, 1, &scene.fog.max);
-
-  render_sky(scene.sky, camera, scene.fog, resolution, standard_program_);
-
-  for (const auto &model : scene.models) {
-    render_model(model, glm::mat4(1.0F), camera, scene.spot_lights,
-                 scene.environment_lights, scene.fog, resolution,
-                 standard_program_);
+  for (size_t i = 0; i < directional_light_ortho_matrices.size(); i++) {
+    shadows_block.cascaded_depth_bias_view_projections.at(i) =
+        bias * directional_light_ortho_matrices.at(i) *
+        light_view_matrix.at(i);
   }
+  upload_block(shadows_block, shadows_block_, shadows_buffer_);
+
+  View_block view_block;
+  view_block.position = camera.position();
+  view_block.resolution = resolution;
+  upload_block(view_block, view_block_, view_buffer_);
 }
 
 void Renderer::render_sky(const gpu::Model &model, const gfx::Camera &camera,
-                          const gfx::Fog &fog, const glm::vec2 &resolution,
                           const Standard_program &program) {
-  glUseProgram(program.program);
-
-  auto res = glm::ivec2(resolution);
-  glUniform2iv(program.camera.resolution, 1, glm::value_ptr(res));
-
-  glUniform3fv(program.fog.color_near, 1, glm::value_ptr(fog.color_near));
-  glUniform3fv(program.fog.color_far, 1, glm::value_ptr(fog.color_far));
-  glUniform1fv(program.fog.attenuation_factor, 1, &fog.attenuation_factor);
-  glUniform1fv(program.fog.min, 1, &fog.min);
-  glUniform1fv(program.fog.max, 1, &fog.max);
-
   auto sky_camera = camera;
   auto view = sky_camera.view();
   view[3] = glm::vec4(0.0F, 0.0F, 0.0F, 1.0F);
   sky_camera.view(view);
-  //load(model);
-  render_model(model, glm::mat4(1.0F), sky_camera, gfx::Spot_lights(),
-               gfx::Environment_lights(), fog, resolution, program);
+  draw_list_.clear();
+  collect(model, glm::mat4(1.0F), sky_camera, program);
+  draw_list_.prepare();
+  submit(draw_list_, sky_camera, program);
 
   glEnable(GL_DEPTH_TEST);
   glDepthMask(GL_TRUE);
 }
 
 void Renderer::render_clouds(const gfx::Clouds &clouds,
-                             const gfx::Directional_light &directional_light,
-                             const gfx::Spot_lights &spot_lights,
-                             const gfx::Environment_lights &environment_lights,
                              const mos::gfx::Camera &camera,
-                             const glm::ivec2 &resolution,
                              const Cloud_program &program,
                              const GLenum &draw_mode) {
   glDepthMask(GL_FALSE);
+  glUseProgram(program.program);
+
+  const glm::mat4 mv = camera.view();
+  const glm::mat4 mvp = camera.projection() * camera.view();
+  const glm::mat4 projection = camera.projection();
+  glUniformMatrix4fv(program.model_view_projection, 1, GL_FALSE, &mvp[0][0]);
+  glUniformMatrix4fv(program.model_view, 1, GL_FALSE, &mv[0][0]);
+  glUniformMatrix4fv(program.projection, 1, GL_FALSE,
+                     glm::value_ptr(projection));
+  glBindVertexArray(cloud_vertex_array_.id);
+
   for (const auto &particles : clouds) {
     if (particles.blending == gfx::Cloud::Blending::Additive) {
       glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     } else {
       glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     }
-    if (vertex_arrays_.find(particles.id()) == vertex_arrays_.end()) {
-      unsigned int vertex_array;
-      glGenVertexArrays(1, &vertex_array);
-      glBindVertexArray(vertex_array);
-      if (array_buffers_.find(particles.id()) == array_buffers_.end()) {
-        array_buffers_.insert(
-            {particles.id(),
-             Buffer(GL_ARRAY_BUFFER, particles.points.size() * sizeof(gfx::Point),
-                    particles.points.data(), GL_STREAM_DRAW,
-                    particles.points.modified())});
-      }
-      vertex_arrays_.insert(
-          {particles.id(), Vertex_array(particles, array_buffers_)});
+    if (particles.points.size() == 0) {
+      continue;
     }
-    glBindBuffer(GL_ARRAY_BUFFER, array_buffers_.at(particles.id()).id);
-    glBufferData(GL_ARRAY_BUFFER, particles.points.size() * sizeof(gfx::Point),
-                 particles.points.data(), GL_STREAM_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glm::mat4 mv = camera.view();
-    glm::mat4 mvp = camera.projection() * camera.view();
-
-    glUseProgram(program.program);
-
-    glBindVertexArray(vertex_arrays_.at(particles.id()).id);
+    const auto range = stream_buffer_.write(
+        particles.points.data(),
+        GLsizeiptr(particles.points.size() * sizeof(gfx::Point)));
+    glBindVertexBuffer(0, range.buffer, range.offset, sizeof(gfx::Point));
 
     load(particles.texture);
     glActiveTexture(GL_TEXTURE10);
@@ -421,79 +614,10 @@ void Renderer::render_clouds(const gfx::Clouds &clouds,
                   particles.texture
                       ? textures_.at(particles.texture->id()).texture
                       : black_texture_.texture);
-    glUniform1i(program.albedo_sampler, 10);
-
-    // TODO: Check
-    glBindTexture(GL_TEXTURE_CUBE_MAP, environment_maps_targets_[0].texture);
-    glUniform1i(program.environment_samplers[0].map, 5);
-
-    // TODO: Check
-    glBindTexture(GL_TEXTURE_CUBE_MAP, environment_maps_targets_[1].texture);
-    glUniform1i(program.environment_samplers[1].map, 6);
-
-    glUniformMatrix4fv(program.model_view_projection, 1, GL_FALSE, &mvp[0][0]);
-    glUniformMatrix4fv(program.model_view, 1, GL_FALSE, &mv[0][0]);
-    auto projection = camera.projection();
-    glUniformMatrix4fv(program.projection, 1, GL_FALSE,
-                       glm::value_ptr(projection));
 
     auto emissive = static_cast<int>(particles.emissive);
     glUniform1iv(program.emissive_sampler, 1, &emissive);
 
-    auto position = camera.position();
-    glUniform3fv(program.camera.position, 1, glm::value_ptr(position));
-    glm::vec2 res = resolution;
-    glUniform2fv(program.resolution, 1, glm::value_ptr(res));
-
-    for (size_t i = 0; i < environment_lights.size(); i++) {
-      auto position = environment_lights.at(i).position();
-      glUniform3fv(program.environment_samplers.at(i).position, 1,
-                   glm::value_ptr(position));
-      auto extent = environment_lights.at(i).extent();
-      glUniform3fv(program.environment_samplers.at(i).extent, 1,
-                   glm::value_ptr(extent));
-      glUniform1fv(program.environment_samplers.at(i).strength, 1,
-                   &environment_lights.at(i).strength);
-      glUniform1fv(program.environment_samplers.at(i).falloff, 1,
-                   &environment_lights.at(i).falloff);
-    }
-    for (size_t i = 0; i < spot_lights.size(); i++) {
-      auto light_position = spot_lights.at(i).position();
-      glUniform3fv(program.spot_lights.at(i).position, 1,
-                   glm::value_ptr(light_position));
-
-      glUniform3fv(program.spot_lights.at(i).color, 1,
-                   glm::value_ptr(spot_lights.at(i).color));
-      glUniform1fv(program.spot_lights.at(i).strength, 1,
-                   &spot_lights.at(i).strength);
-
-      auto view = spot_lights.at(i).camera.view();
-      glUniformMatrix4fv(program.spot_lights.at(i).view, 1, GL_FALSE,
-                         glm::value_ptr(view));
-      auto projection = spot_lights.at(i).camera.projection();
-      glUniformMatrix4fv(program.spot_lights.at(i).projection, 1, GL_FALSE,
-                         glm::value_ptr(projection));
-
-      auto light_angle = spot_lights.at(i).angle();
-      glUniform1fv(program.spot_lights.at(i).angle, 1, &light_angle);
-      auto light_direction = spot_lights.at(i).direction();
-      glUniform3fv(program.spot_lights.at(i).direction, 1,
-                   glm::value_ptr(light_direction));
-    }
-
-    // Directional light
-    glUniform3fv(program.directional_light.position, 1,
-                 glm::value_ptr(directional_light.position));
-
-    glUniform3fv(program.directional_light.direction, 1,
-                 glm::value_ptr(directional_light.direction));
-
-    glUniform3fv(program.directional_light.color, 1,
-                 glm::value_ptr(directional_light.color));
-
-    glUniform1fv(program.directional_light.strength, 1,
-                 &directional_light.strength);
-
     glDrawArrays(draw_mode, 0, particles.points.size());
   }
   glDepthMask(GL_TRUE);
@@ -501,124 +625,190 @@ void Renderer::render_clouds(const gfx::Clouds &clouds,
 }
 
 
-void Renderer::render_model(const gpu::Model &model,
-                            const glm::mat4 &parent_transform,
-                            const gfx::Camera &camera, const gfx::Spot_lights &lights,
-                            const gfx::Environment_lights &environment_lights,
-                            const gfx::Fog &fog, const glm::vec2 &resolution,
-                            const Standard_program &program) {
-  if (camera.in_frustum(glm::vec3(parent_transform[3]) + model.centroid(),
-                        model.radius())) {
-    const glm::mat4 mvp = camera.projection() * camera.view() *
-                          parent_transform * model.transform;
+void Renderer::collect(const gpu::Model &model,
+                       const glm::mat4 &parent_transform,
+                       const gfx::Camera &camera, const Program &program) {
+  const auto transform = parent_transform * model.transform;
+  const auto center =
+      glm::vec3(transform * glm::vec4(model.mesh.centroid(), 1.0F));
+  if (camera.in_frustum(center, model.radius())) {
+    const auto drawable = this->drawable(model);
+    if (drawable.vertex_array != 0) {
+      Draw draw;
+      draw.program = program.program;
+      draw.vertex_array = drawable.vertex_array;
+      draw.textures = drawable.textures;
+      draw.material = drawable.material;
+      draw.transform = transform;
+      draw.first_index = drawable.first_index;
+      draw.base_vertex = drawable.base_vertex;
+      draw.num_indices = drawable.num_indices;
+      draw.vertex_generation = drawable.vertex_generation;
+      draw.index_generation = drawable.index_generation;
+      draw.distance = glm::distance(camera.position(), center);
+      draw_list_.add(draw);
+    }
+  }
+  for (const auto &child : model.models) {
+    collect(child, transform, camera, program);
+  }
+}
+
+auto Renderer::drawable(const gpu::Model &model) -> Drawable {
+  const auto *allocation = model.mesh.id() != -1 ? mesh(model.mesh) : nullptr;
+  if (!allocation) {
+    return Drawable{};
+  }
+  const auto &material = model.material;
+  return Drawable{
+      arena_.vertex_array,
+      model.mesh.num_indices(),
+      {texture(material.albedo().texture, black_texture_.texture),
+       texture(material.emission().texture, black_texture_.texture),
+       texture(material.normal().texture, black_texture_.texture),
+       texture(material.metallic().texture, black_texture_.texture),
+       texture(material.roughness().texture, black_texture_.texture),
+       texture(material.ambient_occlusion().texture, white_texture_.texture)},
+      {material.albedo().value, material.emission().value,
+       material.roughness().value, material.metallic().value,
+       material.index_of_refraction(), material.alpha(),
+       material.transmission(), material.ambient_occlusion().value},
+      allocation->first_triangle * 3,
+      std::int32_t(allocation->base_vertex),
+      allocation->vertex_generation,
+      allocation->index_generation};
+}
+
+auto Renderer::upload_draws(const Draw_list &list) -> Ring_buffer::Range {
+  const auto &instances = list.instances();
+  const auto &materials = list.materials();
+  const auto &commands = list.commands();
+  const auto instance_range = stream_buffer_.write(
+      instances.data(), GLsizeiptr(instances.size() * sizeof(Instance)),
+      storage_alignment_);
+  glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, instance_range.buffer,
+                    instance_range.offset, instance_range.size);
+  const auto material_range = stream_buffer_.write(
+      materials.data(), GLsizeiptr(materials.size() * sizeof(Material_block)),
+      storage_alignment_);
+  glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, material_range.buffer,
+                    material_range.offset, material_range.size);
+  const auto command_range = stream_buffer_.write(
+      commands.data(), GLsizeiptr(commands.size() * sizeof(Draw_command)));
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_range.buffer);
+  arena_.reserve_instances(std::uint32_t(instances.size()));
+  return command_range;
+}
 
-    if (model.mesh.id() != -1) {
-      glBindVertexArray(vertex_arrays_.at(model.mesh.id()).id);
+namespace {
+
+/** Submit batches [begin, end) of an uploaded list, one multi draw per run
+ * of batches without state changes. Calls bind(draw, all) before the run a
+ * draw starts, all is true for the first run, which sets every state. */
+template <class Bind>
+auto multi_draw(const Draw_list &list, const Ring_buffer::Range &commands,
+                const std::size_t begin, const std::size_t end, Bind &&bind)
+    -> void {
+  const auto draws = list.begin();
+  const auto &batches = list.batches();
+  auto run = begin;
+  const auto flush = [&](const std::size_t i) {
+    if (i > run) {
+      glMultiDrawElementsIndirect(
+          GL_TRIANGLES, GL_UNSIGNED_INT,
+          reinterpret_cast<const void *>(commands.offset +
+                                         run * sizeof(Draw_command)),
+          GLsizei(i - run), 0);
+    }
+    run = i;
+  };
+  for (auto i = begin; i < end; i++) {
+    const auto &draw = *(draws + batches[i].first);
+    if (i == begin) {
+      bind(draw, true);
+    } else if (draw.program_changed || draw.vertex_array_changed ||
+               draw.textures_changed != 0) {
+      flush(i);
+      bind(draw, false);
+    }
+  }
+  flush(end);
+}
 
-      const auto &uniforms = program;
+} // namespace
 
-      glActiveTexture(GL_TEXTURE7);
-      glBindTexture(
-          GL_TEXTURE_2D,
-          model.material.albedo().texture.valid()
-              ? textures_.at(model.material.albedo().texture.id()).texture
-              : black_texture_.texture);
-
-      glActiveTexture(GL_TEXTURE8);
-      glBindTexture(
-          GL_TEXTURE_2D,
-          model.material.emission().texture.valid()
-              ? textures_.at(model.material.emission().texture.id()).texture
-              : black_texture_.texture);
-
-      glActiveTexture(GL_TEXTURE9);
-      glBindTexture(
-          GL_TEXTURE_2D,
-          model.material.normal().texture.valid()
-              ? textures_.at(model.material.normal().texture.id()).texture
-              : black_texture_.texture);
-
-      glActiveTexture(GL_TEXTURE10);
-      glBindTexture(
-          GL_TEXTURE_2D,
-          model.material.metallic().texture.valid()
-              ? textures_.at(model.material.metallic().texture.id()).texture
-              : black_texture_.texture);
-
-      glActiveTexture(GL_TEXTURE11);
-      glBindTexture(
-          GL_TEXTURE_2D,
-          model.material.roughness().texture.valid()
-              ? textures_.at(model.material.roughness().texture.id()).texture
-              : black_texture_.texture);
-
-      glActiveTexture(GL_TEXTURE12);
-      glBindTexture(
-          GL_TEXTURE_2D,
-          model.material.ambient_occlusion().texture.valid()
-              ? textures_.at(model.material.ambient_occlusion().texture.id())
-                    .texture
-              : white_texture_.texture);
-
-      static const glm::mat4 bias(0.5, 0.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.0, 0.0,
-                                  0.0, 0.5, 0.0, 0.5, 0.5, 0.5, 1.0);
-
-      for (size_t i = 0; i < lights.size(); i++) {
-        auto projection = lights.at(i).camera.projection();
-        auto view = lights.at(i).camera.view();
-        const glm::mat4 depth_bias_mvp =
-            bias * projection * view * parent_transform * model.transform;
-        glUniformMatrix4fv(uniforms.depth_bias_mvps.at(i), 1, GL_FALSE,
-                           &depth_bias_mvp[0][0]);
-      }
+void Renderer::submit(const Draw_list &list, const gfx::Camera &camera,
+                      const Standard_program &program) {
+  if (list.size() == 0) {
+    return;
+  }
+  const auto commands = upload_draws(list);
+  submit(list, commands, 0, list.batches().size(), camera, program);
+  draw_stats_ += list.stats();
+}
 
-      // Cascaded
-      for (size_t i = 0; i < directional_light_ortho_matrices.size(); i++) {
-        auto light_view = light_view_matrix.at(i);
-        const glm::mat4 cascaded_depth_bias_mvp =
-            bias * directional_light_ortho_matrices.at(i) * light_view *
-            parent_transform * model.transform;
-        glUniformMatrix4fv(uniforms.cascaded_depth_bias_mvps.at(i), 1, GL_FALSE,
-                           &cascaded_depth_bias_mvp[0][0]);
-      }
+void Renderer::submit(const Draw_list &list,
+                      const Ring_buffer::Range &commands,
+                      const std::size_t begin, const std::size_t end,
+                      const gfx::Camera &camera,
+                      const Standard_program &program) {
+  if (begin >= end) {
+    return;
+  }
+  glUseProgram(program.program);
+  const glm::mat4 view_projection = camera.projection() * camera.view();
+  glUniformMatrix4fv(program.view_projection, 1, GL_FALSE,
+                     &view_projection[0][0]);
 
-      glUniformMatrix4fv(uniforms.model_view_projection, 1, GL_FALSE,
-                         &mvp[0][0]);
-      auto model_matrix = parent_transform * model.transform;
-      glUniformMatrix4fv(uniforms.model_matrix, 1, GL_FALSE,
-                         &model_matrix[0][0]);
-
-      glm::mat3 normal_matrix = glm::inverseTranspose(
-          glm::mat3(parent_transform) * glm::mat3(model.transform));
-      normal_matrix =
-          glm::inverseTranspose(glm::mat3(parent_transform * model.transform));
-      glUniformMatrix3fv(uniforms.normal_matrix, 1, GL_FALSE,
-                         &normal_matrix[0][0]);
-
-      glUniform3fv(uniforms.material.albedo, 1,
-                   glm::value_ptr(model.material.albedo().value));
-      glUniform3fv(uniforms.material.emission, 1,
-                   glm::value_ptr(model.material.emission().value));
-      glUniform1fv(uniforms.material.roughness, 1,
-                   &model.material.roughness().value);
-      glUniform1fv(uniforms.material.metallic, 1,
-                   &model.material.metallic().value);
-      glUniform1fv(uniforms.material.index_of_refraction, 1,
-                   &model.material.index_of_refraction());
-      glUniform1fv(uniforms.material.alpha, 1, &model.material.alpha());
-      glUniform1fv(uniforms.material.transmission, 1,
-                   &model.material.transmission());
-      glUniform1fv(uniforms.material.ambient_occlusion, 1,
-                   &model.material.ambient_occlusion().value);
-
-      glDrawElements(GL_TRIANGLES, model.mesh.num_indices() * 3,
-                     GL_UNSIGNED_INT, nullptr);
+  multi_draw(list, commands, begin, end, [](const Draw &draw, const bool all) {
+    if (all || draw.program_changed) {
+      glUseProgram(draw.program);
     }
+    if (all || draw.vertex_array_changed) {
+      glBindVertexArray(draw.vertex_array);
+    }
+    for (size_t i = 0; i < draw.textures.size(); i++) {
+      if (all || draw.textures_changed & (1 << i)) {
+        glActiveTexture(GL_TEXTURE7 + GLenum(i));
+        glBindTexture(GL_TEXTURE_2D, draw.textures[i]);
+      }
+    }
+  });
+}
+
+void Renderer::submit_depth(const Draw_list &list, const gfx::Camera &camera,
+                            const Depth_program &program) {
+  if (list.size() == 0) {
+    return;
   }
-  for (const auto &child : model.models) {
-    render_model(child, parent_transform * model.transform, camera, lights,
-                 environment_lights, fog, resolution, program);
+  const auto commands = upload_draws(list);
+  submit_depth(list, commands, 0, list.batches().size(), camera, program);
+  draw_stats_ += list.stats();
+}
+
+void Renderer::submit_depth(const Draw_list &list,
+                            const Ring_buffer::Range &commands,
+                            const std::size_t begin, const std::size_t end,
+                            const gfx::Camera &camera,
+                            const Depth_program &program) {
+  if (begin >= end) {
+    return;
   }
+  glUseProgram(program.program);
+  const glm::mat4 view_projection = camera.projection() * camera.view();
+  glUniformMatrix4fv(program.view_projection, 1, GL_FALSE,
+                     &view_projection[0][0]);
+
+  // Albedo on the unit of the standard program, to keep its other units.
+  multi_draw(list, commands, begin, end, [](const Draw &draw, const bool all) {
+    if (all || draw.vertex_array_changed) {
+      glBindVertexArray(draw.vertex_array);
+    }
+    if (all || draw.textures_changed & 1) {
+      glActiveTexture(GL_TEXTURE7);
+      glBindTexture(GL_TEXTURE_2D, draw.textures[0]);
+    }
+  });
 }
 
 void Renderer::clear(const glm::vec4 &color) {
@@ -640,8 +830,26 @@ void Renderer::clear_color(const glm::vec4 &color) {
 void Renderer::blur(const GLuint input_texture,
                     const Post_target &buffer_target,
                     const Post_target &output_target, const float iterations) {
-  glViewport(0, 0, GLsizei(output_target.resolution.x),
-             GLsizei(output_target.resolution.y));
+  const auto resolution = output_target.resolution;
+  if (blur_compute_) {
+    blur_times_.begin();
+    const auto source = glm::ivec4(0, 0, resolution.x, resolution.y);
+    if (input_texture == output_target.texture) {
+      // Texels are read by neighbouring groups, so never blur in place.
+      dispatch_blur(input_texture, buffer_target.texture, source,
+                    glm::ivec2(0), int(iterations));
+      glCopyImageSubData(buffer_target.texture, GL_TEXTURE_2D, 0, 0, 0, 0,
+                         output_target.texture, GL_TEXTURE_2D, 0, 0, 0, 0,
+                         resolution.x, resolution.y, 1);
+    } else {
+      dispatch_blur(input_texture, output_target.texture, source,
+                    glm::ivec2(0), int(iterations));
+    }
+    blur_times_.end();
+    return;
+  }
+  blur_times_.begin();
+  glViewport(0, 0, GLsizei(resolution.x), GLsizei(resolution.y));
   for (int i = 0; i < iterations; i++) {
     GLint horizontal = (i % 2 == 1);
     glBindFramebuffer(GL_FRAMEBUFFER, horizontal ? output_target.frame_buffer
@@ -658,41 +866,179 @@ void Renderer::blur(const GLuint input_texture,
 
     glDrawArrays(GL_TRIANGLES, 0, 6);
   }
+  blur_times_.end();
 }
 
-void Renderer::render_shadow_maps(const std::vector<gpu::Model> &models,
-                                  const gfx::Spot_lights &lights) {
-  for (size_t i = 0; i < shadow_maps_.size(); i++) {
-    if (lights.at(i).strength > 0.0F) {
-      auto frame_buffer = shadow_maps_.at(i).frame_buffer;
-      glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
-      glClear(GL_DEPTH_BUFFER_BIT);
-      auto resolution = shadow_maps_render_buffer_.resolution();
-      glUseProgram(depth_program_.program);
-      glViewport(0, 0, resolution.x, resolution.y);
-
-      glUniform1i(depth_program_.albedo_sampler, 0);
-
-      for (const auto &model : models) {
-        render_model_depth(model, glm::mat4(1.0F), lights.at(i).camera,
-                           resolution, depth_program_);
+void Renderer::dispatch_blur(const GLuint input_texture,
+                             const GLuint output_texture,
+                             const glm::ivec4 &source,
+                             const glm::ivec2 &destination,
+                             const int iterations, const bool moments) {
+  // Iterations alternate vertical and horizontal 9 tap passes, the same as
+  // one pass per direction with the kernel convolved with itself.
+  constexpr std::array<float, 5> gaussian{0.227027F, 0.1945946F, 0.1216216F,
+                                          0.054054F, 0.016216F};
+  std::vector<float> kernel{1.0F};
+  for (int pass = 0; pass < std::max(iterations / 2, 1); pass++) {
+    std::vector<float> convolved(kernel.size() + 8, 0.0F);
+    for (std::size_t i = 0; i < kernel.size(); i++) {
+      for (int j = -4; j <= 4; j++) {
+        convolved[i + 4 + j] += kernel[i] * gaussian[std::abs(j)];
       }
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    kernel = std::move(convolved);
+  }
+  const auto center = int(kernel.size() / 2);
+  const auto radius = std::min(center, Blur_compute_program::max_radius);
+  std::array<float, Blur_compute_program::max_radius + 1> weights{};
+  float sum = 0.0F;
+  for (int i = 0; i <= radius; i++) {
+    weights[i] = kernel[center + i];
+    sum += i == 0 ? weights[i] : 2.0F * weights[i];
+  }
+  // Renormalize what a kernel wider than the shader allows leaves.
+  for (auto &weight : weights) {
+    weight /= sum;
+  }
 
-      glViewport(0, 0, shadow_maps_render_buffer_.resolution().x,
-                 shadow_maps_render_buffer_.resolution().y);
+  const auto &program = blur_compute_program_;
+  glUseProgram(program.program);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, input_texture);
+  glUniform1i(program.input_sampler, 0);
+  glUniform4i(program.source, source.x, source.y, source.z, source.w);
+  glUniform2i(program.destination, destination.x, destination.y);
+  glUniform1i(program.radius, radius);
+  glUniform1fv(program.weights, GLsizei(weights.size()), weights.data());
+  glUniform1i(program.moments, GLint(moments));
+  // Images are bound with the format of the texture, as stores convert to it.
+  GLint format{0};
+  glGetTextureLevelParameteriv(output_texture, 0, GL_TEXTURE_INTERNAL_FORMAT,
+                               &format);
+  glBindImageTexture(0, output_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY,
+                     GLenum(format));
+  const auto tile = Blur_compute_program::tile;
+  glDispatchCompute(GLuint((source.z + tile - 1) / tile),
+                    GLuint((source.w + tile - 1) / tile), 1);
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT |
+                  GL_TEXTURE_UPDATE_BARRIER_BIT);
+}
 
-      blur(shadow_maps_.at(i).texture, shadow_map_blur_target_,
-           shadow_map_blur_targets_.at(i), 4);
+void Renderer::render_shadow_maps(const gfx::Spot_lights &lights,
+                                  const gfx::Camera &camera) {
+  std::array<float, 4> importance{};
+  for (size_t i = 0; i < lights.size(); i++) {
+    const auto &light = lights.at(i);
+    if (light.strength > 0.0F) {
+      // Lit surfaces near the camera cover more of the screen.
+      const auto distance =
+          glm::distance(light.position(), camera.position());
+      importance.at(i) = light.strength / std::max(distance * distance, 1.0F);
+    }
+  }
+  shadow_atlas_.allocate(importance);
+
+  for (size_t i = 0; i < lights.size(); i++) {
+    const auto &list = recorder_.list(views_.spot_lights.at(i));
+    const auto &light_camera = lights.at(i).camera;
+    // The list hash covers the casters' upload generations.
+    auto state = hash(list.hash(), light_camera.view());
+    state = hash(state, light_camera.projection());
+    if (!shadow_atlas_.update(i, state)) {
+      continue;
+    }
+    const auto tile = shadow_atlas_.tile(i);
+    glBindFramebuffer(GL_FRAMEBUFFER, shadow_atlas_target_.frame_buffer);
+    glViewport(tile.offset.x, tile.offset.y, tile.size, tile.size);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(tile.offset.x, tile.offset.y, tile.size, tile.size);
+    // Moments of the far plane where nothing casts a shadow.
+    clear(glm::vec4(1.0F, 1.0F, 0.0F, 0.0F));
+    glDisable(GL_SCISSOR_TEST);
+    glUseProgram(depth_program_.program);
+    // The compute blur derives moments from the depth texture.
+    if (blur_compute_) {
+      glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    }
+    submit_depth(list, light_camera, depth_program_);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    blur_shadow_tile(tile, 4);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Renderer::blur_shadow_tile(const Shadow_atlas::Tile &tile,
+                                const int iterations) {
+  if (blur_compute_) {
+    blur_times_.begin();
+    dispatch_blur(shadow_atlas_target_.depth_texture,
+                  shadow_atlas_target_.texture,
+                  glm::ivec4(tile.offset.x, tile.offset.y, tile.size, tile.size),
+                  tile.offset, iterations, true);
+    blur_times_.end();
+    return;
+  }
+  const auto &scratch_target = shadow_map_blur_target();
+  const auto atlas = float(shadow_atlas_.resolution());
+  const auto scratch = glm::vec2(scratch_target.resolution);
+  const auto size = float(tile.size);
+  blur_times_.begin();
+  // The atlas depth buffer still holds the depth of the light.
+  glDisable(GL_DEPTH_TEST);
+  glUseProgram(blur_program_.program);
+  glBindVertexArray(quad_.vertex_array);
+  glActiveTexture(GL_TEXTURE0);
+  glUniform1i(blur_program_.color_sampler, 0);
+  for (int i = 0; i < iterations; i++) {
+    GLint horizontal = (i % 2 == 1);
+    if (horizontal) {
+      // From the corner of the scratch target back into the tile.
+      glBindFramebuffer(GL_FRAMEBUFFER, shadow_atlas_target_.frame_buffer);
+      glViewport(tile.offset.x, tile.offset.y, tile.size, tile.size);
+      glBindTexture(GL_TEXTURE_2D, scratch_target.texture);
+      glUniform4f(blur_program_.region, 0.0F, 0.0F, size / scratch.x,
+                  size / scratch.y);
+    } else {
+      glBindFramebuffer(GL_FRAMEBUFFER, scratch_target.frame_buffer);
+      glViewport(0, 0, tile.size, tile.size);
+      glBindTexture(GL_TEXTURE_2D, shadow_atlas_target_.texture);
+      glUniform4f(blur_program_.region, float(tile.offset.x) / atlas,
+                  float(tile.offset.y) / atlas, size / atlas, size / atlas);
     }
+    glUniform1iv(blur_program_.horizontal, 1, &horizontal);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+  }
+  glUniform4f(blur_program_.region, 0.0F, 0.0F, 1.0F, 1.0F);
+  glEnable(GL_DEPTH_TEST);
+  blur_times_.end();
+}
+
+void Renderer::blur_shadow_map(const GLuint input_texture,
+                               const Post_target &output_target,
+                               const int iterations) {
+  if (blur_compute_) {
+    blur_times_.begin();
+    dispatch_blur(input_texture, output_target.texture,
+                  glm::ivec4(0, 0, output_target.resolution.x,
+                             output_target.resolution.y),
+                  glm::ivec2(0), iterations);
+    blur_times_.end();
+  } else {
+    blur(input_texture, shadow_map_blur_target(), output_target,
+         float(iterations));
   }
 }
 
-void Renderer::render_cascaded_shadow_maps(const std::vector<gpu::Model> &models,
-                                           const gfx::Directional_light &light,
-                                           const gfx::Camera &camera) {
-  std::vector<gpu::Model> models_to_render(models.begin(), models.end());
+auto Renderer::shadow_map_blur_target() -> const Post_target & {
+  if (!shadow_map_blur_target_) {
+    shadow_map_blur_target_.reset(
+        new Post_target(shadow_maps_render_buffer_.resolution(), GL_RG32F));
+  }
+  return *shadow_map_blur_target_;
+}
 
+void Renderer::update_cascades(const gfx::Directional_light &light,
+                               const gfx::Camera &camera) {
   const float lambda = .7F;
   const float min_distance = 0.0F;
   const float max_distance = 1.0F;
@@ -764,6 +1110,19 @@ void Renderer::render_cascaded_shadow_maps(const std::vector<gpu::Model> &models
     }
     radius = std::ceil(radius * 16.0F) / 16.0F;
 
+    // Keep the cascade in place while it lags only a few texels behind, so
+    // its cached static layer stays valid.
+    const float texel =
+        2.0F * radius /
+        static_cast<float>(shadow_maps_render_buffer_.resolution().x);
+    if (cached_shadows_ && cascade_radii_[cascade_idx] == radius &&
+        cascade_direction_ == light_dir &&
+        glm::distance(frustum_center, cascade_centers_[cascade_idx]) <
+            cascade_texel_threshold * texel) {
+      continue;
+    }
+    cascade_centers_[cascade_idx] = frustum_center;
+
     const glm::vec3 max_extents = glm::vec3(radius, radius, radius);
     const glm::vec3 min_extents = -max_extents;
 
@@ -800,128 +1159,182 @@ void Renderer::render_cascaded_shadow_maps(const std::vector<gpu::Model> &models
     shadow_proj[3] += round_offset;
     directional_light_ortho_matrices[cascade_idx] = shadow_proj;
 
-    // TEMP
+    cascade_cameras_[cascade_idx] =
+        gfx::Camera(light_position, frustum_center,
+                    directional_light_ortho_matrices[cascade_idx],
+                    glm::vec3(0.0F, 1.0F, 0.0F));
+    cascade_radii_[cascade_idx] = radius;
+  }
+  cascade_direction_ = light_dir;
+}
+
+void Renderer::render_cascaded_shadow_maps() {
+  auto resolution = shadow_maps_render_buffer_.resolution();
+  for (unsigned int cascade_idx = 0; cascade_idx < cascade_count;
+       ++cascade_idx) {
+    const auto &camera = cascade_cameras_[cascade_idx];
+    // All casters if not cached, otherwise the static ones.
+    const auto &list = recorder_.list(views_.cascades.at(cascade_idx));
+    const auto &dynamic_list =
+        recorder_.list(views_.dynamic_cascades.at(cascade_idx));
     auto frame_buffer = cascaded_shadow_maps_.at(cascade_idx).frame_buffer;
-    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
-    glClear(GL_DEPTH_BUFFER_BIT);
-    auto resolution = shadow_maps_render_buffer_.resolution();
     glUseProgram(depth_program_.program);
     glViewport(0, 0, resolution.x, resolution.y);
 
-    glUniform1i(depth_program_.albedo_sampler, 0);
-
-    auto light_camera = gfx::Camera(light_position, frustum_center,
-                               directional_light_ortho_matrices[cascade_idx],
-                               glm::vec3(0.0F, 1.0F, 0.0F));
-
-    // for (auto &model : models) {
-    auto it = models_to_render.begin();
-    while (it != models_to_render.end()) {
-      if (light_camera.in_frustum(it->position(), it->radius())) {
-        render_model_depth(*it, glm::mat4(1.0F), light_camera, resolution,
-                           depth_program_);
-        if (it->radius() > radius) {
-          it++;
-        } else {
-          it = models_to_render.erase(it);
-        }
-      } else {
-        it++;
-      }
+    if (!cached_shadows_) {
+      glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+      glClear(GL_DEPTH_BUFFER_BIT);
+      submit_depth(list, camera, depth_program_);
+      cascade_stats_.draws += list.stats();
+      blur_shadow_map(cascaded_shadow_maps_.at(cascade_idx).texture,
+                      cascaded_shadow_map_blur_targets_.at(cascade_idx), 2);
+      cascade_stats_.composited++;
+      continue;
+    }
+
+    // Only the static casters drawn, and their upload generations.
+    auto state = hash(list.hash(), camera.view());
+    state = hash(state, camera.projection());
+    const bool rendered = !static_cascade_valid_[cascade_idx] ||
+                          static_cascade_states_[cascade_idx] != state;
+    const auto static_frame_buffer =
+        static_cascade_maps_.at(cascade_idx).frame_buffer;
+    if (rendered) {
+      glBindFramebuffer(GL_FRAMEBUFFER, static_frame_buffer);
+      // Moments of the far plane where nothing casts a shadow.
+      clear(glm::vec4(1.0F, 1.0F, 0.0F, 0.0F));
+      submit_depth(list, camera, depth_program_);
+      cascade_stats_.draws += list.stats();
+      static_cascade_states_[cascade_idx] = state;
+      static_cascade_valid_[cascade_idx] = true;
+      cascade_stats_.static_rendered++;
+    } else {
+      cascade_stats_.static_cached++;
     }
 
-    blur(cascaded_shadow_maps_.at(cascade_idx).texture, shadow_map_blur_target_,
-         cascaded_shadow_map_blur_targets_.at(cascade_idx), 2);
+    // The blurred cascade is still valid if neither layer changed.
+    const bool dynamic = dynamic_list.size() > 0;
+    if (rendered || dynamic || cascade_dynamic_[cascade_idx]) {
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, static_frame_buffer);
+      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frame_buffer);
+      glBlitFramebuffer(0, 0, resolution.x, resolution.y, 0, 0, resolution.x,
+                        resolution.y, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT,
+                        GL_NEAREST);
+      glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+      if (dynamic) {
+        glUseProgram(depth_program_.program);
+        submit_depth(dynamic_list, camera, depth_program_);
+        cascade_stats_.draws += dynamic_list.stats();
+        cascade_stats_.dynamic++;
+      }
+      blur_shadow_map(cascaded_shadow_maps_.at(cascade_idx).texture,
+                      cascaded_shadow_map_blur_targets_.at(cascade_idx), 2);
+      cascade_stats_.composited++;
+    }
+    cascade_dynamic_[cascade_idx] = dynamic;
   }
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Renderer::render_environment(const gfx::Scene &scene,
                                   const glm::vec4 &clear_color) {
-  for (size_t i = 0; i < environment_maps_targets_.size(); i++) {
-    if (scene.environment_lights.at(i).strength > 0.0F) {
-      GLuint frame_buffer_id = environment_maps_targets_.at(i).frame_buffer;
-      glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_id);
-
-      auto texture_id = environment_maps_targets_.at(i).texture;
-
-      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                             GL_TEXTURE_CUBE_MAP_POSITIVE_X +
-                                 cube_camera_index_.at(i),
-                             texture_id, 0);
-
-      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1,
-                             GL_TEXTURE_CUBE_MAP_POSITIVE_X +
-                                 cube_camera_index_.at(i),
-                             environment_maps_targets_.at(i).albedo, 0);
-
-      clear(clear_color);
-      auto resolution = environment_render_buffer_.resolution();
-      auto cube_camera =
-          scene.environment_lights.at(i).camera(cube_camera_index_.at(i));
+  const auto &faces = probe_scheduler_.faces();
+  for (std::size_t i = 0; i < faces.size(); i++) {
+    const auto &face = faces[i];
+    auto &targets = probe_targets_.at(face.probe);
+    const auto &target = *targets.back;
+    glBindFramebuffer(GL_FRAMEBUFFER, target.frame_buffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_CUBE_MAP_POSITIVE_X + face.face,
+                           target.texture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1,
+                           GL_TEXTURE_CUBE_MAP_POSITIVE_X + face.face,
+                           target.albedo, 0);
+
+    clear(clear_color);
+    render_scene(scene.environment_lights.at(face.probe).camera(face.face),
+                 scene, environment_render_buffer_.resolution(),
+                 recorder_.list(views_.environments[i]));
+
+    // The sampled cube map changes only when a complete one is prefiltered,
+    // and stays until the probe changes.
+    if (face.completes) {
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      prefilter(*targets.back, *targets.front);
+    }
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-      render_scene(cube_camera, scene, resolution);
+void Renderer::prefilter(const Environment_map_target &source,
+                         const Environment_map_target &target) {
+  // Samples read the source mip matching their solid angle.
+  glBindTexture(GL_TEXTURE_CUBE_MAP, source.texture);
+  glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
-      cube_camera_index_.at(i) =
-          cube_camera_index_.at(i) >= 5
-              ? 0
-              : ++cube_camera_index_.at(i); // TODO PROBLEM
+  const auto size = environment_render_buffer_.resolution().x;
+  glCopyImageSubData(source.texture, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+                     target.texture, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0, size,
+                     size, 6);
 
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
-      glBindTexture(GL_TEXTURE_CUBE_MAP, texture_id);
-      if (cube_camera_index_.at(i) == 0) {
-        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-      }
-      glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-    }
+  const auto &program = prefilter_program_;
+  glUseProgram(program.program);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, source.texture);
+  glUniform1i(program.source_sampler, 0);
+  glUniform1i(program.samples, environment_samples_);
+  const auto levels = std::bit_width(unsigned(size));
+  for (int level = 1; level < levels; level++) {
+    const auto level_size = std::max(size >> level, 1);
+    glUniform1f(program.roughness, float(level) / float(levels - 1));
+    glBindImageTexture(0, target.texture, level, GL_TRUE, 0, GL_WRITE_ONLY,
+                       GL_RGBA16F);
+    const auto groups = GLuint((level_size + Prefilter_program::tile - 1) /
+                               Prefilter_program::tile);
+    glDispatchCompute(groups, groups, 6);
   }
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 auto Renderer::load(const mos::gfx::Mesh &mesh) -> gpu::Mesh {
-  if (vertex_arrays_.find(mesh.id()) == vertex_arrays_.end()) {
-    vertex_arrays_.insert({mesh.id(), Vertex_array(mesh, array_buffers_,
-                                                   element_array_buffers_)});
-  }
-
-  if (mesh.vertices.size() > 0 &&
-      mesh.vertices.modified() > array_buffers_.at(mesh.id()).modified) {
-    glBindBuffer(GL_ARRAY_BUFFER, array_buffers_.at(mesh.id()).id);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(gfx::Vertex),
-                 mesh.vertices.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    array_buffers_.at(mesh.id()).modified = mesh.vertices.modified();
-  }
-  if (mesh.indices.size() > 0 &&
-      mesh.indices.modified() >
-          element_array_buffers_.at(mesh.id()).modified) {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                 element_array_buffers_.at(mesh.id()).id);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 mesh.indices.size() * 3 * sizeof(unsigned int),
-                 mesh.indices.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    element_array_buffers_.at(mesh.id()).modified = mesh.indices.modified();
+  if (recycled(shape_generations_, mesh.id(), mesh.generation())) {
+    unload(mesh);
   }
+  arena_.load(mesh, stream_buffer_);
+  residency_.add({Residency::Kind::Mesh, unsigned(mesh.id())},
+                 mesh_bytes(mesh));
   return mos::gpu::Mesh(mesh);
 }
 
 void Renderer::unload(const gfx::Mesh &mesh) {
-  if (vertex_arrays_.find(mesh.id()) != vertex_arrays_.end()) {
-    vertex_arrays_.erase(mesh.id());
+  arena_.unload(mesh.id());
+  mesh_sources_.erase(mesh.id());
+  residency_.remove({Residency::Kind::Mesh, mesh.id()});
+}
 
-    if (array_buffers_.find(mesh.id()) != array_buffers_.end()) {
-      array_buffers_.erase(mesh.id());
-    }
-    if (element_array_buffers_.find(mesh.id()) !=
-        element_array_buffers_.end()) {
-      element_array_buffers_.erase(mesh.id());
-    }
+auto Renderer::load(const gfx::Mesh_file &file) -> gpu::Mesh {
+  if (recycled(shape_generations_, file.id(), file.generation())) {
+    arena_.unload(file.id());
+    mesh_sources_.erase(file.id());
+    residency_.remove({Residency::Kind::Mesh, file.id()});
   }
+  arena_.load(file);
+  residency_.add({Residency::Kind::Mesh, file.id()},
+                 file.vertices().size_bytes() + file.indices().size_bytes());
+  return gpu::Mesh(file);
+}
+
+void Renderer::unload(const gfx::Mesh_file &file) {
+  arena_.unload(file.id());
+  residency_.remove({Residency::Kind::Mesh, file.id()});
 }
 
 void Renderer::load(const gfx::Shared_mesh &mesh) {
   if (mesh) {
     load(*mesh);
+    mesh_sources_.emplace(mesh->id()) = mesh;
   }
 }
 
@@ -933,11 +1346,274 @@ auto Renderer::load(const gfx::Models &models) -> gpu::Models {
   return loaded;
 }
 
-void Renderer::render_texture_targets(const gfx::Scene &scene) {
+void Renderer::cull(const gfx::Scenes &scenes) {
+  nodes_.clear();
+  scene_nodes_.clear();
+  culling_.clear();
+  // Depth first, so parents come before their children.
+  std::vector<Node> stack;
+  for (const auto &scene : scenes) {
+    const auto begin = nodes_.size();
+    for (auto it = scene.models.rbegin(); it != scene.models.rend(); it++) {
+      stack.push_back(Node{&*it, gfx::Scene_graph::none});
+    }
+    while (!stack.empty()) {
+      const auto node = stack.back();
+      stack.pop_back();
+      const auto index = gfx::Scene_graph::Index(nodes_.size());
+      nodes_.push_back(node);
+      for (auto it = node.model->models.rbegin();
+           it != node.model->models.rend(); it++) {
+        stack.push_back(Node{&*it, index});
+      }
+    }
+    scene_nodes_.emplace_back(begin, nodes_.size());
+  }
+
+  // Only models with a mesh are drawn, the rest are never visible.
+  const auto bounds = [](const gpu::Model &model) {
+    return gfx::Bvh::Sphere{model.mesh.centroid(),
+                            model.mesh.id() != -1 ? model.mesh.radius()
+                                                  : -1.0F};
+  };
+  bool same_hierarchy = nodes_.size() == graph_.size();
+  for (std::size_t i = 0; i < nodes_.size() && same_hierarchy; i++) {
+    same_hierarchy = graph_.parent(i) == nodes_[i].parent;
+  }
+  if (same_hierarchy) {
+    for (std::size_t i = 0; i < nodes_.size(); i++) {
+      graph_.local(i, nodes_[i].model->transform);
+      graph_.bounds(i, bounds(*nodes_[i].model));
+    }
+  } else {
+    graph_.clear();
+    for (const auto &node : nodes_) {
+      graph_.add(node.parent, node.model->transform, bounds(*node.model));
+    }
+  }
+  graph_.update();
+  for (const auto &sphere : graph_.spheres()) {
+    culling_.add(sphere.center, sphere.radius);
+  }
+  schedule_probes(scenes[0]);
+
+  views_.cameras.clear();
+  for (const auto &scene : scenes) {
+    views_.cameras.push_back(culling_.add(scene.camera));
+  }
+  const auto &scene = scenes[0];
+  for (std::size_t i = 0; i < views_.spot_lights.size(); i++) {
+    views_.spot_lights[i] = culling_.add(scene.spot_lights.at(i).camera);
+  }
+  for (std::size_t i = 0; i < views_.cascades.size(); i++) {
+    views_.cascades[i] = culling_.add(cascade_cameras_.at(i));
+  }
+  views_.environments.clear();
+  for (const auto &face : probe_scheduler_.faces()) {
+    views_.environments.push_back(culling_.add(
+        scene.environment_lights.at(face.probe).camera(face.face)));
+  }
+  views_.texture_targets.clear();
   for (const auto &target : scene.texture_targets) {
-    if (frame_buffers_.find(target.target.id()) == frame_buffers_.end()) {
-      frame_buffers_.insert({target.target.id(),
-                             Frame_buffer(target, textures_, render_buffers_)});
+    views_.texture_targets.push_back(culling_.add(target.camera));
+  }
+  culling_.cull();
+}
+
+void Renderer::schedule_probes(const gfx::Scene &scene) {
+  // A probe sees the lights of the scene and the models within its far
+  // plane, of which only those that moved or were uploaded again since the
+  // last schedule are new.
+  const auto &sun = scene.directional_light;
+  auto lights = hash(std::uint64_t(0),
+                     {sun.direction.x, sun.direction.y, sun.direction.z,
+                      sun.color.r, sun.color.g, sun.color.b, sun.strength});
+  for (const auto &light : scene.spot_lights) {
+    const auto position = light.position();
+    const auto direction = light.direction();
+    lights = hash(lights, {position.x, position.y, position.z, direction.x,
+                           direction.y, direction.z, light.color.r,
+                           light.color.g, light.color.b, light.strength,
+                           light.angle()});
+  }
+  // Generations only increase, so meshes uploaded since the last schedule
+  // have newer ones than any seen then.
+  constexpr auto unset = std::numeric_limits<Mesh_arena::Generation>::max();
+  auto newest = probe_generation_;
+  const auto uploaded = [&](const gpu::Mesh &mesh) {
+    const auto *allocation =
+        mesh.id() != -1 ? arena_.find(unsigned(mesh.id())) : nullptr;
+    if (!allocation) {
+      return false;
+    }
+    bool newer = false;
+    for (const auto generation :
+         {allocation->vertex_generation, allocation->index_generation}) {
+      if (generation != unset && generation > probe_generation_) {
+        newest = std::max(newest, generation);
+        newer = true;
+      }
+    }
+    return newer;
+  };
+  std::vector<gfx::Bvh::Sphere> moved;
+  for (std::size_t i = 0; i < graph_.spheres().size(); i++) {
+    const bool changed = graph_.age(gfx::Scene_graph::Index(i)) == 0;
+    if (uploaded(nodes_[i].model->mesh) || changed) {
+      moved.push_back(graph_.spheres()[i]);
+    }
+  }
+  probe_generation_ = newest;
+
+  std::vector<Probe_scheduler::Probe> probes;
+  for (const auto &light : scene.environment_lights) {
+    const auto position = light.position();
+    const auto extent = light.extent();
+    Probe_scheduler::Probe probe;
+    probe.enabled = light.strength > 0.0F;
+    probe.distance = glm::distance(position, scene.camera.position());
+    probe.state = hash(lights, {position.x, position.y, position.z, extent.x,
+                                extent.y, extent.z});
+    const auto far = glm::length(extent);
+    probe.changed = std::any_of(
+        moved.begin(), moved.end(), [&](const auto &sphere) {
+          return glm::distance(sphere.center, position) <= far + sphere.radius;
+        });
+    probes.push_back(probe);
+  }
+  probe_scheduler_.schedule(probes);
+}
+
+void Renderer::record(const gfx::Scenes &scenes) {
+  const auto words = (culling_.size() + gfx::Culling::word_bits - 1) /
+                     gfx::Culling::word_bits;
+  // GL state is resolved here on the GL thread, only for models that are
+  // drawn, so residency sees what the frame uses.
+  std::vector<gfx::Culling::Word> visible(words);
+  for (gfx::Culling::Index view = 0; view < culling_.views(); view++) {
+    const auto visibility = culling_.visibility(view);
+    for (std::size_t w = 0; w < words; w++) {
+      visible[w] |= visibility[w];
+    }
+  }
+  drawables_.assign(nodes_.size(), Drawable{});
+  for (std::size_t i = 0; i < nodes_.size(); i++) {
+    if ((visible[i / gfx::Culling::word_bits] >>
+         (i % gfx::Culling::word_bits)) & 1) {
+      drawables_[i] = drawable(*nodes_[i].model);
+    }
+  }
+
+  // Models that fit within a cascade are not drawn again in the later ones.
+  // With cached shadows, models that were still for a while go to the
+  // static layer, after the per cascade bits of the dynamic layers.
+  cascade_visibility_.assign(2 * cascade_count * words, 0);
+  std::vector<gfx::Culling::Word> still(words);
+  if (cached_shadows_) {
+    for (std::size_t i = 0; i < nodes_.size(); i++) {
+      if (graph_.age(gfx::Scene_graph::Index(i)) >= static_age) {
+        still[i / gfx::Culling::word_bits] |= gfx::Culling::Word(1)
+                                              << (i % gfx::Culling::word_bits);
+      }
+    }
+  }
+  std::vector<gfx::Culling::Word> consumed(words);
+  const auto spheres = graph_.spheres();
+  for (std::size_t c = 0; c < cascade_count; c++) {
+    const auto visibility = culling_.visibility(views_.cascades.at(c));
+    auto *drawn = cascade_visibility_.data() + c * words;
+    for (std::size_t w = 0; w < words; w++) {
+      drawn[w] = visibility[w] & ~consumed[w];
+      for (auto bits = drawn[w]; bits != 0; bits &= bits - 1) {
+        const auto bit = std::countr_zero(bits);
+        if (spheres[w * gfx::Culling::word_bits + bit].radius <=
+            cascade_radii_[c]) {
+          consumed[w] |= gfx::Culling::Word(1) << bit;
+        }
+      }
+      if (cached_shadows_) {
+        auto *dynamic = drawn + cascade_count * words;
+        dynamic[w] = drawn[w] & ~still[w];
+        drawn[w] &= still[w];
+      }
+    }
+  }
+
+  // One pass per culling view, views of disabled lights stay empty, then
+  // the dynamic cascade layers.
+  passes_.assign(culling_.views() + cascade_count, Command_recorder::Pass{});
+  const auto pass = [&](const gfx::Culling::Index view,
+                        const gfx::Camera &camera, const bool depth,
+                        const std::size_t scene_index) {
+    const auto [begin, end] = scene_nodes_.at(scene_index);
+    // With a pre-pass, shading order no longer matters for overdraw.
+    const auto order = !depth && front_to_back_ && !depth_prepass_
+                           ? Draw_list::Order::Depth
+                           : Draw_list::Order::Key;
+    passes_[view] = Command_recorder::Pass{
+        depth ? depth_program_.program : standard_program_.program,
+        depth,
+        camera.position(),
+        begin,
+        end,
+        culling_.visibility(view),
+        order};
+  };
+  for (std::size_t i = 0; i < scenes.size(); i++) {
+    pass(views_.cameras.at(i), scenes[i].camera, false, i);
+  }
+  const auto &scene = scenes[0];
+  for (std::size_t i = 0; i < views_.spot_lights.size(); i++) {
+    if (scene.spot_lights.at(i).strength > 0.0F) {
+      pass(views_.spot_lights[i], scene.spot_lights.at(i).camera, true, 0);
+    }
+  }
+  for (std::size_t c = 0; c < views_.cascades.size(); c++) {
+    pass(views_.cascades[c], cascade_cameras_.at(c), true, 0);
+    passes_[views_.cascades[c]].visible = {
+        cascade_visibility_.data() + c * words, words};
+    views_.dynamic_cascades[c] = culling_.views() + c;
+    passes_[views_.dynamic_cascades[c]] = passes_[views_.cascades[c]];
+    passes_[views_.dynamic_cascades[c]].visible = {
+        cascade_visibility_.data() + (cascade_count + c) * words, words};
+  }
+  const auto &faces = probe_scheduler_.faces();
+  for (std::size_t i = 0; i < faces.size(); i++) {
+    pass(views_.environments[i],
+         scene.environment_lights.at(faces[i].probe).camera(faces[i].face),
+         false, 0);
+  }
+  for (std::size_t i = 0; i < views_.texture_targets.size(); i++) {
+    pass(views_.texture_targets[i], scene.texture_targets[i].camera, false,
+         0);
+  }
+  recorder_.record(passes_, drawables_, graph_, &pool_);
+}
+
+void Renderer::render_texture_targets(const gfx::Scene &scene) {
+  for (std::size_t i = 0; i < scene.texture_targets.size(); i++) {
+    const auto &target = scene.texture_targets[i];
+    if (recycled(target_generations_, target.target.id(),
+                 target.target.generation())) {
+      frame_buffers_.erase(target.target.id());
+      render_buffers_.erase(target.target.id());
+    }
+    if (!frame_buffers_.contains(target.target.id())) {
+      if (const auto *pinned = target_textures_.find(target.target.id())) {
+        residency_.unpin({Residency::Kind::Texture, *pinned});
+      }
+      if (recycled(texture_generations_, target.texture->id(),
+                   target.texture->generation())) {
+        textures_.erase(target.texture->id());
+        residency_.remove(
+            {Residency::Kind::Texture, unsigned(target.texture->id())});
+      }
+      frame_buffers_.insert(target.target.id(),
+                            Frame_buffer(target, textures_, render_buffers_));
+      // Attached to the frame buffer, so it may not be evicted.
+      target_textures_.emplace(target.target.id()) = target.texture->id();
+      residency_.pin(
+          {Residency::Kind::Texture, unsigned(target.texture->id())});
     }
     const auto &fb = frame_buffers_.at(target.target.id());
     glBindFramebuffer(GL_FRAMEBUFFER, fb.id);
@@ -947,7 +1623,8 @@ void Renderer::render_texture_targets(const gfx::Scene &scene) {
     clear(glm::vec4(0.0F));
 
     render_scene(target.camera, scene,
-                 glm::ivec2(target.texture->width(), target.texture->height()));
+                 glm::ivec2(target.texture->width(), target.texture->height()),
+                 recorder_.list(views_.texture_targets.at(i)));
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, texture_id);
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -955,68 +1632,33 @@ void Renderer::render_texture_targets(const gfx::Scene &scene) {
   }
 }
 
-void Renderer::render_model_depth(const gpu::Model &model,
-                                  const glm::mat4 &transform,
-                                  const gfx::Camera &camera,
-                                  const glm::vec2 &resolution,
-                                  const Depth_program &program) {
-  if (camera.in_frustum(glm::vec3(transform[3]) + model.centroid(),
-                        model.radius())) {
-    const glm::mat4 mvp =
-        camera.projection() * camera.view() * transform * model.transform;
-
-    if (model.mesh.id() != -1) {
-      glBindVertexArray(vertex_arrays_.at(model.mesh.id()).id);
-
-      glActiveTexture(GL_TEXTURE0);
-      glBindTexture(
-          GL_TEXTURE_2D,
-          model.material.albedo().texture.valid()
-              ? textures_.at(model.material.albedo().texture.id()).texture
-              : black_texture_.texture);
-
-      glUniformMatrix4fv(program.model_view_projection, 1, GL_FALSE,
-                         &mvp[0][0]);
-
-      glUniform3fv(program.albedo, 1,
-                   glm::value_ptr(model.material.albedo().value));
-      glUniform3fv(program.emission, 1,
-                   glm::value_ptr(model.material.emission().value));
-      const int num_elements =
-          model.mesh.num_indices() * 3;
-      glDrawElements(GL_TRIANGLES, num_elements, GL_UNSIGNED_INT, nullptr);
-    }
-  }
-  for (const auto &child : model.models) {
-    render_model_depth(child, transform * model.transform, camera, resolution,
-                       program);
-  }
-}
-
 void Renderer::render(const gfx::Scenes &scenes, const glm::vec4 &color,
                       const glm::ivec2 &resolution) {
   for (const auto &scene : scenes) {
     //load(scene.models);
   }
-  render_shadow_maps(scenes[0].models, scenes[0].spot_lights);
-  render_cascaded_shadow_maps(scenes[0].models, scenes[0].directional_light,
-                              scenes[0].camera);
+  residency_.begin_frame();
+  draw_stats_ = Draw_list::Stats{};
+  cascade_stats_ = Cascade_stats{};
+  update_cascades(scenes[0].directional_light, scenes[0].camera);
+  cull(scenes);
+  record(scenes);
+  render_shadow_maps(scenes[0].spot_lights, scenes[0].camera);
+  render_cascaded_shadow_maps();
   render_environment(scenes[0], color);
   render_texture_targets(scenes[0]);
 
   glBindFramebuffer(GL_FRAMEBUFFER, standard_target_.frame_buffer);
   clear(glm::convertSRGBToLinear(color));
 
-  for (const auto &scene : scenes) {
-
-    render_scene(scene.camera, scene, resolution);
-    render_clouds(scene.point_clouds, scene.directional_light,
-                  scene.spot_lights, scene.environment_lights, scene.camera,
-                  resolution, point_cloud_program_, GL_POINTS);
-
-    render_clouds(scene.line_clouds, scene.directional_light, scene.spot_lights,
-                  scene.environment_lights, scene.camera, resolution,
-                  line_cloud_program_, GL_LINES);
+  for (std::size_t i = 0; i < scenes.size(); i++) {
+    const auto &scene = scenes[i];
+    render_scene(scene.camera, scene, resolution,
+                 recorder_.list(views_.cameras.at(i)));
+    render_clouds(scene.point_clouds, scene.camera, point_cloud_program_,
+                  GL_POINTS);
+    render_clouds(scene.line_clouds, scene.camera, line_cloud_program_,
+                  GL_LINES);
 
     glBindFramebuffer(GL_READ_FRAMEBUFFER, standard_target_.frame_buffer);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, multisample_target_.frame_buffer);
@@ -1062,6 +1704,10 @@ void Renderer::render(const gfx::Scenes &scenes, const glm::vec4 &color,
   glUniform1fv(compositing_program_.bloom_strength, 1, &strength);
 
   glDrawArrays(GL_TRIANGLES, 0, 6);
+
+  evict();
+  stream_buffer_.end_frame();
+  blur_times_.end_frame();
 }
 
 } // namespace mos::gfx
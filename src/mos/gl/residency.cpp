@@ -0,0 +1,124 @@
+#include <mos/gl/residency.hpp>
+
+namespace mos::gl {
+
+Residency::Residency(const std::size_t budget) { stats_.budget = budget; }
+
+auto Residency::entries(const Kind kind) -> Slot_map<Entry> & {
+  return entries_[static_cast<std::size_t>(kind)];
+}
+
+auto Residency::entries(const Kind kind) const -> const Slot_map<Entry> & {
+  return entries_[static_cast<std::size_t>(kind)];
+}
+
+auto Residency::budget(const std::size_t bytes) -> void {
+  stats_.budget = bytes;
+}
+
+auto Residency::begin_frame() -> void {
+  frame_++;
+  stats_.evictions = 0;
+  stats_.evicted_bytes = 0;
+  stats_.reloads = 0;
+}
+
+auto Residency::add(const Key &key, const std::size_t bytes) -> void {
+  auto &entry = entries(key.kind).emplace(key.id);
+  if (entry.resident) {
+    stats_.resident_bytes -= entry.bytes;
+    order_.splice(order_.end(), order_, entry.position);
+  } else {
+    if (entry.frame != 0) {
+      stats_.reloads++;
+    }
+    stats_.resident++;
+    entry.position = order_.insert(order_.end(), key);
+  }
+  entry.bytes = bytes;
+  entry.frame = frame_;
+  entry.resident = true;
+  stats_.resident_bytes += bytes;
+}
+
+auto Residency::use(const Key &key) -> void {
+  auto *entry = entries(key.kind).find(key.id);
+  if (entry && entry->resident && entry->frame != frame_) {
+    entry->frame = frame_;
+    order_.splice(order_.end(), order_, entry->position);
+  }
+}
+
+auto Residency::remove(const Key &key) -> void {
+  auto *entry = entries(key.kind).find(key.id);
+  if (entry && entry->resident) {
+    stats_.resident_bytes -= entry->bytes;
+    stats_.resident--;
+    order_.erase(entry->position);
+  }
+  entries(key.kind).erase(key.id);
+}
+
+auto Residency::resident(const Key &key) const -> bool {
+  const auto *entry = entries(key.kind).find(key.id);
+  return entry && entry->resident;
+}
+
+auto Residency::evicted(const Key &key) const -> bool {
+  const auto *entry = entries(key.kind).find(key.id);
+  return entry && !entry->resident;
+}
+
+auto Residency::pin(const Key &key) -> void {
+  pins_[static_cast<std::size_t>(key.kind)].emplace(key.id, 0)++;
+}
+
+auto Residency::unpin(const Key &key) -> void {
+  auto &pins = pins_[static_cast<std::size_t>(key.kind)];
+  auto *count = pins.find(key.id);
+  if (count && --(*count) <= 0) {
+    pins.erase(key.id);
+  }
+}
+
+auto Residency::evict(const std::function<bool(const Key &)> &evictable)
+    -> std::vector<Key> {
+  std::vector<Key> evicted;
+  auto it = order_.begin();
+  while (stats_.resident_bytes > stats_.budget && it != order_.end()) {
+    auto &entry = entries(it->kind).at(it->id);
+    // Ordered by use, so the rest were used this frame as well.
+    if (entry.frame == frame_) {
+      break;
+    }
+    if (pins_[static_cast<std::size_t>(it->kind)].contains(it->id) ||
+        !evictable(*it)) {
+      ++it;
+      continue;
+    }
+    evicted.push_back(*it);
+    entry.resident = false;
+    stats_.resident_bytes -= entry.bytes;
+    stats_.resident--;
+    stats_.evictions++;
+    stats_.evicted_bytes += entry.bytes;
+    it = order_.erase(it);
+  }
+  return evicted;
+}
+
+auto Residency::clear() -> void {
+  for (auto &entries : entries_) {
+    entries.clear();
+  }
+  for (auto &pins : pins_) {
+    pins.clear();
+  }
+  order_.clear();
+  stats_.resident_bytes = 0;
+  stats_.resident = 0;
+}
+
+auto Residency::stats() const -> Stats { return stats_; }
+
+} // namespace mos::gl
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <mos/gl/ring_buffer.hpp>
+
+namespace mos::gl {
+
+namespace {
+
+constexpr GLbitfield map_flags =
+    GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+auto signaled(const GLsync fence, const GLuint64 timeout) -> bool {
+  const auto result =
+      glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+  if (result == GL_WAIT_FAILED) {
+    throw std::runtime_error("Waiting for ring buffer fence failed.");
+  }
+  return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+} // namespace
+
+Ring_buffer::Ring_buffer(const GLsizeiptr region_size, const bool persistent)
+    : persistent_(persistent && storage_supported()) {
+  allocate(region_size);
+}
+
+Ring_buffer::~Ring_buffer() { release(); }
+
+auto Ring_buffer::allocate(const GLsizeiptr region_size) -> void {
+  region_size_ = region_size;
+  glGenBuffers(1, &id);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+  if (persistent_) {
+    glBufferStorage(GL_COPY_WRITE_BUFFER, region_size_ * frames, nullptr,
+                    map_flags);
+    mapped_ = static_cast<std::byte *>(glMapBufferRange(
+        GL_COPY_WRITE_BUFFER, 0, region_size_ * frames, map_flags));
+  } else {
+    glBufferData(GL_COPY_WRITE_BUFFER, region_size_ * frames, nullptr,
+                 GL_STREAM_DRAW);
+  }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  fences_.fill(nullptr);
+  region_ = 0;
+  offset_ = 0;
+  acquired_ = true;
+}
+
+auto Ring_buffer::acquire() -> void {
+  auto &fence = fences_[region_];
+  if (fence) {
+    if (!signaled(fence, 0)) {
+      stats_.stalls++;
+      while (!signaled(fence, 1000000)) {
+      }
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+  acquired_ = true;
+}
+
+auto Ring_buffer::write(const void *data, const GLsizeiptr size,
+                        const GLsizeiptr alignment) -> Range {
+  if (!acquired_) {
+    acquire();
+  }
+  auto offset = (offset_ + alignment - 1) / alignment * alignment;
+  if (offset + size > region_size_) {
+    // Keep the outgrown buffer until the GPU is done with this frame.
+    retired_.emplace_back(id, nullptr);
+    for (auto &fence : fences_) {
+      if (fence) {
+        glDeleteSync(fence);
+      }
+    }
+    id = 0;
+    mapped_ = nullptr;
+    allocate(std::max(region_size_ * 2, size));
+    stats_.grows++;
+    offset = 0;
+  }
+  const auto position = region_ * region_size_ + offset;
+  if (mapped_) {
+    std::memcpy(mapped_ + position, data, std::size_t(size));
+  } else {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, position, size, data);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  }
+  offset_ = offset + size;
+  stats_.written_bytes += std::size_t(size);
+  return Range{id, position, size};
+}
+
+auto Ring_buffer::copy(const Range &range, const GLuint buffer,
+                       const GLintptr offset) -> void {
+  glBindBuffer(GL_COPY_READ_BUFFER, range.buffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, range.offset,
+                      offset, range.size);
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+auto Ring_buffer::end_frame() -> void {
+  const auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  if (fences_[region_]) {
+    glDeleteSync(fences_[region_]);
+  }
+  fences_[region_] = fence;
+  for (auto &[buffer, retired_fence] : retired_) {
+    if (!retired_fence) {
+      retired_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+  }
+  retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                [](auto &retired) {
+                                  if (!signaled(retired.second, 0)) {
+                                    return false;
+                                  }
+                                  glDeleteSync(retired.second);
+                                  glDeleteBuffers(1, &retired.first);
+                                  return true;
+                                }),
+                 retired_.end());
+  region_ = (region_ + 1) % frames;
+  offset_ = 0;
+  acquired_ = false;
+  frame_stats_ = stats_;
+  stats_ = Stats{};
+}
+
+auto Ring_buffer::persistent() const -> bool { return persistent_; }
+
+auto Ring_buffer::storage_supported() -> bool {
+  return GLAD_GL_VERSION_4_4 != 0;
+}
+
+auto Ring_buffer::stats() const -> Stats { return frame_stats_; }
+
+void Ring_buffer::release() {
+  for (auto &fence : fences_) {
+    if (fence) {
+      glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  for (auto &[buffer, fence] : retired_) {
+    if (fence) {
+      glDeleteSync(fence);
+    }
+    glDeleteBuffers(1, &buffer);
+  }
+  retired_.clear();
+  glDeleteBuffers(1, &id);
+  id = 0;
+  mapped_ = nullptr;
+}
+} // namespace mos::gl
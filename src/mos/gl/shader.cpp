@@ -11,12 +11,14 @@ const std::string standard_path = "assets/shaders/{0}{1}";
 const std::map<GLuint, std::string> extension_map{
     {GL_VERTEX_SHADER, ".vert"},
     {GL_FRAGMENT_SHADER, ".frag"},
-    {GL_GEOMETRY_SHADER, ".geom"}};
+    {GL_GEOMETRY_SHADER, ".geom"},
+    {GL_COMPUTE_SHADER, ".comp"}};
 
 const std::map<const unsigned int, std::string> shader_types{
     {GL_VERTEX_SHADER, "vertex shader"},
     {GL_FRAGMENT_SHADER, "fragment shader"},
-    {GL_GEOMETRY_SHADER, "geometry shader"}};
+    {GL_GEOMETRY_SHADER, "geometry shader"},
+    {GL_COMPUTE_SHADER, "compute shader"}};
 } // namespace
 
 namespace mos::gl {
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+#include <mos/gl/shadow_atlas.hpp>
+
+namespace mos::gl {
+
+namespace {
+
+auto power_of_two(const int value) -> bool {
+  return value > 0 && (value & (value - 1)) == 0;
+}
+
+/** Position of a Morton (Z-order) index, so squares of decreasing powers of
+ * two placed at increasing indices are aligned and never overlap. */
+auto morton_position(std::size_t index) -> glm::ivec2 {
+  glm::ivec2 position{0};
+  for (int bit = 0; index != 0; bit++, index >>= 2) {
+    position.x |= int(index & 1) << bit;
+    position.y |= int((index >> 1) & 1) << bit;
+  }
+  return position;
+}
+
+} // namespace
+
+Shadow_atlas::Shadow_atlas(const int resolution, const int min_tile)
+    : resolution_(resolution), min_tile_(min_tile) {
+  if (!power_of_two(resolution) || !power_of_two(min_tile) ||
+      min_tile > resolution / 2) {
+    throw std::runtime_error(
+        "Shadow atlas sides must be powers of two, with tiles at most half "
+        "the atlas.");
+  }
+}
+
+auto Shadow_atlas::allocate(std::span<const float> importance) -> void {
+  entries_.resize(importance.size());
+  stats_ = Stats{};
+  stats_.texels = std::size_t(resolution_) * std::size_t(resolution_);
+
+  const auto max_importance =
+      importance.empty()
+          ? 0.0f
+          : *std::max_element(importance.begin(), importance.end());
+  std::vector<int> sizes(importance.size(), 0);
+  for (std::size_t i = 0; i < importance.size(); i++) {
+    if (importance[i] > 0.0f) {
+      // Halve the side for every quarter of importance, as texels cover area.
+      const auto halvings = int(std::floor(
+          0.5f * std::log2(max_importance / importance[i])));
+      sizes[i] =
+          std::max(min_tile_, (resolution_ / 2) >> std::min(halvings, 30));
+    }
+  }
+
+  // Least important first, to be dropped first when even the smallest tiles
+  // do not fit.
+  std::vector<std::size_t> order(importance.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const std::size_t a, const std::size_t b) {
+                     return importance[a] < importance[b];
+                   });
+  const auto area = [&]() {
+    std::size_t total = 0;
+    for (const auto size : sizes) {
+      total += std::size_t(size) * std::size_t(size);
+    }
+    return total;
+  };
+  auto dropped = order.begin();
+  while (area() > stats_.texels) {
+    bool halved = false;
+    for (auto &size : sizes) {
+      if (size > min_tile_) {
+        size /= 2;
+        halved = true;
+      }
+    }
+    if (!halved) {
+      while (sizes[*dropped] == 0) {
+        dropped++;
+      }
+      sizes[*dropped] = 0;
+    }
+  }
+
+  // Largest tiles first along the Z-order curve, in units of the smallest.
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const std::size_t a, const std::size_t b) {
+                     return sizes[a] > sizes[b];
+                   });
+  std::size_t cursor = 0;
+  for (const auto light : order) {
+    auto &entry = entries_[light];
+    Tile tile{glm::ivec2(0), sizes[light]};
+    if (tile.size > 0) {
+      const auto units = std::size_t(tile.size / min_tile_);
+      tile.offset = morton_position(cursor) * min_tile_;
+      cursor += units * units;
+    }
+    // Texels of a moved tile may since have been drawn by other lights.
+    if (!(entry.tile == tile)) {
+      entry.valid = false;
+    }
+    entry.tile = tile;
+    if (tile.size == 0) {
+      continue;
+    }
+    stats_.tiles++;
+    stats_.used_texels += std::size_t(tile.size) * std::size_t(tile.size);
+  }
+}
+
+auto Shadow_atlas::tile(const std::size_t light) const -> Tile {
+  return light < entries_.size() ? entries_[light].tile : Tile{};
+}
+
+auto Shadow_atlas::transform(const std::size_t light) const -> glm::mat4 {
+  const auto t = tile(light);
+  const auto offset =
+      glm::vec2(float(t.offset.x), float(t.offset.y)) / float(resolution_);
+  const auto scale = float(t.size) / float(resolution_);
+  return glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(offset.x, offset.y, 0.0f)),
+                    glm::vec3(scale, scale, 1.0f));
+}
+
+auto Shadow_atlas::update(const std::size_t light, const std::uint64_t state)
+    -> bool {
+  auto &entry = entries_.at(light);
+  if (entry.tile.size == 0) {
+    return false;
+  }
+  if (entry.valid && entry.rendered_state == state) {
+    stats_.skipped++;
+    return false;
+  }
+  entry.valid = true;
+  entry.rendered_state = state;
+  stats_.rendered++;
+  return true;
+}
+
+auto Shadow_atlas::resolution() const -> int { return resolution_; }
+
+auto Shadow_atlas::stats() const -> Stats { return stats_; }
+
+} // namespace mos::gl
@@ -6,7 +6,8 @@ namespace mos::gl {
 Texture_buffer_2D::Texture_buffer_2D(
     const GLint internal_format, const GLenum external_format, const int width,
     const int height, const GLint filter_min, const GLint filter_mag,
-    const GLint wrap, const void *data, const Time_point &modified)
+    const GLint wrap, const void *data, const GLenum type,
+    const Time_point &modified)
     : texture(Renderer::generate(glGenTextures)), modified(modified) {
   glBindTexture(GL_TEXTURE_2D, texture);
 
@@ -16,7 +17,7 @@ Texture_buffer_2D::Texture_buffer_2D(
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
 
   glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0,
-               external_format, GL_UNSIGNED_BYTE, data);
+               external_format, type, data);
   if (filter_min == GL_LINEAR_MIPMAP_LINEAR ||
       filter_min == GL_NEAREST_MIPMAP_LINEAR) {
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -28,7 +29,7 @@ Texture_buffer_2D::~Texture_buffer_2D() { release(); }
 
 Texture_buffer_2D::Texture_buffer_2D(
     Texture_buffer_2D &&buffer) noexcept
-    : texture(buffer.texture) {
+    : texture(buffer.texture), modified(buffer.modified) {
   buffer.texture = 0;
 }
 
@@ -37,6 +38,7 @@ auto Texture_buffer_2D::operator=(
   if (this != &buffer) {
     release();
     std::swap(texture, buffer.texture);
+    modified = buffer.modified;
   }
   return *this;
 }
@@ -48,12 +50,50 @@ void Texture_buffer_2D::release() {
 
 
 Texture_buffer_2D::Texture_buffer_2D(const gfx::Texture_2D &texture_2d)
-    : Texture_buffer_2D(
-          gli_converter.translate(texture_2d.format(), texture_2d.swizzles()).Internal,
-          gli_converter.translate(texture_2d.format(), texture_2d.swizzles()).External, texture_2d.width(),
-          texture_2d.height(),
-          texture_2d.generate_mipmaps ? Renderer::filter_convert_mip(texture_2d.filter)
-                                      : Renderer::filter_convert(texture_2d.filter),
-          Renderer::filter_convert(texture_2d.filter), Renderer::wrap_convert(texture_2d.wrap),
-          texture_2d.data()) {}
+    : texture(Renderer::generate(glGenTextures)),
+      modified(std::chrono::system_clock::now()) {
+  const auto filter_min = texture_2d.generate_mipmaps
+                              ? Renderer::filter_convert_mip(texture_2d.filter)
+                              : Renderer::filter_convert(texture_2d.filter);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter_min);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                  Renderer::filter_convert(texture_2d.filter));
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+                  Renderer::wrap_convert(texture_2d.wrap));
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
+                  Renderer::wrap_convert(texture_2d.wrap));
+  glBindTexture(GL_TEXTURE_2D, 0);
+  upload(texture_2d);
+}
+
+void Texture_buffer_2D::upload(const gfx::Texture_2D &texture_2d) {
+  const auto format =
+      gli_converter.translate(texture_2d.format(), texture_2d.swizzles());
+  glBindTexture(GL_TEXTURE_2D, texture);
+  // Rows of small RGB levels are not four byte aligned.
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for (int level = 0; level < texture_2d.levels(); level++) {
+    if (texture_2d.compressed()) {
+      glCompressedTexImage2D(GL_TEXTURE_2D, level, format.Internal,
+                             texture_2d.width(level), texture_2d.height(level),
+                             0, GLsizei(texture_2d.size(level)),
+                             texture_2d.data(level));
+    } else {
+      glTexImage2D(GL_TEXTURE_2D, level, format.Internal,
+                   texture_2d.width(level), texture_2d.height(level), 0,
+                   format.External, GL_UNSIGNED_BYTE, texture_2d.data(level));
+    }
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  // Compressed textures can not have mipmaps generated, so they are complete
+  // with the levels they have.
+  if (texture_2d.levels() > 1 || texture_2d.compressed()) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                    texture_2d.levels() - 1);
+  } else if (texture_2d.generate_mipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
 } // namespace mos::gfx
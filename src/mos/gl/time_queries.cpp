@@ -0,0 +1,46 @@
+#include <mos/gl/time_queries.hpp>
+
+namespace mos::gl {
+
+Time_queries::~Time_queries() {
+  for (auto &frame : frames_) {
+    glDeleteQueries(GLsizei(frame.queries.size()), frame.queries.data());
+  }
+}
+
+auto Time_queries::begin() -> void {
+  auto &frame = frames_[frame_];
+  if (frame.used == frame.queries.size()) {
+    GLuint query{0};
+    glGenQueries(1, &query);
+    frame.queries.push_back(query);
+  }
+  glBeginQuery(GL_TIME_ELAPSED, frame.queries[frame.used++]);
+}
+
+auto Time_queries::end() -> void { glEndQuery(GL_TIME_ELAPSED); }
+
+auto Time_queries::end_frame() -> void {
+  frame_ = (frame_ + 1) % frames_.size();
+  auto &frame = frames_[frame_];
+  if (frame.used > 0) {
+    // Queries complete in order, the last one done means all are.
+    GLint available{0};
+    glGetQueryObjectiv(frame.queries[frame.used - 1],
+                       GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+      GLuint64 nanoseconds{0};
+      for (std::size_t i = 0; i < frame.used; i++) {
+        GLuint64 elapsed{0};
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &elapsed);
+        nanoseconds += elapsed;
+      }
+      milliseconds_ = float(double(nanoseconds) / 1.0e6);
+    }
+  }
+  frame.used = 0;
+}
+
+auto Time_queries::milliseconds() const -> float { return milliseconds_; }
+
+} // namespace mos::gl
@@ -1,13 +1,17 @@
 #include <mos/gpu/mesh.hpp>
 
 mos::gpu::Mesh::Mesh(const mos::gfx::Mesh& mesh)
-    : Resource(mesh.id()), centroid_(mesh.centroid()), radius_(mesh.radius()),
+    : Resource(mesh.id(), mesh.generation()), centroid_(mesh.centroid()), radius_(mesh.radius()),
       num_indices_(mesh.indices.size()) {}
 
 mos::gpu::Mesh::Mesh(const gfx::Shared_mesh &shared_mesh) : Mesh(shared_mesh ? *shared_mesh : Mesh()){
 
 }
 
+mos::gpu::Mesh::Mesh(const gfx::Mesh_file &file)
+    : Resource(file.id(), file.generation()), centroid_(file.centroid()),
+      radius_(file.radius()), num_indices_(int(file.indices().size())) {}
+
 auto mos::gpu::Mesh::radius() const -> float {
   return radius_;
 }
@@ -14,13 +14,11 @@ auto Model::centroid() const -> glm::vec3{
 }
 
 auto Model::radius() const -> float {
-  glm::vec3 scale;
-  glm::quat rotation;
-  glm::vec3 translation;
-  glm::vec3 skew;
-  glm::vec4 perspective;
-  glm::decompose(transform, scale, rotation, translation, skew, perspective);
-  return mesh.radius() * glm::max(glm::max(scale.x, scale.y), scale.z);
+  // Largest axis scale, the lengths of the basis vectors.
+  const auto scale = glm::max(glm::max(glm::length(glm::vec3(transform[0])),
+                                       glm::length(glm::vec3(transform[1]))),
+                              glm::length(glm::vec3(transform[2])));
+  return mesh.radius() * scale;
 }
 
 auto Model::position() const -> glm::vec3 {
@@ -2,7 +2,8 @@
 
 namespace mos::gpu {
 
-Resource::Resource(const int id) : id_(id) {
+Resource::Resource(const int id, const std::uint32_t generation)
+    : id_(id), generation_(generation) {
 
 }
 
@@ -13,4 +14,8 @@ auto Resource::valid() const -> bool {
 auto Resource::id() const -> decltype(id_){
   return id_;
 }
+
+auto Resource::generation() const -> std::uint32_t {
+  return generation_;
+}
 }
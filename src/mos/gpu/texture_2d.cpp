@@ -7,11 +7,13 @@ Texture_2D::Texture_2D() : Resource(invalid_id) {
 }
 
 Texture_2D::Texture_2D(const mos::gfx::Texture_2D &texture)
-    : Resource(texture.id()) {
+    : Resource(texture.id(), texture.generation()) {
 
 }
 
-Texture_2D::Texture_2D(const gfx::Shared_texture_2D &shared_texture) : Resource(shared_texture ? shared_texture->id() : invalid_id) {
+Texture_2D::Texture_2D(const gfx::Shared_texture_2D &shared_texture)
+    : Resource(shared_texture ? shared_texture->id() : invalid_id,
+               shared_texture ? shared_texture->generation() : 0) {
 
 }
 }
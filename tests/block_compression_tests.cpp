@@ -0,0 +1,37 @@
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <mos/gfx/block_compression.hpp>
+
+TEST_CASE( "BC1 round trip", "[Texture]" ) {
+  using namespace mos::gfx;
+
+  // Gradient between two colors, representable by the four color palette.
+  Pixel_block pixels{};
+  for (int i = 0; i < 16; i++) {
+    const auto t = std::uint8_t((i % 4) * 85);
+    pixels[i] = {t, std::uint8_t(255 - t), 128, 255};
+  }
+  const auto decoded = decode_bc1(encode_bc1(pixels));
+  for (int i = 0; i < 16; i++) {
+    for (int c = 0; c < 3; c++) {
+      REQUIRE(std::abs(int(decoded[i][c]) - int(pixels[i][c])) <= 8);
+    }
+  }
+}
+
+TEST_CASE( "BC4 round trip", "[Texture]" ) {
+  using namespace mos::gfx;
+
+  Pixel_block pixels{};
+  for (int i = 0; i < 16; i++) {
+    pixels[i][1] = std::uint8_t(i * 16);
+  }
+  const auto decoded = decode_bc4(encode_bc4(pixels, 1), 1);
+  for (int i = 0; i < 16; i++) {
+    REQUIRE(std::abs(int(decoded[i][1]) - int(pixels[i][1])) <= 18);
+  }
+
+  Pixel_block flat{};
+  flat.fill({7, 7, 7, 7});
+  REQUIRE(decode_bc4(encode_bc4(flat))[5][0] == 7);
+}
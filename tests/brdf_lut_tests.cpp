@@ -0,0 +1,68 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <mos/gfx/brdf_lut.hpp>
+
+namespace {
+
+/** Scalar integration of one texel, as in the shaders of the split sum
+ * approximation. */
+auto reference(const float n_dot_v, const float roughness, const int samples)
+    -> glm::vec2 {
+  const float pi = 3.14159265358979f;
+  const auto a = roughness * roughness;
+  const auto k = a / 2.0f;
+  const float v[3]{std::sqrt(1.0f - n_dot_v * n_dot_v), 0.0f, n_dot_v};
+  float scale = 0.0f;
+  float bias = 0.0f;
+  for (int i = 0; i < samples; i++) {
+    auto bits = std::uint32_t(i);
+    float u = 0.0f;
+    float digit = 0.5f;
+    for (; bits != 0; bits >>= 1, digit /= 2.0f) {
+      u += float(bits & 1) * digit;
+    }
+    const auto phi = 2.0f * pi * float(i) / float(samples);
+    const auto cos_theta = std::sqrt((1.0f - u) / (1.0f + (a * a - 1.0f) * u));
+    const auto sin_theta = std::sqrt(1.0f - cos_theta * cos_theta);
+    const float h[3]{sin_theta * std::cos(phi), sin_theta * std::sin(phi),
+                     cos_theta};
+    const auto v_dot_h = v[0] * h[0] + v[1] * h[1] + v[2] * h[2];
+    const auto n_dot_l = 2.0f * v_dot_h * h[2] - v[2];
+    if (n_dot_l > 0.0f) {
+      const auto g = (n_dot_v / (n_dot_v * (1.0f - k) + k)) *
+                     (n_dot_l / (n_dot_l * (1.0f - k) + k));
+      const auto g_vis = g * v_dot_h / (h[2] * n_dot_v);
+      const auto fresnel = std::pow(1.0f - v_dot_h, 5.0f);
+      scale += (1.0f - fresnel) * g_vis;
+      bias += fresnel * g_vis;
+    }
+  }
+  return {scale / float(samples), bias / float(samples)};
+}
+
+} // namespace
+
+TEST_CASE( "BRDF LUT matches a scalar integration", "[brdf_lut]" ) {
+  const int size = 30;
+  const int samples = 256;
+  const auto lut = mos::gfx::brdf_lut(size, samples);
+  REQUIRE( lut->size() == size * size );
+  for (const auto [x, y] : {std::pair{0, 0}, std::pair{29, 0},
+                            std::pair{13, 17}, std::pair{2, 29},
+                            std::pair{29, 29}}) {
+    const auto expected = reference((float(x) + 0.5f) / float(size),
+                                    (float(y) + 0.5f) / float(size), samples);
+    const auto texel = (*lut)[y * size + x];
+    REQUIRE( texel.x == Approx(expected.x).margin(1e-4) );
+    REQUIRE( texel.y == Approx(expected.y).margin(1e-4) );
+  }
+  // A smooth surface seen head on reflects F0 unchanged.
+  REQUIRE( (*lut)[size - 1].x + (*lut)[size - 1].y == Approx(1.0f).margin(0.02) );
+}
+
+TEST_CASE( "BRDF LUT is computed once per size and sample count",
+           "[brdf_lut]" ) {
+  REQUIRE( mos::gfx::brdf_lut(8, 16) == mos::gfx::brdf_lut(8, 16) );
+  REQUIRE( mos::gfx::brdf_lut(8, 16) != mos::gfx::brdf_lut(8, 32) );
+  REQUIRE_THROWS( mos::gfx::brdf_lut(0, 16) );
+}
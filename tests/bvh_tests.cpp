@@ -0,0 +1,120 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <random>
+#include <mos/gfx/bvh.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+auto random_spheres(const std::size_t count, const unsigned int seed)
+    -> std::vector<mos::gfx::Bvh::Sphere> {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+  std::uniform_real_distribution<float> radius(0.0f, 2.0f);
+  std::vector<mos::gfx::Bvh::Sphere> spheres(count);
+  for (auto &sphere : spheres) {
+    sphere = {{position(generator), position(generator), position(generator)},
+              radius(generator)};
+  }
+  return spheres;
+}
+
+auto query(const mos::gfx::Bvh &bvh, const mos::gfx::Camera &camera)
+    -> std::vector<mos::gfx::Bvh::Index> {
+  std::vector<mos::gfx::Bvh::Index> indices;
+  bvh.query(camera.frustum_planes(), indices);
+  std::sort(indices.begin(), indices.end());
+  return indices;
+}
+
+auto in_frustum(const std::vector<mos::gfx::Bvh::Sphere> &spheres,
+                const mos::gfx::Camera &camera)
+    -> std::vector<mos::gfx::Bvh::Index> {
+  std::vector<mos::gfx::Bvh::Index> indices;
+  for (std::size_t i = 0; i < spheres.size(); i++) {
+    if (camera.in_frustum(spheres[i].center, spheres[i].radius)) {
+      indices.push_back(mos::gfx::Bvh::Index(i));
+    }
+  }
+  return indices;
+}
+
+const mos::gfx::Camera camera{
+    glm::vec3(2.0f, -5.0f, 1.0f), glm::vec3(0.0f, 10.0f, 0.0f),
+    glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 30.0f)};
+
+} // namespace
+
+TEST_CASE("Bvh frustum query matches camera frustum tests", "[Bvh]") {
+  auto spheres = random_spheres(2000, 3);
+  mos::gfx::Bvh bvh;
+  bvh.build(spheres);
+  REQUIRE(bvh.size() == spheres.size());
+  REQUIRE(query(bvh, camera) == in_frustum(spheres, camera));
+
+  SECTION("After refit") {
+    for (auto &sphere : spheres) {
+      sphere.center += glm::vec3(0.5f, -1.0f, 0.25f);
+    }
+    bvh.refit(spheres);
+    REQUIRE(query(bvh, camera) == in_frustum(spheres, camera));
+  }
+
+  SECTION("Negative radii are not found") {
+    spheres[0].radius = -1.0f;
+    spheres[0].center = camera.position() + camera.direction() * 5.0f;
+    bvh.refit(spheres);
+    const auto indices = query(bvh, camera);
+    REQUIRE(std::find(indices.begin(), indices.end(), 0) == indices.end());
+  }
+}
+
+TEST_CASE("Bvh rebuilds when refit grows too loose", "[Bvh]") {
+  auto spheres = random_spheres(500, 5);
+  mos::gfx::Bvh bvh;
+  bvh.build(spheres);
+  bvh.refit(spheres);
+  REQUIRE(bvh.builds() == 1);
+
+  std::shuffle(spheres.begin(), spheres.end(), std::mt19937(1));
+  bvh.refit(spheres);
+  REQUIRE(bvh.builds() == 2);
+  REQUIRE(query(bvh, camera) == in_frustum(spheres, camera));
+}
+
+TEST_CASE("Bvh ray intersection finds the closest sphere", "[Bvh]") {
+  const auto spheres = random_spheres(2000, 7);
+  mos::gfx::Bvh bvh;
+  bvh.build(spheres);
+
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+  for (int i = 0; i < 100; i++) {
+    const mos::sim::Ray ray(glm::vec3(0.0f, 0.0f, 30.0f),
+                            glm::vec3(direction(generator) * 0.5f,
+                                      direction(generator) * 0.5f, -1.0f));
+    std::optional<mos::gfx::Bvh::Hit> closest;
+    for (std::size_t j = 0; j < spheres.size(); j++) {
+      const auto to_center = spheres[j].center - ray.origin;
+      const auto along = glm::dot(to_center, ray.direction());
+      const auto squared = spheres[j].radius * spheres[j].radius -
+                           (glm::dot(to_center, to_center) - along * along);
+      if (squared >= 0.0f) {
+        const auto distance = along - std::sqrt(squared);
+        if (!closest || distance < closest->distance) {
+          closest = mos::gfx::Bvh::Hit{mos::gfx::Bvh::Index(j), distance};
+        }
+      }
+    }
+    const auto hit = bvh.intersect(ray);
+    REQUIRE(hit.has_value() == closest.has_value());
+    if (hit) {
+      REQUIRE(hit->index == closest->index);
+      REQUIRE(hit->distance == Approx(closest->distance));
+    }
+  }
+
+  const mos::sim::Ray away(glm::vec3(0.0f, 0.0f, 30.0f),
+                           glm::vec3(0.0f, 0.0f, 1.0f));
+  REQUIRE_FALSE(bvh.intersect(away).has_value());
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+#include <mos/gfx/culling.hpp>
+#include <mos/gl/command_recorder.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+using mos::gl::Command_recorder;
+
+namespace {
+
+/** A row of models along the view direction, every third without a mesh. */
+struct Fixture {
+  Fixture() {
+    for (int i = 0; i < 300; i++) {
+      graph.add(mos::gfx::Scene_graph::none,
+                glm::translate(glm::mat4(1.0f),
+                               glm::vec3(float(i % 30) - 15.0f,
+                                         float(i) * 0.2f, 0.0f)),
+                {glm::vec3(0.0f), 0.5f});
+      drawables.push_back(mos::gl::Drawable{
+          i % 3 == 0 ? 0u : 1u + unsigned(i % 4), 12,
+          {10u + unsigned(i % 2), 20, 30, 40, 50, 60},
+          {glm::vec3(0.5f), glm::vec3(float(i % 5))}});
+    }
+    graph.update();
+    for (const auto &sphere : graph.spheres()) {
+      culling.add(sphere.center, sphere.radius);
+    }
+    culling.add(camera);
+    culling.cull();
+  }
+  mos::gfx::Scene_graph graph;
+  std::vector<mos::gl::Drawable> drawables;
+  mos::gfx::Camera camera{
+      glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+      glm::perspective(glm::half_pi<float>(), 1.0f, 0.1f, 40.0f)};
+  mos::gfx::Culling culling;
+};
+
+auto expected_draws(const Fixture &fixture) -> std::size_t {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < fixture.drawables.size(); i++) {
+    count += fixture.culling.visible(0, i) &&
+             fixture.drawables[i].vertex_array != 0;
+  }
+  return count;
+}
+
+} // namespace
+
+TEST_CASE( "Recorded passes match culling without GL", "[Command_recorder]" ) {
+  Fixture fixture;
+  const std::vector<Command_recorder::Pass> passes{
+      {1, false, fixture.camera.position(), 0, fixture.drawables.size(),
+       fixture.culling.visibility(0)},
+      {2, true, fixture.camera.position(), 0, fixture.drawables.size(),
+       fixture.culling.visibility(0)},
+      {1, false, fixture.camera.position(), 100, 200,
+       fixture.culling.visibility(0)},
+      {}};
+
+  Command_recorder recorder;
+  recorder.record(passes, fixture.drawables, fixture.graph);
+  REQUIRE( recorder.size() == 4 );
+  REQUIRE( expected_draws(fixture) > 0 );
+  REQUIRE( recorder.list(0).size() == expected_draws(fixture) );
+  REQUIRE( recorder.list(1).size() == expected_draws(fixture) );
+  REQUIRE( recorder.list(2).size() < recorder.list(0).size() );
+  REQUIRE( recorder.list(3).size() == 0 );
+
+  for (const auto &draw : recorder.list(1)) {
+    REQUIRE( draw.program == 2 );
+    REQUIRE( draw.textures[1] == 0 );
+    REQUIRE( draw.material.roughness == 1.0f );
+  }
+  for (const auto &draw : recorder.list(0)) {
+    REQUIRE( draw.textures[5] == 60 );
+    REQUIRE( draw.normal != nullptr );
+  }
+
+  SECTION( "Parallel recording records the same lists" ) {
+    mos::Thread_pool pool(4);
+    Command_recorder parallel;
+    parallel.record(passes, fixture.drawables, fixture.graph, &pool);
+    for (std::size_t pass = 0; pass < passes.size(); pass++) {
+      const auto &a = recorder.list(pass);
+      const auto &b = parallel.list(pass);
+      REQUIRE( a.size() == b.size() );
+      REQUIRE( a.stats().batches == b.stats().batches );
+      REQUIRE( std::equal(a.begin(), a.end(), b.begin(),
+                          [](const auto &x, const auto &y) {
+                            return x.key == y.key &&
+                                   x.transform == y.transform;
+                          }) );
+    }
+  }
+}
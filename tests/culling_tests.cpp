@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+#include <random>
+#include <mos/gfx/culling.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+TEST_CASE("Culling matches camera frustum tests", "[Culling]") {
+  const std::vector<mos::gfx::Camera> cameras{
+      {glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+       glm::perspective(glm::half_pi<float>(), 1.0f, 0.1f, 10.0f)},
+      {glm::vec3(5.0f, 2.0f, 1.0f), glm::vec3(-3.0f, 0.0f, 0.0f),
+       glm::perspective(glm::radians(45.0f), 1.5f, 0.5f, 50.0f)},
+      {glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f),
+       glm::ortho(-4.0f, 4.0f, -4.0f, 4.0f, 1.0f, 20.0f),
+       glm::vec3(0.0f, 1.0f, 0.0f)}};
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+  std::uniform_real_distribution<float> radius(0.0f, 3.0f);
+  std::vector<std::pair<glm::vec3, float>> spheres(GENERATE(1001, 3001));
+  for (auto &sphere : spheres) {
+    sphere = {{position(generator), position(generator), position(generator)},
+              radius(generator)};
+  }
+
+  mos::gfx::Culling culling;
+  for (const auto &[center, r] : spheres) {
+    culling.add(center, r);
+  }
+  for (const auto &camera : cameras) {
+    culling.add(camera);
+  }
+  culling.cull();
+
+  REQUIRE(culling.size() == spheres.size());
+  REQUIRE(culling.views() == cameras.size());
+  for (std::size_t view = 0; view < cameras.size(); view++) {
+    for (std::size_t i = 0; i < spheres.size(); i++) {
+      REQUIRE(culling.visible(view, i) ==
+              cameras[view].in_frustum(spheres[i].first, spheres[i].second));
+    }
+  }
+}
+
+TEST_CASE("Culling never shows negative radii or padding", "[Culling]") {
+  const mos::gfx::Camera camera{
+      glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+      glm::perspective(glm::half_pi<float>(), 1.0f, 0.1f, 10.0f)};
+  mos::gfx::Culling culling;
+  culling.add(glm::vec3(0.0f, 2.0f, 0.0f), 1.0f);
+  culling.add(glm::vec3(0.0f, 2.0f, 0.0f), -1.0f);
+  culling.add(camera);
+  culling.cull();
+
+  const auto visibility = culling.visibility(0);
+  REQUIRE(visibility.size() == 1);
+  REQUIRE(visibility[0] == 1);
+}
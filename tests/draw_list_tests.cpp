@@ -0,0 +1,217 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <random>
+#include <mos/gl/draw_list.hpp>
+
+namespace {
+
+/** Draws in scene order, many models sharing few materials and meshes. */
+auto scene(mos::gl::Draw_list &list, const int count) {
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<unsigned int> material(0, 3);
+  std::uniform_int_distribution<unsigned int> mesh(1, 8);
+  std::uniform_real_distribution<float> distance(1.0f, 100.0f);
+  for (int i = 0; i < count; i++) {
+    const auto m = material(generator);
+    mos::gl::Draw draw;
+    draw.program = 1;
+    draw.vertex_array = mesh(generator);
+    draw.textures = {10 + m, 20 + m, 30 + m, 1, 1, 2};
+    draw.material.roughness = float(m) / 4.0f;
+    draw.distance = distance(generator);
+    list.add(draw);
+  }
+}
+
+} // namespace
+
+TEST_CASE( "Sorted draws change less state", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  scene(list, 1000);
+  list.prepare(mos::gl::Draw_list::Order::Submission);
+  const auto unsorted = list.stats();
+
+  list.prepare();
+  const auto sorted = list.stats();
+
+  REQUIRE( sorted.draws == 1000 );
+  REQUIRE( sorted.programs == 1 );
+  REQUIRE( sorted.materials == 4 );
+  REQUIRE( sorted.textures < unsorted.textures / 10 );
+  REQUIRE( sorted.vertex_arrays <= 4 * 8 );
+  REQUIRE( sorted.vertex_arrays < unsorted.vertex_arrays / 10 );
+}
+
+TEST_CASE( "Translucent draws are last, back to front", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  mos::gl::Draw near;
+  near.material.alpha = 0.5f;
+  near.distance = 1.0f;
+  mos::gl::Draw far = near;
+  far.distance = 10.0f;
+  mos::gl::Draw opaque;
+  opaque.distance = 100.0f;
+
+  list.add(near);
+  list.add(opaque);
+  list.add(far);
+  list.prepare();
+
+  auto it = list.begin();
+  REQUIRE( it++->distance == 100.0f );
+  REQUIRE( it++->distance == 10.0f );
+  REQUIRE( it++->distance == 1.0f );
+}
+
+TEST_CASE( "Draws of the same mesh and state are batched", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  scene(list, 1000);
+  list.prepare();
+  const auto stats = list.stats();
+  const auto &batches = list.batches();
+
+  REQUIRE( stats.batches == int(batches.size()) );
+  REQUIRE( stats.batches <= 4 * 8 );
+  REQUIRE( list.instances().size() == 1000 );
+
+  std::uint32_t next = 0;
+  for (const auto &batch : batches) {
+    REQUIRE( batch.first == next );
+    const auto &first = *(list.begin() + batch.first);
+    for (std::uint32_t i = 1; i < batch.count; i++) {
+      const auto &draw = *(list.begin() + batch.first + i);
+      REQUIRE( draw.vertex_array == first.vertex_array );
+      REQUIRE( draw.material == first.material );
+      REQUIRE( draw.textures == first.textures );
+    }
+    next += batch.count;
+  }
+  REQUIRE( next == 1000 );
+}
+
+TEST_CASE( "Instances hold the model and normal matrices", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  mos::gl::Draw draw;
+  draw.transform = glm::mat4(2.0f);
+  draw.transform[3] = glm::vec4(1.0f, 2.0f, 3.0f, 1.0f);
+  list.add(draw);
+  list.prepare();
+
+  const auto &instance = list.instances().front();
+  REQUIRE( instance.model[3].y == 2.0f );
+  REQUIRE( instance.normal[0].x == Approx(0.5f) );
+  REQUIRE( instance.normal[3].x == 0.0f );
+}
+
+TEST_CASE( "Instances use a cached normal matrix", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  const glm::mat4 normal(3.0f);
+  mos::gl::Draw draw;
+  draw.transform = glm::mat4(2.0f);
+  draw.normal = &normal;
+  list.add(draw);
+  list.prepare();
+
+  REQUIRE( list.instances().front().normal[0].x == 3.0f );
+}
+
+TEST_CASE( "Batches of arena meshes become indirect commands", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  scene(list, 1000);
+  std::vector<mos::gl::Draw> draws(list.begin(), list.end());
+  list.clear();
+  for (auto draw : draws) {
+    // All meshes in one vertex array, told apart by their ranges.
+    draw.first_index = draw.vertex_array * 36;
+    draw.base_vertex = std::int32_t(draw.vertex_array * 24);
+    draw.num_indices = 12;
+    draw.vertex_array = 1;
+    list.add(draw);
+  }
+  list.prepare();
+  const auto stats = list.stats();
+  const auto &commands = list.commands();
+  const auto &instances = list.instances();
+
+  REQUIRE( commands.size() == list.batches().size() );
+  REQUIRE( stats.batches <= 4 * 8 );
+  REQUIRE( stats.multi_draws == 4 );
+  REQUIRE( list.materials().size() == 4 );
+
+  std::uint32_t next = 0;
+  for (const auto &command : commands) {
+    REQUIRE( command.base_instance == next );
+    REQUIRE( command.count == 36 );
+    for (std::uint32_t i = 0; i < command.instance_count; i++) {
+      const auto &draw = *(list.begin() + command.base_instance + i);
+      const auto &material =
+          list.materials().at(instances.at(command.base_instance + i).material);
+      REQUIRE( draw.first_index == command.first_index );
+      REQUIRE( draw.base_vertex == command.base_vertex );
+      REQUIRE( material.roughness == draw.material.roughness );
+    }
+    next += command.instance_count;
+  }
+  REQUIRE( next == 1000 );
+}
+
+TEST_CASE( "Depth order draws opaque front to back first", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  scene(list, 1000);
+  std::vector<mos::gl::Draw> draws(list.begin(), list.end());
+  list.clear();
+  for (std::size_t i = 0; i < draws.size(); i++) {
+    draws[i].material.alpha = i % 10 == 0 ? 0.5f : 1.0f;
+    list.add(draws[i]);
+  }
+  list.prepare(mos::gl::Draw_list::Order::Depth);
+
+  const auto &batches = list.batches();
+  const auto opaque = list.opaque_batches();
+  REQUIRE( opaque < batches.size() );
+  const auto first_translucent = list.begin() + batches.at(opaque).first;
+  REQUIRE( std::count_if(list.begin(), first_translucent, [](const auto &draw) {
+             return draw.material.translucent(); }) == 0 );
+  REQUIRE( std::count_if(first_translucent, list.end(), [](const auto &draw) {
+             return draw.material.translucent(); }) == 100 );
+  REQUIRE( std::is_sorted(list.begin(), first_translucent,
+                          [](const auto &a, const auto &b) {
+                            return a.distance < b.distance; }) );
+
+  list.prepare();
+  REQUIRE( list.batches().at(list.opaque_batches()).first == 900 );
+}
+
+TEST_CASE( "Hash changes with what is drawn", "[Draw_list]" ) {
+  mos::gl::Draw_list list;
+  scene(list, 100);
+  list.prepare();
+  const auto hash = list.hash();
+  list.prepare();
+  REQUIRE( list.hash() == hash );
+
+  mos::gl::Draw moved;
+  moved.vertex_array = 1;
+  moved.num_indices = 3;
+  moved.transform[3][0] = 1.0f;
+  list.add(moved);
+  list.prepare();
+  const auto added = list.hash();
+  REQUIRE( added != hash );
+
+  list.clear();
+  scene(list, 100);
+  moved.transform[3][0] = 2.0f;
+  list.add(moved);
+  list.prepare();
+  const auto transformed = list.hash();
+  REQUIRE( transformed != added );
+
+  // The same mesh uploaded again.
+  list.clear();
+  scene(list, 100);
+  moved.vertex_generation++;
+  list.add(moved);
+  list.prepare();
+  REQUIRE( list.hash() != transformed );
+}
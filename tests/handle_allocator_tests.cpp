@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mos/core/handle_allocator.hpp>
+#include <mos/core/id.hpp>
+
+TEST_CASE( "Released slots are reused with a new generation", "[Handle_allocator]" ) {
+  mos::Handle_allocator allocator;
+  const auto handle0 = allocator.create();
+  REQUIRE( allocator.alive(handle0) );
+
+  allocator.retain(handle0);
+  REQUIRE_FALSE( allocator.release(handle0) );
+  REQUIRE( allocator.release(handle0) );
+  REQUIRE_FALSE( allocator.alive(handle0) );
+
+  const auto handle1 = allocator.create();
+  REQUIRE( handle1.index == handle0.index );
+  REQUIRE( handle1.generation == handle0.generation + 1 );
+  REQUIRE( allocator.alive(handle1) );
+  REQUIRE( allocator.capacity() == 1 );
+}
+
+TEST_CASE( "Copied ids share a slot", "[Id]" ) {
+  struct Type {};
+  int released;
+  {
+    mos::Id<Type> id0;
+    mos::Id<Type> id1 = id0;
+    REQUIRE( id1 == id0 );
+    released = id0;
+  }
+  mos::Id<Type> id2;
+  REQUIRE( id2 == released );
+}
+
+TEST_CASE( "Concurrent creation and release", "[Handle_allocator]" ) {
+  constexpr int total = 10'000'000;
+  constexpr int window = 64;
+  const int num_threads = int(std::max(2U, std::thread::hardware_concurrency()));
+
+  mos::Handle_allocator allocator;
+  // Set while a thread holds the slot, two live handles may never share one.
+  std::vector<std::atomic<int>> owned(num_threads * window);
+  std::atomic<int> collisions{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&]() {
+      std::vector<mos::Handle> handles;
+      for (int i = 0; i < total / num_threads; i++) {
+        if (handles.size() == window) {
+          const auto handle = handles[i % window];
+          handles[i % window] = handles.back();
+          handles.pop_back();
+          owned[handle.index].store(0);
+          allocator.release(handle);
+        }
+        const auto handle = allocator.create();
+        if (handle.index >= owned.size() || owned[handle.index].exchange(1)) {
+          collisions++;
+        } else {
+          handles.push_back(handle);
+        }
+      }
+      for (const auto &handle : handles) {
+        owned[handle.index].store(0);
+        allocator.release(handle);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE( collisions == 0 );
+  REQUIRE( allocator.size() == 0 );
+  REQUIRE( allocator.capacity() <= std::uint32_t(num_threads * window) );
+}
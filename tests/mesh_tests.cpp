@@ -1,6 +1,12 @@
 #include <catch2/catch.hpp>
 #include <mos/gfx/mesh.hpp>
+#include <mos/gfx/mesh_file.hpp>
+#include <mos/gfx/mesh_kernels.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtx/io.hpp>
+#include <glm/gtx/normal.hpp>
+#include <filesystem>
+#include <fstream>
 
 TEST_CASE( "Flat normals", "[Mesh]" ) {
   using namespace mos::gfx;
@@ -42,3 +48,196 @@ TEST_CASE( "Bounding sphere", "[Mesh]" ) {
   REQUIRE(mesh.radius() == expected_radius);
   REQUIRE(mesh.centroid() == expected_centroid);
 }
+
+TEST_CASE( "Mesh2 round trip", "[Mesh]" ) {
+  using namespace mos::gfx;
+
+  auto v0 = Vertex{glm::vec3(0.0F), glm::vec3(0.0F, 0.0F, 1.0F), glm::vec3(1.0F, 0.0F, 0.0F), glm::vec2(0.0F)};
+  auto v1 = Vertex{glm::vec3(1.0F, 0.0F, 0.0F), glm::vec3(0.0F, 0.0F, 1.0F), glm::vec3(1.0F, 0.0F, 0.0F), glm::vec2(1.0F, 0.0F)};
+  auto v2 = Vertex{glm::vec3(0.0F, 1.0F, 0.0F), glm::vec3(0.0F, 0.0F, 1.0F), glm::vec3(1.0F, 0.0F, 0.0F), glm::vec2(0.0F, 1.0F)};
+
+  Mesh mesh({v0, v1, v2}, {{0, 1, 2}});
+
+  const auto path = (std::filesystem::temp_directory_path() / "mos_test.mesh2").string();
+  Mesh_file::write(path, mesh);
+
+  const auto loaded = Mesh::load(path);
+  std::filesystem::remove(path);
+
+  REQUIRE(loaded.vertices.size() == mesh.vertices.size());
+  REQUIRE(loaded.indices.size() == mesh.indices.size());
+  for (size_t i = 0; i < mesh.vertices.size(); i++) {
+    REQUIRE(loaded.vertices[i].position == mesh.vertices[i].position);
+    REQUIRE(loaded.vertices[i].tangent == mesh.vertices[i].tangent);
+  }
+  REQUIRE(loaded.indices[0] == mesh.indices[0]);
+  REQUIRE(loaded.centroid() == mesh.centroid());
+  REQUIRE(loaded.radius() == mesh.radius());
+}
+
+TEST_CASE( "Kernels match glm on blocks and remainders", "[Mesh]" ) {
+  using namespace mos::gfx;
+  using kernels::Execution;
+
+  // Seven vertices, one block of four and three left over.
+  std::vector<Vertex> from;
+  std::vector<Vertex> to;
+  for (int i = 0; i < 7; i++) {
+    const auto f = float(i);
+    from.push_back(Vertex{glm::vec3(f, 1.0F - f, 0.5F * f),
+                          glm::normalize(glm::vec3(1.0F, f, 2.0F)),
+                          glm::normalize(glm::vec3(f, 1.0F, -1.0F)),
+                          glm::vec2(f, 0.0F)});
+    to.push_back(Vertex{glm::vec3(-f, 2.0F, f * f),
+                        glm::normalize(glm::vec3(f, -1.0F, 1.0F)),
+                        glm::vec3(0.0F, 0.0F, 1.0F), glm::vec2(0.0F, f)});
+  }
+  const auto transform = glm::mat4(glm::vec4(0.0F, 2.0F, 0.0F, 0.0F),
+                                   glm::vec4(-1.0F, 0.0F, 0.5F, 0.0F),
+                                   glm::vec4(0.0F, 0.0F, 3.0F, 0.0F),
+                                   glm::vec4(1.0F, 2.0F, 3.0F, 1.0F));
+  const auto normal_transform = glm::mat3(glm::inverseTranspose(transform));
+
+  auto vertices = from;
+  kernels::transform(vertices, transform, Execution::Sequential);
+  for (size_t i = 0; i < vertices.size(); i++) {
+    const auto position = glm::vec3(transform * glm::vec4(from[i].position, 1.0F));
+    REQUIRE(glm::distance(vertices[i].position, position) == Approx(0.0F).margin(1e-6));
+    REQUIRE(glm::distance(vertices[i].normal, normal_transform * from[i].normal) == Approx(0.0F).margin(1e-6));
+    REQUIRE(glm::distance(vertices[i].tangent, normal_transform * from[i].tangent) == Approx(0.0F).margin(1e-6));
+    REQUIRE(vertices[i].uv == from[i].uv);
+  }
+
+  kernels::mix(vertices, from, to, 0.25F, Execution::Sequential);
+  for (size_t i = 0; i < vertices.size(); i++) {
+    REQUIRE(glm::distance(vertices[i].position, glm::mix(from[i].position, to[i].position, 0.25F)) == Approx(0.0F).margin(1e-6));
+    REQUIRE(glm::distance(vertices[i].normal, glm::mix(from[i].normal, to[i].normal, 0.25F)) == Approx(0.0F).margin(1e-6));
+    REQUIRE(glm::distance(vertices[i].uv, glm::mix(from[i].uv, to[i].uv, 0.25F)) == Approx(0.0F).margin(1e-6));
+  }
+
+  // The farthest vertex is in the remainder.
+  const auto sphere = kernels::bounding_sphere(to, Execution::Sequential);
+  auto centroid = glm::vec3(0.0F);
+  for (const auto &vertex : to) {
+    centroid += vertex.position;
+  }
+  centroid /= float(to.size());
+  REQUIRE(sphere.radius == Approx(glm::distance(to.back().position, centroid)));
+}
+
+TEST_CASE( "Mesh2 headers past the end are rejected", "[Mesh]" ) {
+  using namespace mos::gfx;
+
+  Mesh mesh({Vertex{}, Vertex{}, Vertex{}}, {{0, 1, 2}});
+  const auto path = (std::filesystem::temp_directory_path() / "mos_hostile.mesh2").string();
+  Mesh_file::write(path, mesh);
+
+  // Offsets whose end wraps around, and counts past the end of the file.
+  const auto rewrite = [&](auto &&change) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    Mesh_file::Header header{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    change(header);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  };
+  REQUIRE_NOTHROW( Mesh_file(path) );
+  rewrite([](auto &header) { header.vertices_offset = ~std::uint64_t(63); });
+  REQUIRE_THROWS( Mesh_file(path) );
+  rewrite([](auto &header) {
+    header.vertices_offset = Mesh_file::alignment;
+    header.num_triangles = 1000;
+  });
+  REQUIRE_THROWS( Mesh_file(path) );
+  std::filesystem::remove(path);
+}
+
+namespace {
+auto wavy_grid(const int size) -> mos::gfx::Mesh {
+  using namespace mos::gfx;
+  Mesh mesh;
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const auto position = glm::vec3(float(x), float(y), glm::sin(float(x * y) * 0.1F));
+      mesh.vertices.push_back(Vertex{position, glm::vec3(0.0F), glm::vec3(0.0F),
+                                     glm::vec2(float(x), float(y)) / float(size)});
+    }
+  }
+  for (int y = 0; y < size - 1; y++) {
+    for (int x = 0; x < size - 1; x++) {
+      const int i = y * size + x;
+      mesh.indices.push_back({i, i + 1, i + size});
+      mesh.indices.push_back({i + 1, i + size + 1, i + size});
+    }
+  }
+  return mesh;
+}
+}
+
+TEST_CASE( "Smooth normals", "[Mesh]" ) {
+  using namespace mos::gfx;
+
+  auto mesh = wavy_grid(16);
+  mesh.calculate_normals();
+
+  // Brute force, sum the normals of all triangles using each vertex.
+  for (size_t i = 0; i < mesh.vertices.size(); i++) {
+    auto normal = glm::vec3(0.0F);
+    for (const auto &t : mesh.indices) {
+      if (t[0] == int(i) || t[1] == int(i) || t[2] == int(i)) {
+        normal += glm::triangleNormal(mesh.vertices[t[0]].position,
+                                      mesh.vertices[t[1]].position,
+                                      mesh.vertices[t[2]].position);
+      }
+    }
+    REQUIRE(mesh.vertices[i].normal == glm::normalize(normal));
+  }
+}
+
+TEST_CASE( "Parallel kernels", "[Mesh]" ) {
+  using namespace mos::gfx;
+  using kernels::Execution;
+
+  auto sequential = wavy_grid(64);
+  sequential.calculate_normals();
+  sequential.calculate_tangents();
+  auto parallel = sequential;
+  const auto other = wavy_grid(64);
+  const auto transform = glm::mat4(glm::vec4(2.0F, 0.0F, 0.0F, 0.0F),
+                                   glm::vec4(0.0F, 0.0F, 3.0F, 0.0F),
+                                   glm::vec4(0.0F, -1.0F, 0.0F, 0.0F),
+                                   glm::vec4(1.0F, 2.0F, 3.0F, 1.0F));
+
+  auto span = [](Mesh &mesh) { return std::span<Vertex>(mesh.vertices.begin(), mesh.vertices.end()); };
+  auto const_span = [](const Mesh &mesh) { return std::span(mesh.vertices.data(), mesh.vertices.size()); };
+
+  kernels::transform(span(sequential), transform, Execution::Sequential);
+  kernels::transform(span(parallel), transform, Execution::Parallel);
+  kernels::mix(span(sequential), const_span(sequential), const_span(other), 0.25F, Execution::Sequential);
+  kernels::mix(span(parallel), const_span(parallel), const_span(other), 0.25F, Execution::Parallel);
+
+  for (size_t i = 0; i < sequential.vertices.size(); i++) {
+    const auto &vertex = sequential.vertices[i];
+    REQUIRE(parallel.vertices[i].position == vertex.position);
+    REQUIRE(parallel.vertices[i].normal == vertex.normal);
+    REQUIRE(parallel.vertices[i].tangent == vertex.tangent);
+  }
+
+  const auto sphere = kernels::bounding_sphere(const_span(sequential), Execution::Sequential);
+  const auto parallel_sphere = kernels::bounding_sphere(const_span(parallel), Execution::Parallel);
+  REQUIRE(parallel_sphere.radius == Approx(sphere.radius));
+  REQUIRE(parallel_sphere.centroid.x == Approx(sphere.centroid.x));
+  REQUIRE(parallel_sphere.centroid.y == Approx(sphere.centroid.y));
+  REQUIRE(parallel_sphere.centroid.z == Approx(sphere.centroid.z));
+
+  // Same as transforming each vertex on its own.
+  auto reference = other;
+  auto transformed = other;
+  transformed.apply_transform(transform);
+  for (size_t i = 0; i < reference.vertices.size(); i++) {
+    auto vertex = Vertex{reference.vertices[i]};
+    vertex.apply_transform(transform);
+    REQUIRE(glm::distance(transformed.vertices[i].position, vertex.position) == Approx(0.0F).margin(1e-4));
+    REQUIRE(glm::distance(transformed.vertices[i].normal, vertex.normal) == Approx(0.0F).margin(1e-4));
+  }
+}
@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+#include <vector>
+#include <mos/gl/probe_scheduler.hpp>
+
+using mos::gl::Probe_scheduler;
+
+TEST_CASE( "Probe faces stay within the budget, nearest first",
+           "[Probe_scheduler]" ) {
+  Probe_scheduler scheduler(3);
+  std::vector<Probe_scheduler::Probe> probes(3);
+  probes[0] = {true, 10.0f, 1, false};
+  probes[1] = {true, 1.0f, 2, false};
+  probes[2] = {false, 0.0f, 3, false};
+
+  scheduler.schedule(probes);
+  const auto &faces = scheduler.faces();
+  REQUIRE( faces.size() == 3 );
+  REQUIRE( faces[0].probe == 1 );
+  REQUIRE( faces[0].face == 0 );
+  REQUIRE( faces[1].probe == 0 );
+  REQUIRE( faces[2].probe == 1 );
+  REQUIRE( faces[2].face == 1 );
+  REQUIRE( scheduler.stats().pending == 2 );
+
+  int completed = 0;
+  for (int frame = 0; frame < 3; frame++) {
+    scheduler.schedule(probes);
+    for (const auto &face : scheduler.faces()) {
+      completed += face.completes ? 1 : 0;
+    }
+  }
+  REQUIRE( completed == 2 );
+
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().empty() );
+  REQUIRE( scheduler.stats().converged == 2 );
+}
+
+TEST_CASE( "Changed probes render another cycle", "[Probe_scheduler]" ) {
+  Probe_scheduler scheduler(6);
+  std::vector<Probe_scheduler::Probe> probes{{true, 0.0f, 1, false}};
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().back().completes );
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().empty() );
+
+  probes[0].changed = true;
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().size() == 6 );
+  REQUIRE( scheduler.faces().front().face == 0 );
+
+  // A change during a cycle completes it first.
+  probes[0].changed = false;
+  scheduler.budget(2);
+  probes[0].state = 2;
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().front().face == 0 );
+  probes[0].state = 3;
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().front().face == 2 );
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().back().completes );
+  scheduler.schedule(probes);
+  REQUIRE( scheduler.faces().front().face == 0 );
+  REQUIRE( scheduler.stats().converged == 0 );
+}
+
+TEST_CASE( "Probes changing every frame still complete",
+           "[Probe_scheduler]" ) {
+  for (const int budget : {1, 2, 4, 6}) {
+    Probe_scheduler scheduler(budget);
+    std::vector<Probe_scheduler::Probe> probes{{true, 0.0f, 1, true}};
+    const auto frames = (Probe_scheduler::cube_faces + budget - 1) / budget;
+    for (int cycle = 0; cycle < 3; cycle++) {
+      int completes = 0;
+      for (int frame = 0; frame < frames; frame++) {
+        probes[0].state++;
+        scheduler.schedule(probes);
+        for (const auto &face : scheduler.faces()) {
+          completes += face.completes ? 1 : 0;
+        }
+      }
+      REQUIRE( completes == 1 );
+    }
+  }
+}
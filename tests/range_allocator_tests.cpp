@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+#include <mos/core/range_allocator.hpp>
+
+using mos::Range_allocator;
+
+TEST_CASE( "Freed ranges merge with their neighbours", "[Range_allocator]" ) {
+  Range_allocator allocator(100);
+  const auto a = allocator.allocate(10);
+  const auto b = allocator.allocate(20);
+  const auto c = allocator.allocate(30);
+  REQUIRE( a == 0u );
+  REQUIRE( b == 10u );
+  REQUIRE( c == 30u );
+  REQUIRE_FALSE( allocator.allocate(41) );
+
+  allocator.free(*a, 10);
+  allocator.free(*c, 30);
+  auto stats = allocator.stats();
+  REQUIRE( stats.used == 20 );
+  REQUIRE( stats.free_ranges == 2 );
+  REQUIRE( stats.largest_free == 70 );
+  REQUIRE( stats.fragmentation() == Approx(1.0f - 70.0f / 80.0f) );
+
+  allocator.free(*b, 20);
+  stats = allocator.stats();
+  REQUIRE( stats.used == 0 );
+  REQUIRE( stats.ranges == 0 );
+  REQUIRE( stats.free_ranges == 1 );
+  REQUIRE( stats.fragmentation() == 0.0f );
+  REQUIRE( allocator.allocate(100) == 0u );
+}
+
+TEST_CASE( "Growing extends the free tail", "[Range_allocator]" ) {
+  Range_allocator allocator(16);
+  REQUIRE( allocator.allocate(12) == 0u );
+  REQUIRE_FALSE( allocator.allocate(8) );
+  allocator.grow(32);
+  REQUIRE( allocator.allocate(8) == 12u );
+  REQUIRE( allocator.stats().free_ranges == 1 );
+  REQUIRE_THROWS( allocator.free(30, 4) );
+}
+
+TEST_CASE( "Random allocations never overlap", "[Range_allocator]" ) {
+  Range_allocator allocator(1 << 16);
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<std::uint32_t> size(1, 500);
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+  std::vector<int> owners(1 << 16, 0);
+  for (int i = 0; i < 5000; i++) {
+    if (!ranges.empty() && generator() % 3 == 0) {
+      const auto index = generator() % ranges.size();
+      const auto [offset, count] = ranges[index];
+      for (auto j = offset; j < offset + count; j++) {
+        owners[j]--;
+      }
+      allocator.free(offset, count);
+      ranges.erase(ranges.begin() + std::ptrdiff_t(index));
+    } else if (const auto count = size(generator);
+               const auto offset = allocator.allocate(count)) {
+      for (auto j = *offset; j < *offset + count; j++) {
+        REQUIRE( owners[j]++ == 0 );
+      }
+      ranges.emplace_back(*offset, count);
+    }
+  }
+  std::uint32_t used = 0;
+  for (const auto &range : ranges) {
+    used += range.second;
+  }
+  REQUIRE( allocator.stats().used == used );
+  REQUIRE( allocator.stats().ranges == int(ranges.size()) );
+  for (const auto &[offset, count] : ranges) {
+    allocator.free(offset, count);
+  }
+  REQUIRE( allocator.stats().free_ranges == 1 );
+}
+
+TEST_CASE( "Compacting packs live ranges and shrinks", "[Range_allocator]" ) {
+  Range_allocator allocator(100);
+  const auto a = *allocator.allocate(10);
+  const auto b = *allocator.allocate(20);
+  const auto c = *allocator.allocate(30);
+  allocator.free(b, 20);
+  std::vector<Range_allocator::Range> ranges{{c, 30}, {a, 10}, {0, 0}};
+  allocator.compact(ranges, 0);
+
+  REQUIRE( ranges[1].offset == 0 );
+  REQUIRE( ranges[0].offset == 10 );
+  REQUIRE( ranges[2].offset == 0 );
+  REQUIRE( allocator.capacity() == 40 );
+  REQUIRE( allocator.stats().free_ranges == 0 );
+  REQUIRE_FALSE( allocator.allocate(1) );
+
+  allocator.compact(ranges, 50);
+  REQUIRE( allocator.allocate(10) == 40u );
+  std::vector<Range_allocator::Range> missing{{0, 10}};
+  REQUIRE_THROWS( allocator.compact(missing, 0) );
+}
+
+TEST_CASE( "Only space that would shrink is shrinkable", "[Range_allocator]" ) {
+  Range_allocator allocator(100);
+  const auto a = *allocator.allocate(10);
+  REQUIRE( allocator.shrinkable(0) );
+  REQUIRE( allocator.shrinkable(50) );
+  // Compacting to the minimum would only copy into the same size.
+  REQUIRE_FALSE( allocator.shrinkable(100) );
+
+  const auto b = *allocator.allocate(70);
+  REQUIRE_FALSE( allocator.shrinkable(0) );
+  allocator.free(b, 70);
+  allocator.free(a, 10);
+  REQUIRE( allocator.shrinkable(0) );
+}
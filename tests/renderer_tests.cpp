@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <mos/gl/renderer.hpp>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+/** Renders a triangle with a renderer on the current context. */
+auto render_frame(const glm::ivec2 &resolution, const bool persistent_streaming)
+    -> void {
+  using namespace mos;
+  gl::Renderer renderer(resolution, 1, persistent_streaming);
+  auto mesh = std::make_shared<gfx::Mesh>(
+      gfx::Mesh({gfx::Vertex{glm::vec3(-1.0f, 0.0f, 0.0f)},
+                 gfx::Vertex{glm::vec3(1.0f, 0.0f, 0.0f)},
+                 gfx::Vertex{glm::vec3(0.0f, 0.0f, 1.0f)}},
+                {{0, 1, 2}}));
+  const gfx::Camera camera(glm::vec3(0.0f, -4.0f, 1.0f), glm::vec3(0.0f),
+                           glm::perspective(glm::half_pi<float>(), 1.0f,
+                                            0.1f, 100.0f));
+  // Loads and renders again after clearing.
+  for (int frame = 0; frame < 2; frame++) {
+    const auto model = renderer.load(gfx::Model("triangle", mesh));
+    renderer.render(gfx::Scenes{gfx::Scene(gpu::Models{model}, camera)},
+                    glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), resolution);
+    glFinish();
+    REQUIRE( glGetError() == GL_NO_ERROR );
+    renderer.clear_buffers();
+  }
+}
+
+} // namespace
+
+TEST_CASE( "Renders a frame on a hidden window", "[Renderer]" ) {
+#ifndef _WIN32
+  // Mesa then renders with llvmpipe, which needs no GPU.
+  setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+#endif
+  if (glfwInit() == 0) {
+    WARN( "No display, renderer smoke test skipped." );
+    return;
+  }
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+  const glm::ivec2 resolution(64, 64);
+  auto *window = glfwCreateWindow(resolution.x, resolution.y, "tests", nullptr,
+                                  nullptr);
+  if (window == nullptr) {
+    glfwTerminate();
+    WARN( "No OpenGL 4.5 context, renderer smoke test skipped." );
+    return;
+  }
+  glfwMakeContextCurrent(window);
+
+  // Shaders are read relative to the source directory.
+  const auto directory = std::filesystem::current_path();
+  std::filesystem::current_path(MOS_SOURCE_DIR);
+  SECTION( "Persistently mapped streaming" ) {
+    render_frame(resolution, true);
+  }
+  SECTION( "Streaming with glBufferSubData" ) {
+    render_frame(resolution, false);
+  }
+  std::filesystem::current_path(directory);
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+}
@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+#include <vector>
+#include <mos/core/range_allocator.hpp>
+#include <mos/gl/residency.hpp>
+
+using mos::gl::Residency;
+
+TEST_CASE( "Least recently used resources are evicted", "[Residency]" ) {
+  Residency residency(300);
+  const Residency::Key texture{Residency::Kind::Texture, 1};
+  const Residency::Key mesh{Residency::Kind::Mesh, 1};
+  const Residency::Key other{Residency::Kind::Texture, 2};
+  const auto all = [](const Residency::Key &) { return true; };
+
+  residency.add(texture, 100);
+  residency.add(mesh, 100);
+  residency.add(other, 100);
+  REQUIRE( residency.evict(all).empty() );
+
+  residency.begin_frame();
+  residency.use(texture);
+  residency.add({Residency::Kind::Mesh, 2}, 150);
+  const auto evicted = residency.evict(all);
+
+  REQUIRE( evicted.size() == 2 );
+  REQUIRE( evicted[0] == mesh );
+  REQUIRE( evicted[1] == other );
+  REQUIRE( residency.evicted(mesh) );
+  REQUIRE( residency.stats().resident_bytes == 250 );
+  REQUIRE( residency.stats().evictions == 2 );
+
+  residency.begin_frame();
+  residency.add(mesh, 100);
+  REQUIRE( residency.stats().reloads == 1 );
+  REQUIRE( residency.stats().evictions == 0 );
+}
+
+TEST_CASE( "Pinned and current resources are kept", "[Residency]" ) {
+  Residency residency(0);
+  const Residency::Key pinned{Residency::Kind::Texture, 1};
+  const Residency::Key current{Residency::Kind::Texture, 2};
+  const auto all = [](const Residency::Key &) { return true; };
+
+  residency.add(pinned, 100);
+  residency.pin(pinned);
+  residency.begin_frame();
+  residency.add(current, 100);
+
+  REQUIRE( residency.evict(all).empty() );
+
+  residency.unpin(pinned);
+  REQUIRE( residency.evict(all).size() == 1 );
+  REQUIRE( residency.resident(current) );
+}
+
+TEST_CASE( "Cleared resources are not pinned when loaded again",
+           "[Residency]" ) {
+  Residency residency(0);
+  const Residency::Key target{Residency::Kind::Texture, 1};
+  const auto all = [](const Residency::Key &) { return true; };
+
+  residency.add(target, 100);
+  residency.pin(target);
+  residency.clear();
+  REQUIRE( residency.stats().resident_bytes == 0 );
+
+  residency.begin_frame();
+  residency.add(target, 100);
+  residency.begin_frame();
+  REQUIRE( residency.evict(all) == std::vector<Residency::Key>{target} );
+  REQUIRE( residency.evicted(target) );
+}
+
+TEST_CASE( "Evicted meshes release arena capacity", "[Residency]" ) {
+  // As the renderer does: meshes share one arena, evicted ones are freed,
+  // then the arena is compacted.
+  constexpr std::size_t stride = 48;
+  constexpr std::size_t budget = 100 * stride;
+  Residency residency(budget);
+  mos::Range_allocator arena(16);
+  std::vector<mos::Range_allocator::Range> meshes;
+  const auto all = [](const Residency::Key &) { return true; };
+
+  for (unsigned int id = 0; id < 20; id++) {
+    residency.begin_frame();
+    const mos::Range_allocator::Offset size = 10;
+    auto offset = arena.allocate(size);
+    if (!offset) {
+      arena.grow(arena.capacity() * 2 + size);
+      offset = arena.allocate(size);
+    }
+    meshes.push_back({*offset, size});
+    residency.add({Residency::Kind::Mesh, id}, size * stride);
+    for (const auto &key : residency.evict(all)) {
+      arena.free(meshes[key.id].offset, meshes[key.id].size);
+      meshes[key.id].size = 0;
+    }
+  }
+  REQUIRE( arena.capacity() * stride > budget );
+
+  arena.compact(meshes, 16);
+  REQUIRE( arena.stats().used * stride == residency.stats().resident_bytes );
+  REQUIRE( arena.capacity() * stride <= budget );
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+#include <mos/gfx/scene_graph.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+using mos::gfx::Scene_graph;
+
+TEST_CASE( "Scene graph propagates world transforms", "[Scene_graph]" ) {
+  Scene_graph graph;
+  const auto root = graph.add(
+      Scene_graph::none,
+      glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f)),
+      {glm::vec3(0.0f), 1.0f});
+  const auto child = graph.add(
+      root, glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)),
+      {glm::vec3(0.0f, 1.0f, 0.0f), 1.0f});
+  const auto sibling = graph.add(Scene_graph::none, glm::mat4(1.0f),
+                                 {glm::vec3(0.0f), -1.0f});
+  graph.update(mos::gfx::kernels::Execution::Sequential);
+
+  REQUIRE( graph.stats().updated == 3 );
+  REQUIRE( graph.world(child)[3].x == 1.0f );
+  REQUIRE( graph.world(child)[0].x == 2.0f );
+  REQUIRE( graph.normal(child)[0].x == Approx(0.5f) );
+  REQUIRE( graph.spheres()[child].center.y == 2.0f );
+  REQUIRE( graph.spheres()[child].radius == 2.0f );
+  REQUIRE( graph.spheres()[sibling].radius < 0.0f );
+
+  SECTION( "Unchanged nodes are not updated" ) {
+    graph.local(root, graph.world(root));
+    graph.update(mos::gfx::kernels::Execution::Sequential);
+    REQUIRE( graph.stats().updated == 0 );
+  }
+
+  SECTION( "Changes propagate to descendants only" ) {
+    graph.local(root, glm::mat4(1.0f));
+    graph.update(mos::gfx::kernels::Execution::Sequential);
+    REQUIRE( graph.stats().updated == 2 );
+    REQUIRE( graph.world(child)[3].x == 0.0f );
+    REQUIRE( graph.age(child) == 0 );
+    REQUIRE( graph.age(sibling) == 1 );
+    graph.update(mos::gfx::kernels::Execution::Sequential);
+    REQUIRE( graph.age(child) == 1 );
+  }
+}
+
+TEST_CASE( "Scene graph updates deep hierarchies in parallel", "[Scene_graph]" ) {
+  Scene_graph graph;
+  const auto step = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+  for (int chain = 0; chain < 4; chain++) {
+    auto parent = Scene_graph::none;
+    for (int depth = 0; depth < 100; depth++) {
+      parent = graph.add(parent, step, {glm::vec3(0.0f), 1.0f});
+    }
+  }
+  graph.update(mos::gfx::kernels::Execution::Parallel);
+
+  REQUIRE( graph.stats().updated == 400 );
+  REQUIRE( graph.world(99)[3].z == 100.0f );
+  REQUIRE( graph.spheres()[399].center.z == 100.0f );
+}
+
+TEST_CASE( "Scene graph parents come first", "[Scene_graph]" ) {
+  Scene_graph graph;
+  REQUIRE_THROWS( graph.add(0, glm::mat4(1.0f), {}) );
+}
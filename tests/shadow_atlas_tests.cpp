@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+#include <vector>
+#include <mos/gl/shadow_atlas.hpp>
+
+using mos::gl::Shadow_atlas;
+
+namespace {
+
+auto overlap(const Shadow_atlas::Tile &a, const Shadow_atlas::Tile &b)
+    -> bool {
+  return a.offset.x < b.offset.x + b.size && b.offset.x < a.offset.x + a.size &&
+         a.offset.y < b.offset.y + b.size && b.offset.y < a.offset.y + a.size;
+}
+
+} // namespace
+
+TEST_CASE( "Tiles are sized by importance and do not overlap",
+           "[Shadow_atlas]" ) {
+  Shadow_atlas atlas(1024, 64);
+  const std::vector<float> importance{1.0f, 0.0f, 0.25f, 0.01f, 0.3f};
+  atlas.allocate(importance);
+
+  REQUIRE( atlas.tile(0).size == 512 );
+  REQUIRE( atlas.tile(1).size == 0 );
+  REQUIRE( atlas.tile(2).size == 256 );
+  REQUIRE( atlas.tile(3).size == 64 );
+  REQUIRE( atlas.tile(4).size == 512 );
+  for (std::size_t i = 0; i < importance.size(); i++) {
+    const auto a = atlas.tile(i);
+    REQUIRE( a.offset.x + a.size <= 1024 );
+    REQUIRE( a.offset.y + a.size <= 1024 );
+    for (std::size_t j = i + 1; j < importance.size(); j++) {
+      REQUIRE_FALSE( overlap(a, atlas.tile(j)) );
+    }
+  }
+  REQUIRE( atlas.stats().tiles == 4 );
+  REQUIRE( atlas.stats().used_texels ==
+           2 * 512 * 512 + 256 * 256 + 64 * 64 );
+}
+
+TEST_CASE( "Tiles shrink until they fit", "[Shadow_atlas]" ) {
+  Shadow_atlas atlas(256, 64);
+  atlas.allocate(std::vector<float>(5, 1.0f));
+  REQUIRE( atlas.stats().tiles == 5 );
+  REQUIRE( atlas.tile(0).size == 64 );
+
+  atlas.allocate(std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                    8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f,
+                                    14.0f, 15.0f, 16.0f, 17.0f});
+  REQUIRE( atlas.stats().tiles == 16 );
+  REQUIRE( atlas.tile(0).size == 0 );
+  REQUIRE( atlas.tile(16).size == 64 );
+}
+
+TEST_CASE( "Unchanged lights are skipped", "[Shadow_atlas]" ) {
+  Shadow_atlas atlas(1024, 64);
+  const std::vector<float> importance{1.0f, 1.0f};
+  atlas.allocate(importance);
+  REQUIRE( atlas.update(0, 1) );
+  REQUIRE( atlas.update(1, 2) );
+
+  atlas.allocate(importance);
+  REQUIRE_FALSE( atlas.update(0, 1) );
+  REQUIRE( atlas.update(1, 3) );
+  REQUIRE( atlas.stats().rendered == 1 );
+  REQUIRE( atlas.stats().skipped == 1 );
+
+  // A resized tile is rendered again, whatever its state.
+  atlas.allocate(std::vector<float>{1.0f, 0.2f});
+  REQUIRE_FALSE( atlas.update(0, 1) );
+  REQUIRE( atlas.update(1, 3) );
+
+  // A light that lost its tile is rendered when it gets one back.
+  atlas.allocate(std::vector<float>{1.0f, 0.0f});
+  REQUIRE_FALSE( atlas.update(1, 3) );
+  atlas.allocate(std::vector<float>{1.0f, 0.2f});
+  REQUIRE( atlas.update(1, 3) );
+}
@@ -0,0 +1,32 @@
+#include <catch2/catch.hpp>
+#include <memory>
+#include <mos/core/slot_map.hpp>
+
+TEST_CASE( "Insert keeps the existing value", "[Slot_map]" ) {
+  mos::Slot_map<int> map;
+  map.insert(3, 1);
+  map.insert(3, 2);
+
+  REQUIRE( map.size() == 1 );
+  REQUIRE( map.at(3) == 1 );
+  REQUIRE_FALSE( map.contains(2) );
+  REQUIRE( map.find(2) == nullptr );
+  REQUIRE_THROWS( map.at(7) );
+}
+
+TEST_CASE( "Erase moves the last value", "[Slot_map]" ) {
+  mos::Slot_map<std::unique_ptr<int>> map;
+  for (unsigned int key = 0; key < 4; key++) {
+    map.insert(key, std::make_unique<int>(key));
+  }
+
+  REQUIRE( map.erase(1) );
+  REQUIRE_FALSE( map.erase(1) );
+  REQUIRE( map.size() == 3 );
+  REQUIRE( *map.at(3) == 3 );
+  REQUIRE( map.keys()[1] == 3 );
+
+  map.insert(1, std::make_unique<int>(5));
+  REQUIRE( *map.at(1) == 5 );
+  REQUIRE( *map.at(0) == 0 );
+}
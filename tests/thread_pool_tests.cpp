@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mos/core/thread_pool.hpp>
+
+TEST_CASE( "Parallel for covers the range once", "[Thread_pool]" ) {
+  mos::Thread_pool pool(4);
+  std::vector<int> counts(1000, 0);
+  pool.parallel_for(counts.size(), [&](std::size_t, const std::size_t begin,
+                                       const std::size_t end) {
+    for (auto i = begin; i < end; i++) {
+      counts[i]++;
+    }
+  });
+  REQUIRE( std::all_of(counts.begin(), counts.end(),
+                       [](const int count) { return count == 1; }) );
+}
+
+TEST_CASE( "Parallel for inside a task of the same pool runs inline",
+           "[Thread_pool]" ) {
+  // With every worker waiting on nested chunks, this would deadlock.
+  mos::Thread_pool pool(2);
+  std::atomic<std::size_t> sum{0};
+  std::atomic<bool> inline_chunks{true};
+  std::vector<std::future<void>> futures;
+  for (int task = 0; task < 4; task++) {
+    futures.push_back(pool.enqueue([&]() {
+      inline_chunks = inline_chunks && pool.worker();
+      pool.parallel_for(100, [&](const std::size_t chunk,
+                                 const std::size_t begin,
+                                 const std::size_t end) {
+        inline_chunks = inline_chunks && chunk == 0;
+        sum += end - begin;
+      });
+    }));
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
+  REQUIRE( sum == 400 );
+  REQUIRE( inline_chunks );
+  REQUIRE_FALSE( pool.worker() );
+  REQUIRE_FALSE( mos::Thread_pool::shared().worker() );
+}
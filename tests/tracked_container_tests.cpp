@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+#include <mos/core/tracked_container.hpp>
+
+TEST_CASE( "Generation changes on modification", "[Tracked_container]" ) {
+  mos::Tracked_container<int> container{1, 2, 3};
+  const auto generation = container.modified();
+
+  container.mark_clean();
+  REQUIRE( container.modified() == generation );
+  REQUIRE( container.dirty().empty() );
+
+  container[1] = 4;
+  REQUIRE( container.modified() != generation );
+  REQUIRE( container.clean_generation() == generation );
+}
+
+TEST_CASE( "Dirty range covers modified items", "[Tracked_container]" ) {
+  mos::Tracked_container<int> container{0, 0, 0, 0, 0, 0};
+  container.mark_clean();
+
+  container[4] = 1;
+  container[2] = 1;
+
+  REQUIRE( container.dirty().begin == 2 );
+  REQUIRE( container.dirty().end == 5 );
+
+  container.push_back(1);
+  REQUIRE( container.dirty().end == 7 );
+
+  container.mark_clean();
+  REQUIRE( container.dirty().empty() );
+}
+
+TEST_CASE( "Generations are unique between copies", "[Tracked_container]" ) {
+  mos::Tracked_container<int> container0{1, 2, 3};
+  container0.mark_clean();
+  auto container1 = container0;
+
+  container0[0] = 4;
+  container1[0] = 5;
+
+  REQUIRE( container0.modified() != container1.modified() );
+}
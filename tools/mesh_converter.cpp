@@ -0,0 +1,27 @@
+#include <filesystem>
+#include <iostream>
+#include <mos/gfx/mesh.hpp>
+#include <mos/gfx/mesh_file.hpp>
+
+/** Converts *.mesh files to the memory mappable *.mesh2 format. Tangents and
+ * the bounding sphere are computed once here, instead of on every load. */
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: mesh_converter <file.mesh>..." << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (int i = 1; i < argc; i++) {
+    const std::filesystem::path input = argv[i];
+    auto output = input;
+    output.replace_extension(".mesh2");
+    try {
+      const auto mesh = mos::gfx::Mesh::load(input.string());
+      mos::gfx::Mesh_file::write(output.string(), mesh);
+      std::cout << input.string() << " -> " << output.string() << std::endl;
+    } catch (const std::exception &exception) {
+      std::cerr << exception.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
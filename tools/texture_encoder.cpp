@@ -0,0 +1,58 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <mos/gfx/texture_2d.hpp>
+
+namespace {
+auto total_size(const mos::gfx::Texture_2D &texture) -> std::size_t {
+  std::size_t size = 0;
+  for (int level = 0; level < texture.levels(); level++) {
+    size += texture.size(level);
+  }
+  return size;
+}
+
+auto megabytes(const std::size_t bytes) -> std::string {
+  return std::to_string(double(bytes) / (1024.0 * 1024.0)) + " MB";
+}
+} // namespace
+
+/** Converts images to block compressed *.ktx files with all mipmap levels,
+ * on the CPU. Pass all textures of a scene to get its total savings.
+ * Color data is assumed sRGB, unless --linear precedes the files. */
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: texture_encoder [--linear] <image>..." << std::endl;
+    return EXIT_FAILURE;
+  }
+  bool color_data = true;
+  std::size_t uncompressed_total = 0;
+  std::size_t compressed_total = 0;
+  for (int i = 1; i < argc; i++) {
+    if (std::string(argv[i]) == "--linear") {
+      color_data = false;
+      continue;
+    }
+    const std::filesystem::path input = argv[i];
+    auto output = input;
+    output.replace_extension(".ktx");
+    try {
+      auto texture = mos::gfx::Texture_2D::load(input.string(), color_data);
+      texture.build_mipmaps();
+      const auto compressed = texture.compress();
+      compressed.save(output.string());
+      uncompressed_total += total_size(texture);
+      compressed_total += total_size(compressed);
+      std::cout << input.string() << " -> " << output.string() << " "
+                << megabytes(total_size(texture)) << " -> "
+                << megabytes(total_size(compressed)) << std::endl;
+    } catch (const std::exception &exception) {
+      std::cerr << exception.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::cout << "Total " << megabytes(uncompressed_total) << " -> "
+            << megabytes(compressed_total) << ", saved "
+            << megabytes(uncompressed_total - compressed_total) << std::endl;
+  return EXIT_SUCCESS;
+}